@@ -7,52 +7,177 @@
  */
 
 #include "batch_mode.h"
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STATS_ENV "GAMMA_STATS" ///< zmienna srodowiskowa wlaczajaca statystyki
+#define LOG_ENV "GAMMA_LOG" ///< zmienna srodowiskowa ze sciezka dziennika gry
+#define LOG_DIR_ENV "GAMMA_LOG_DIR" /**< zmienna srodowiskowa z katalogiem
+                                      * dziennikow gier o numerach **/
+#define LOG_SYNC_EVERY_MOVES 64 ///< po ilu ruchach utrwalany jest dziennik
+#define LOG_SYNC_EVERY_MS 100 ///< po ilu milisekundach utrwalany jest dziennik
+
+/** Ustawiana przez obsluge sygnalu SIGUSR1, gdy trzeba wypisac statystyki. */
+static volatile sig_atomic_t stats_dump_requested = 0;
+
+/** @brief Obsluguje sygnal SIGUSR1.
+ * @param[in] signal - numer sygnalu.
+ */
+static void request_stats_dump(int signal) {
+    (void) signal;
+    stats_dump_requested = 1;
+}
+
+const char* batch_mode_log_path(void) {
+    const char *path = getenv(LOG_ENV);
+    return (path == NULL || path[0] == '\0') ? NULL : path;
+}
+
+bool batch_mode_game_log_path(uint32_t id, char **path) {
+    *path = NULL;
+    const char *dir = getenv(LOG_DIR_ENV);
+    if(dir == NULL || dir[0] == '\0') return true;
+    if(asprintf(path, "%s/%u.log", dir, id) < 0) {
+        *path = NULL;
+        return false;
+    }
+    return true;
+}
+
+gamma_t* batch_mode_new_game(const char *log_path, uint32_t width,
+                             uint32_t height, uint32_t players, uint32_t areas) {
+    if(log_path == NULL) {
+        return gamma_new(width, height, players, areas);
+    }
+    return gamma_new_logged(log_path, width, height, players, areas,
+                            LOG_SYNC_EVERY_MOVES, LOG_SYNC_EVERY_MS);
+}
+
+void batch_mode_execute(gamma_t *board, uint32_t command,
+                        const uint32_t *args, uint32_t line_count,
+                        FILE *out, FILE *err, command_stats_t *stats) {
+    uint64_t start = (stats != NULL) ? command_stats_clock() : 0;
+    uint64_t result = 0;
+    bool success = true;
+    char *b = NULL;
+
+    if(command == GAMMA_MOVE)
+    {
+        result = gamma_move(board,args[0],args[1],args[2]);
+        success = result;
+    }
+    else if(command == GAMMA_GOLDEN_MOVE)
+    {
+        result = gamma_golden_move(board,args[0],args[1],args[2]);
+        success = result;
+    }
+    else if(command == GAMMA_BUSY_FIELDS)
+    {
+        result = gamma_busy_fields(board,args[0]);
+    }
+    else if(command == GAMMA_FREE_FIELDS)
+    {
+        result = gamma_free_fields(board,args[0]);
+    }
+    else if(command == GAMMA_GOLDEN_POSSIBLE)
+    {
+        result = gamma_golden_possible(board,args[0]);
+    }
+    else if(command == GAMMA_BOARD)
+    {
+        b = gamma_board(board);
+        success = (b != NULL);
+        /* Wypisanie planszy zeruje zmienione pola tylko w grach, w ktorych
+         * uzyto juz komendy d, zeby samo p nie wlaczalo ich sledzenia. */
+        if(success && gamma_diff_tracked(board)) {
+            gamma_clear_diff(board);
+        }
+    }
+    else if(command == GAMMA_BOARD_REGION)
+    {
+        b = gamma_board_region(board,args[0],args[1],args[2],args[3]);
+        success = (b != NULL);
+    }
+    else if(command == GAMMA_BOARD_DIFF)
+    {
+        b = gamma_board_diff(board);
+        success = (b != NULL);
+    }
+    else {
+        if(command != COMMENT && command != EMPTY_LINE) {
+            fprintf(err,"ERROR %u\n", line_count);
+        }
+        return;
+    }
+
+    if(stats != NULL) {
+        command_stats_record(stats,
+                             command == GAMMA_BOARD_REGION ? GAMMA_BOARD : command,
+                             success,
+                             command_stats_clock() - start);
+    }
+
+    if(command == GAMMA_BOARD || command == GAMMA_BOARD_REGION
+       || command == GAMMA_BOARD_DIFF) {
+        if(b != NULL) {
+            fputs(b, out);
+        }
+        else {
+            fprintf(err,"ERROR %u\n", line_count);
+        }
+        free(b);
+    }
+    else {
+        fprintf(out, "%lu\n", result);
+    }
+}
+
+/** @brief Wlacza statystyki komend, jesli ustawiona jest zmienna GAMMA_STATS.
+ * Wartosc "stderr" lub "-" oznacza wypisywanie na standardowe wyjscie
+ * diagnostyczne, a kazda inna niepusta wartosc jest sciezka pliku.
+ * Instaluje tez obsluge sygnalu SIGUSR1 zadajacego wypisania statystyk.
+ * @return Wskaznik na statystyki lub NULL, jesli statystyki sa wylaczone.
+ */
+static command_stats_t *batch_mode_stats(void) {
+    const char *target = getenv(STATS_ENV);
+    if(target == NULL || target[0] == '\0') return NULL;
+    if(strcmp(target, "-") == 0) target = "stderr";
+
+    command_stats_t *stats;
+    if(!command_stats_init(&stats, target)) return NULL;
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = request_stats_dump;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGUSR1, &action, NULL);
+    return stats;
+}
 
 void batch_mode_start(uint32_t *parsed_command, uint32_t line_count, gamma_t *board) {
     char *line = NULL;
     size_t sizeOfLine = 1;
+    command_stats_t *stats = batch_mode_stats();
 
     while(getline(&line, &sizeOfLine, stdin) != EOF) {
 	    line_count++;
         process_line_batch_mode(line, parsed_command);
-
-        if(parsed_command[0] == GAMMA_MOVE)
-        {
-            printf("%d\n", gamma_move(board,parsed_command[1],parsed_command[2],parsed_command[3]));
-        }
-        else if(parsed_command[0] == GAMMA_GOLDEN_MOVE)
-        {
-            printf("%d\n", gamma_golden_move(board,parsed_command[1],parsed_command[2],parsed_command[3]));
-        }
-        else if(parsed_command[0] == GAMMA_BUSY_FIELDS)
-        {
-            printf("%lu\n", gamma_busy_fields(board,parsed_command[1]));
+        batch_mode_execute(board, parsed_command[0], parsed_command + 1, line_count,
+                           stdout, stderr, stats);
+        if(stats_dump_requested) {
+            stats_dump_requested = 0;
+            fflush(stdout);
+            command_stats_dump(stats);
         }
-        else if(parsed_command[0] == GAMMA_FREE_FIELDS)
-        {
-            printf("%lu\n", gamma_free_fields(board,parsed_command[1]));
-        }
-        else if(parsed_command[0] == GAMMA_GOLDEN_POSSIBLE)
-        {
-            printf("%d\n", gamma_golden_possible(board,parsed_command[1]));
-        }
-        else if(parsed_command[0] == GAMMA_BOARD)
-        {
-            char *b = gamma_board(board);
-            if(b != NULL) {
-                printf("%s",b);
-            }
-            else if(b == NULL) {
-                fprintf(stderr,"ERROR %u\n", line_count);
-            }
-            free(b);
-        }
-        else if(parsed_command[0] != COMMENT && parsed_command[0] != EMPTY_LINE) {
-            fprintf(stderr,"ERROR %u\n", line_count);
-        }
-        
     }
-    
+
+    if(stats != NULL) {
+        fflush(stdout);
+        command_stats_dump(stats);
+        delete_command_stats(stats);
+    }
     free(line);
     gamma_delete(board);
 }
@@ -13,9 +13,61 @@
 #include <stdio.h>
 #include "parser.h"
 #include "gamma.h"
+#include "command_stats.h"
+
+/** @brief Podaje sciezke dziennika ruchow gry trybu wsadowego.
+ * @return Wartosc zmiennej srodowiskowej GAMMA_LOG lub NULL, jesli nie
+ * jest ustawiona.
+ */
+const char* batch_mode_log_path(void);
+
+/** @brief Podaje sciezke dziennika ruchow gry o danym numerze.
+ * Dziennik gry o numerze @p id to plik id.log w katalogu podanym
+ * w zmiennej srodowiskowej GAMMA_LOG_DIR.
+ * @param[in] id - numer gry,
+ * @param[out] path - wskaznik, pod ktory zapisywana jest zaalokowana
+ * sciezka lub NULL, jesli zmienna nie jest ustawiona.
+ * @return Wartosc @p false, jesli nie udalo sie zaalokowac pamieci,
+ * @p true w przeciwnym przypadku.
+ */
+bool batch_mode_game_log_path(uint32_t id, char **path);
+
+/** @brief Tworzy gre, ktorej ruchy sa zapisywane w dzienniku.
+ * Jesli @p log_path nie jest NULL, gra jest tworzona funkcja
+ * @ref gamma_new_logged, wiec wznawia sie z istniejacego dziennika,
+ * a kazdy jej ruch jest w nim zapisywany przed wykonaniem.
+ * @param[in] log_path - sciezka dziennika lub NULL,
+ * @param[in] width - szerokosc planszy,
+ * @param[in] height - wysokosc planszy,
+ * @param[in] players - liczba graczy,
+ * @param[in] areas - maksymalna liczba obszarow jednego gracza.
+ * @return Wskaznik na gre lub NULL, jesli nie udalo sie jej utworzyc.
+ */
+gamma_t* batch_mode_new_game(const char *log_path, uint32_t width,
+                             uint32_t height, uint32_t players, uint32_t areas);
+
+/** @brief Wykonuje jedna komende trybu wsadowego.
+ * Wypisuje wynik komendy do strumienia @p out, a w razie bledu
+ * komunikat ERROR do strumienia @p err.
+ * @param[in,out] board - wskaznik na gre, na ktorej wykonywana jest komenda,
+ * @param[in] command - rodzaj komendy, jedna z wartosci z pliku
+ * batch_mode_and_parser_constants.h,
+ * @param[in] args - argumenty komendy,
+ * @param[in] line_count - numer linii, z ktorej pochodzi komenda,
+ * @param[in,out] out - strumien, do ktorego wypisywany jest wynik,
+ * @param[in,out] err - strumien, do ktorego wypisywane sa bledy,
+ * @param[in,out] stats - statystyki, w ktorych zapisywany jest czas
+ * wykonania komendy, lub NULL.
+ */
+void batch_mode_execute(gamma_t *board, uint32_t command,
+                        const uint32_t *args, uint32_t line_count,
+                        FILE *out, FILE *err, command_stats_t *stats);
 
 /** @brief Uruchamia tryb wsadowy.
- * Uruchamia tryb wsadowy.
+ * Uruchamia tryb wsadowy. Jesli ustawiona jest zmienna srodowiskowa
+ * GAMMA_STATS, zbiera statystyki komend i wypisuje je (na stderr dla
+ * wartosci "stderr" lub "-", w przeciwnym razie dopisuje do pliku o tej
+ * sciezce) przy zakonczeniu oraz po otrzymaniu sygnalu SIGUSR1.
  * @param[in,out] parsed_command - tablica uzywana do zczytywania linii,
  * @param[in] line_count - wartosc mowiaca ile linii tekstu zostalo zczytane,
  * @param[in,out] board   – wskaznik na gre, dla ktorej uruchamiany jest tryb.
@@ -12,6 +12,9 @@
 
 #define MAX_NUMBER_OF_COMMANDS 5 /**< makro mowiace ile maksymalnie slow
                                    * moze miec poprawna komenda **/
+#define MAX_NUMBER_OF_SESSION_COMMANDS 6 /**< makro mowiace ile maksymalnie
+                                          * slow moze miec poprawna komenda
+                                          * w trybie wielu gier **/
 #define COMMENT 0 ///< makro mowiace o tym ze podana linijka byla komentarzem
 #define BATCH_MODE 1 ///< makro odpowiadajace za uruchomienie trybu wsadowego
 #define INTERACTIVE_MODE 2 /**< makro odpowiadajace za
@@ -30,5 +33,15 @@
                                     * funkcji gamma_golden_possible **/
 #define GAMMA_BOARD 11 /**< makro odpowiedzialne za wywalnie
                         * funkcji gamma_board **/
+#define SESSION_MODE 12 /**< makro odpowiadajace za
+                         * uruchomienie trybu wielu gier **/
+#define GAMMA_NEW 13 /**< makro odpowiedzialne za wywolanie
+                      * funkcji gamma_new w trybie wielu gier **/
+#define GAMMA_DELETE 14 /**< makro odpowiedzialne za wywolanie
+                         * funkcji gamma_delete w trybie wielu gier **/
+#define GAMMA_BOARD_DIFF 15 /**< makro odpowiedzialne za wywolanie
+                             * funkcji gamma_board_diff **/
+#define GAMMA_BOARD_REGION 16 /**< makro odpowiedzialne za wywolanie
+                               * funkcji gamma_board_region **/
 
 #endif //BATCH_MODE_AND_PARSER_CONSTANTS_H
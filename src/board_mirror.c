@@ -0,0 +1,143 @@
+/** @file
+ * Implementacja interfejsu board_mirror.h
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "board_mirror.h"
+
+/** @struct board_mirror
+ * @brief Struktura przechowujaca zmapowany segment planszy.
+ */
+struct board_mirror {
+    void *map; ///< poczatek mapowania
+    size_t size; ///< rozmiar mapowania
+    board_mirror_header_t *header; ///< naglowek segmentu
+    const uint32_t *cells; ///< pola planszy
+};
+
+bool board_mirror_open(board_mirror_t **m, const char *name) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if(fd < 0) return false;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || (uint64_t) st.st_size < sizeof(board_mirror_header_t)) {
+        close(fd);
+        return false;
+    }
+    void *map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED) return false;
+
+    board_mirror_header_t *header = map;
+    uint64_t cells = (uint64_t) header->width * header->height;
+    if(memcmp(header->magic, BOARD_MIRROR_MAGIC, sizeof(header->magic)) != 0
+       || header->version != BOARD_MIRROR_VERSION
+       || header->cells_offset < sizeof(board_mirror_header_t)
+       || header->cells_offset % sizeof(uint32_t) != 0
+       || header->cells_offset + cells * sizeof(uint32_t) > (uint64_t) st.st_size) {
+        munmap(map, (size_t) st.st_size);
+        return false;
+    }
+
+    *m = malloc(sizeof(board_mirror_t));
+    if(*m == NULL) {
+        munmap(map, (size_t) st.st_size);
+        return false;
+    }
+    (*m)->map = map;
+    (*m)->size = (size_t) st.st_size;
+    (*m)->header = header;
+    (*m)->cells = (const uint32_t *) ((const char *) map + header->cells_offset);
+    return true;
+}
+
+void delete_board_mirror(board_mirror_t *m) {
+    if(m != NULL) {
+        munmap(m->map, m->size);
+        free(m);
+    }
+}
+
+const board_mirror_header_t *board_mirror_header(board_mirror_t *m) {
+    return m->header;
+}
+
+uint64_t board_mirror_snapshot(board_mirror_t *m, uint32_t *cells) {
+    uint64_t count = (uint64_t) m->header->width * m->header->height;
+    uint64_t seq;
+    while(true) {
+        seq = __atomic_load_n(&m->header->seq, __ATOMIC_ACQUIRE);
+        if(seq & 1) {
+            sched_yield();
+            continue;
+        }
+        for(uint64_t i = 0; i < count; ++i) {
+            cells[i] = __atomic_load_n(&m->cells[i], __ATOMIC_RELAXED);
+        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if(__atomic_load_n(&m->header->seq, __ATOMIC_RELAXED) == seq) break;
+    }
+    return seq;
+}
+
+/** @brief Podaje ilosc cyfr liczby.
+ * @param[in] number - liczba.
+ * @return ilosc cyfr, co najmniej 1.
+ */
+static uint64_t digits(uint32_t number) {
+    uint64_t counter = 1;
+    while(number >= 10) {
+        ++counter;
+        number /= 10;
+    }
+    return counter;
+}
+
+char *board_mirror_render(board_mirror_t *m, uint64_t *seq) {
+    uint64_t width = m->header->width;
+    uint64_t height = m->header->height;
+    uint32_t *cells = malloc(sizeof(uint32_t) * width * height);
+    if(cells == NULL) return NULL;
+    uint64_t snapshot_seq = board_mirror_snapshot(m, cells);
+
+    uint32_t max_player = 0;
+    for(uint64_t i = 0; i < width * height; ++i) {
+        if(cells[i] > max_player) max_player = cells[i];
+    }
+    uint64_t max_len = digits(max_player);
+    uint64_t line = width * max_len + 1;
+    char *buffor = malloc(height * line + 1);
+    if(buffor == NULL) {
+        free(cells);
+        return NULL;
+    }
+    memset(buffor, ' ', height * line);
+    for(uint64_t row = 0; row < height; ++row) {
+        uint64_t y = height - 1 - row;
+        for(uint64_t x = 0; x < width; ++x) {
+            char *end = buffor + row * line + (x + 1) * max_len - 1;
+            uint32_t cell = cells[x * height + y];
+            if(cell == 0) {
+                *end = '.';
+            }
+            while(cell > 0) {
+                *end-- = (char) (cell % 10 + '0');
+                cell /= 10;
+            }
+        }
+        buffor[row * line + line - 1] = '\n';
+    }
+    buffor[height * line] = '\0';
+    free(cells);
+    if(seq != NULL) *seq = snapshot_seq;
+    return buffor;
+}
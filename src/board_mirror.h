@@ -0,0 +1,82 @@
+/** @file
+ * Interfejs lustra planszy w pamieci wspoldzielonej
+ *
+ * Gra utworzona funkcja @ref gamma_new_shared trzyma pola planszy w segmencie
+ * pamieci wspoldzielonej POSIX. Segment zaczyna sie naglowkiem
+ * @ref board_mirror_header, za ktorym od pozycji @p cells_offset leza pola
+ * planszy jako liczby uint32_t, kolumnami: pole (x, y) ma indeks
+ * x * height + y. Pisarz utrzymuje w naglowku licznik sekwencyjny,
+ * nieparzysty w trakcie ruchu, wiec inne procesy moga mapowac segment
+ * tylko do odczytu i kopiowac plansze bez zadnej komunikacji z gra.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#ifndef BOARD_MIRROR_H
+#define BOARD_MIRROR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define BOARD_MIRROR_MAGIC "GAMMASHM" ///< znacznik poczatku segmentu
+#define BOARD_MIRROR_VERSION 1 ///< wersja formatu segmentu
+
+/** @struct board_mirror_header
+ * @brief Naglowek segmentu pamieci wspoldzielonej z plansza.
+ */
+typedef struct board_mirror_header {
+    char magic[8]; ///< @ref BOARD_MIRROR_MAGIC bez konczacego zera
+    uint32_t version; ///< @ref BOARD_MIRROR_VERSION
+    uint32_t width; ///< szerokosc planszy
+    uint32_t height; ///< wysokosc planszy
+    uint32_t players; ///< liczba graczy
+    uint64_t seq; ///< licznik sekwencyjny, nieparzysty w trakcie ruchu
+    uint64_t cells_offset; ///< pozycja pierwszego pola od poczatku segmentu
+} board_mirror_header_t;
+
+/**
+ * Struktura przechowujaca zmapowany segment planszy innego procesu.
+ */
+typedef struct board_mirror board_mirror_t;
+
+/** @brief Mapuje segment planszy tylko do odczytu.
+ * @param[out] m - wskaznik, pod ktory zostanie zapisane lustro,
+ * @param[in] name - nazwa segmentu pamieci wspoldzielonej.
+ * @return Wartosc @p true, jesli segment istnieje i ma poprawny naglowek,
+ * @p false w przeciwnym przypadku.
+ */
+bool board_mirror_open(board_mirror_t **m, const char *name);
+
+/** @brief Odmapowuje segment planszy.
+ * Nic nie robi, jesli wskaznik ma wartosc NULL.
+ * @param[in] m - wskaznik na lustro.
+ */
+void delete_board_mirror(board_mirror_t *m);
+
+/** @brief Podaje naglowek segmentu.
+ * @param[in] m - wskaznik na lustro.
+ * @return Wskaznik na naglowek; pole @p seq zmienia sie w trakcie gry.
+ */
+const board_mirror_header_t *board_mirror_header(board_mirror_t *m);
+
+/** @brief Kopiuje spojny stan planszy.
+ * Powtarza kopiowanie, dopoki w jego trakcie nie zostanie wykonany zaden ruch.
+ * @param[in] m - wskaznik na lustro,
+ * @param[out] cells - tablica na width * height pol, w kolejnosci segmentu,
+ * @return numer sekwencyjny skopiowanego stanu.
+ */
+uint64_t board_mirror_snapshot(board_mirror_t *m, uint32_t *cells);
+
+/** @brief Daje napis opisujacy stan planszy.
+ * Napis ma ten sam format co wynik funkcji @ref gamma_board.
+ * @param[in] m - wskaznik na lustro,
+ * @param[out] seq - numer sekwencyjny opisanego stanu lub NULL.
+ * @return Wskaznik na zaalokowany napis lub NULL, jesli nie udalo sie
+ * zaalokowac pamieci. Wywolujacy musi zwolnic napis.
+ */
+char *board_mirror_render(board_mirror_t *m, uint64_t *seq);
+
+#endif //BOARD_MIRROR_H
@@ -0,0 +1,386 @@
+/** @file
+ * Implementacja interfejsu bot.h
+ *
+ * Oceniane ruchy sa przechowywane jako kandydaci z suma wynikow i liczba
+ * symulacji. Watek oceniajacy w kazdej symulacji kopiuje gre, wybiera
+ * kandydata o najwiekszej sumie sredniego wyniku i premii za mala liczbe
+ * symulacji lub losuje nowego kandydata, a po symulacji dopisuje jej wynik.
+ * Po kazdej zmianie planszy wyniki kandydatow traca polowe wagi, bo
+ * opisuja juz nieaktualny stan gry.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include "bot.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BOT_MAX_CANDIDATES 64 ///< ilosc jednoczesnie ocenianych ruchow
+#define BOT_NEW_CANDIDATE_ONE_IN 4 /**< co ktora symulacja, srednio,
+                                     * losuje nowego kandydata **/
+#define BOT_MOVE_TRIES 16 ///< ilosc prob wylosowania legalnego ruchu
+#define BOT_PLAY_TRIES 256 /**< ilosc prob wylosowania legalnego ruchu,
+                             * gdy zaden kandydat nie jest legalny **/
+#define BOT_GOLDEN_ONE_IN 8 /**< co ktora proba ruchu na pole innego gracza
+                              * jest zlotym ruchem **/
+#define BOT_PLAYOUT_ROUNDS 4 ///< ilosc kolejek losowych ruchow w symulacji
+#define BOT_EXPLORATION 1.0 /**< premia dla kandydata bez symulacji,
+                              * malejaca z liczba symulacji **/
+#define BOT_IDLE_US 10000 /**< czas uspienia watku, gdy gracz nie ma
+                            * zadnego ruchu **/
+
+/** @struct candidate
+ * @brief Oceniany ruch.
+ */
+typedef struct candidate {
+    uint32_t x; ///< numer kolumny
+    uint32_t y; ///< numer wiersza
+    bool golden; ///< czy ruch jest zlotym ruchem
+    uint64_t visits; ///< liczba symulacji po tym ruchu
+    double total; ///< suma wynikow symulacji
+} candidate_t;
+
+/** @struct bot
+ * @brief Struktura przechowujaca stan gracza komputerowego.
+ */
+struct bot {
+    gamma_t *game; ///< gra, w ktorej gra gracz
+    uint32_t player; ///< numer gracza
+    uint32_t players; ///< ilosc graczy w grze
+    uint32_t subscription; ///< numer subskrypcji zmian gry
+    gamma_t *root; /**< kopia gry uaktualniana po kazdej zmianie,
+                    * chroniona przez @p lock **/
+    gamma_t *work; ///< kopia gry do symulacji, uzywana tylko przez watek
+    opening_book_t *book; ///< ksiazka otwarc lub NULL
+    candidate_t candidates[BOT_MAX_CANDIDATES]; /**< oceniane ruchy,
+                                                 * chronione przez @p lock **/
+    uint32_t candidate_count; ///< ilosc ocenianych ruchow
+    uint64_t rng; ///< stan generatora liczb losowych watku
+    uint64_t play_rng; ///< stan generatora liczb losowych @ref bot_play
+    bool stop; ///< czy watek ma sie zakonczyc
+    bool thread_started; ///< czy watek zostal uruchomiony
+    pthread_mutex_t lock; ///< blokada kopii gry i kandydatow
+    pthread_t thread; ///< watek oceniajacy ruchy
+};
+
+/** @brief Losuje liczbe.
+ * @param[in,out] state - stan generatora xorshift, niezerowy.
+ * @return losowa liczba 64-bitowa.
+ */
+static uint64_t next_random(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+/** @brief Probuje wykonac losowy ruch.
+ * Losuje pole; jesli nalezy ono do gracza, przechodzi na losowe sasiednie
+ * pole, co pozwala znalezc ruch rowniez graczowi, ktory ma juz maksymalna
+ * liczbe obszarow.
+ * @param[in,out] g - gra, w ktorej wykonywany jest ruch,
+ * @param[in] player - numer gracza,
+ * @param[in,out] rng - stan generatora liczb losowych,
+ * @param[in] tries - ilosc prob,
+ * @param[out] x - numer kolumny wykonanego ruchu,
+ * @param[out] y - numer wiersza wykonanego ruchu,
+ * @param[out] golden - czy wykonany ruch byl zlotym ruchem.
+ * @return Wartosc @p true, jesli wykonano ruch, @p false w przeciwnym
+ * przypadku.
+ */
+static bool random_move(gamma_t *g, uint32_t player, uint64_t *rng,
+                        uint32_t tries, uint32_t *x, uint32_t *y, bool *golden) {
+    uint32_t width = get_width(g);
+    uint32_t height = get_height(g);
+    bool golden_possible = gamma_golden_possible(g, player);
+    for(uint32_t i = 0; i < tries; ++i) {
+        uint64_t r = next_random(rng);
+        *x = (uint32_t) (r % width);
+        *y = (uint32_t) ((r / width) % height);
+        uint32_t owner = gamma_field_owner(g, *x, *y);
+        if(owner == player) {
+            uint64_t direction = next_random(rng) % 4;
+            if(direction == 0 && *x > 0) (*x)--;
+            else if(direction == 1 && *x < width - 1) (*x)++;
+            else if(direction == 2 && *y > 0) (*y)--;
+            else if(direction == 3 && *y < height - 1) (*y)++;
+            owner = gamma_field_owner(g, *x, *y);
+        }
+        *golden = false;
+        if(owner == 0) {
+            if(gamma_move(g, player, *x, *y)) return true;
+        }
+        else if(owner != player && golden_possible
+                && next_random(rng) % BOT_GOLDEN_ONE_IN == 0) {
+            *golden = true;
+            if(gamma_golden_move(g, player, *x, *y)) return true;
+        }
+    }
+    return false;
+}
+
+/** @brief Wykonuje ruch kandydata.
+ * @param[in,out] g - gra, w ktorej wykonywany jest ruch,
+ * @param[in] player - numer gracza,
+ * @param[in] c - wykonywany ruch.
+ * @return Wartosc @p true, jesli ruch byl legalny.
+ */
+static bool apply_candidate(gamma_t *g, uint32_t player, const candidate_t *c) {
+    if(c->golden) return gamma_golden_move(g, player, c->x, c->y);
+    return gamma_move(g, player, c->x, c->y);
+}
+
+/** @brief Podaje sredni wynik kandydata.
+ * @param[in] c - kandydat.
+ * @return sredni wynik lub -1e300 dla kandydata bez symulacji.
+ */
+static double candidate_mean(const candidate_t *c) {
+    return (c->visits == 0) ? -1e300 : c->total / (double) c->visits;
+}
+
+/** @brief Wybiera kandydata i wykonuje jego ruch na kopii @p work.
+ * Wolana z zalozona blokada. Kandydaci, ktorych ruch nie jest juz legalny,
+ * sa usuwani.
+ * @param[in,out] b - wskaznik na gracza.
+ * @return pozycja wybranego kandydata lub -1, jesli gracz nie ma ruchu.
+ */
+static int64_t pick_candidate(bot_t *b) {
+    if(b->candidate_count == 0
+       || (b->candidate_count < BOT_MAX_CANDIDATES
+           && next_random(&b->rng) % BOT_NEW_CANDIDATE_ONE_IN == 0)) {
+        candidate_t c = { 0, 0, false, 0, 0.0 };
+        if(random_move(b->work, b->player, &b->rng, BOT_MOVE_TRIES,
+                       &c.x, &c.y, &c.golden)) {
+            for(uint32_t i = 0; i < b->candidate_count; ++i) {
+                candidate_t *e = &b->candidates[i];
+                if(e->x == c.x && e->y == c.y && e->golden == c.golden) return i;
+            }
+            b->candidates[b->candidate_count] = c;
+            return b->candidate_count++;
+        }
+    }
+
+    while(b->candidate_count > 0) {
+        uint32_t best = 0;
+        double best_value = 0.0;
+        for(uint32_t i = 0; i < b->candidate_count; ++i) {
+            candidate_t *c = &b->candidates[i];
+            double value = (c->visits == 0) ? 1e300 :
+                           candidate_mean(c) + BOT_EXPLORATION / (double) (c->visits + 1);
+            if(i == 0 || value > best_value) {
+                best = i;
+                best_value = value;
+            }
+        }
+        if(apply_candidate(b->work, b->player, &b->candidates[best])) return best;
+        b->candidates[best] = b->candidates[--b->candidate_count];
+    }
+    return -1;
+}
+
+/** @brief Wykonuje losowe ruchy wszystkich graczy i ocenia wynik.
+ * @param[in,out] b - wskaznik na gracza.
+ * @return liczba pol gracza pomniejszona o srednia liczbe pol pozostalych
+ * graczy.
+ */
+static double playout(bot_t *b) {
+    uint32_t x, y;
+    bool golden;
+    for(uint32_t round = 0; round < BOT_PLAYOUT_ROUNDS; ++round) {
+        bool moved = false;
+        for(uint32_t i = 1; i <= b->players; ++i) {
+            uint32_t player = (b->player - 1 + i) % b->players + 1;
+            moved |= random_move(b->work, player, &b->rng, BOT_MOVE_TRIES,
+                                 &x, &y, &golden);
+        }
+        if(!moved) break;
+    }
+    double own = (double) gamma_busy_fields(b->work, b->player);
+    double others = 0.0;
+    for(uint32_t player = 1; player <= b->players; ++player) {
+        if(player != b->player) others += (double) gamma_busy_fields(b->work, player);
+    }
+    return own - (b->players > 1 ? others / (double) (b->players - 1) : 0.0);
+}
+
+/** @brief Petla watku oceniajacego ruchy.
+ * @param[in,out] arg - wskaznik na gracza.
+ * @return NULL.
+ */
+static void *ponder(void *arg) {
+    bot_t *b = arg;
+    while(!__atomic_load_n(&b->stop, __ATOMIC_ACQUIRE)) {
+        pthread_mutex_lock(&b->lock);
+        int64_t index = -1;
+        candidate_t c;
+        if(gamma_copy(b->work, b->root)) {
+            index = pick_candidate(b);
+            if(index >= 0) c = b->candidates[index];
+        }
+        pthread_mutex_unlock(&b->lock);
+        if(index < 0) {
+            usleep(BOT_IDLE_US);
+            continue;
+        }
+
+        double score = playout(b);
+
+        pthread_mutex_lock(&b->lock);
+        for(uint32_t i = 0; i < b->candidate_count; ++i) {
+            candidate_t *e = &b->candidates[i];
+            if(e->x == c.x && e->y == c.y && e->golden == c.golden) {
+                e->visits++;
+                e->total += score;
+                break;
+            }
+        }
+        pthread_mutex_unlock(&b->lock);
+    }
+    return NULL;
+}
+
+/** @brief Uaktualnia kopie gry po zmianie planszy.
+ * Wolana w watku wykonujacym ruch, z wylacznym dostepem do gry.
+ * @param[in,out] ctx - wskaznik na gracza,
+ * @param[in] change - opis zmiany.
+ */
+static void on_change(void *ctx, const gamma_change_t *change) {
+    bot_t *b = ctx;
+    pthread_mutex_lock(&b->lock);
+    bool applied = (change->kind == MOVE_LOG_GOLDEN_MOVE)
+                   ? gamma_golden_move(b->root, change->new_owner, change->x, change->y)
+                   : gamma_move(b->root, change->new_owner, change->x, change->y);
+    if(!applied) {
+        gamma_copy(b->root, b->game);
+    }
+    for(uint32_t i = 0; i < b->candidate_count; ++i) {
+        candidate_t *c = &b->candidates[i];
+        if(c->visits > 1) {
+            c->total = c->total / (double) c->visits * (double) (c->visits / 2);
+            c->visits /= 2;
+        }
+    }
+    pthread_mutex_unlock(&b->lock);
+}
+
+bool bot_init(bot_t **b, gamma_t *g, uint32_t player) {
+    *b = calloc(1, sizeof(bot_t));
+    if(*b == NULL) return false;
+    bot_t *bot = *b;
+    bot->game = g;
+    bot->player = player;
+    bot->players = get_players(g);
+    uint64_t seed = (uint64_t) time(NULL) ^ ((uint64_t) player * 0x9E3779B97F4A7C15u);
+    bot->rng = seed | 1;
+    bot->play_rng = (seed * 0xBF58476D1CE4E5B9u) | 1;
+    bot->root = gamma_clone(g);
+    bot->work = gamma_clone(g);
+    if(bot->root == NULL || bot->work == NULL
+       || pthread_mutex_init(&bot->lock, NULL) != 0) {
+        gamma_delete(bot->root);
+        gamma_delete(bot->work);
+        free(bot);
+        *b = NULL;
+        return false;
+    }
+    bot->subscription = gamma_subscribe(g, on_change, bot);
+    bot->thread_started = (bot->subscription != 0)
+                          && pthread_create(&bot->thread, NULL, ponder, bot) == 0;
+    if(!bot->thread_started) {
+        delete_bot(bot);
+        *b = NULL;
+        return false;
+    }
+    return true;
+}
+
+void delete_bot(bot_t *b) {
+    if(b != NULL) {
+        if(b->thread_started) {
+            __atomic_store_n(&b->stop, true, __ATOMIC_RELEASE);
+            pthread_join(b->thread, NULL);
+        }
+        gamma_unsubscribe(b->game, b->subscription);
+        pthread_mutex_destroy(&b->lock);
+        gamma_delete(b->root);
+        gamma_delete(b->work);
+        free(b);
+    }
+}
+
+/** @brief Porownuje kandydatow malejaco wedlug sredniego wyniku.
+ * @param[in] a - wskaznik na pierwszego kandydata,
+ * @param[in] b - wskaznik na drugiego kandydata.
+ * @return liczba ujemna, jesli @p a ma wiekszy sredni wynik niz @p b,
+ * dodatnia jesli mniejszy, zero jesli rowny.
+ */
+static int compare_candidates(const void *a, const void *b) {
+    double mean_a = candidate_mean(a);
+    double mean_b = candidate_mean(b);
+    return (mean_a < mean_b) - (mean_a > mean_b);
+}
+
+void bot_set_book(bot_t *b, opening_book_t *book) {
+    b->book = book;
+}
+
+bool bot_book_move(bot_t *b, uint32_t *x, uint32_t *y, bool *golden) {
+    if(!opening_book_move(b->book, b->game, b->player, x, y, golden)) return false;
+    uint32_t owner = gamma_field_owner(b->game, *x, *y);
+    if(*golden) {
+        return owner != 0 && owner != b->player && gamma_golden_possible(b->game, b->player);
+    }
+    return owner == 0 && gamma_free_fields(b->game, b->player) > 0;
+}
+
+bool bot_play(bot_t *b) {
+    candidate_t candidates[BOT_MAX_CANDIDATES];
+    candidate_t book_move = { 0, 0, false, 0, 0.0 };
+    if(bot_book_move(b, &book_move.x, &book_move.y, &book_move.golden)
+       && apply_candidate(b->game, b->player, &book_move)) {
+        return true;
+    }
+    pthread_mutex_lock(&b->lock);
+    uint32_t count = b->candidate_count;
+    for(uint32_t i = 0; i < count; ++i) {
+        candidates[i] = b->candidates[i];
+    }
+    pthread_mutex_unlock(&b->lock);
+
+    /* Ruch wywoluje on_change, ktora zaklada blokade, wiec ruchy sa
+     * wykonywane bez niej. */
+    qsort(candidates, count, sizeof(candidate_t), compare_candidates);
+    for(uint32_t i = 0; i < count; ++i) {
+        if(apply_candidate(b->game, b->player, &candidates[i])) return true;
+    }
+
+    uint32_t x, y;
+    bool golden;
+    if(random_move(b->game, b->player, &b->play_rng, BOT_PLAY_TRIES, &x, &y, &golden)) {
+        return true;
+    }
+    for(x = 0; x < get_width(b->game); ++x) {
+        for(y = 0; y < get_height(b->game); ++y) {
+            if(gamma_field_owner(b->game, x, y) == 0 && gamma_move(b->game, b->player, x, y)) {
+                return true;
+            }
+        }
+    }
+    if(!gamma_golden_possible(b->game, b->player)) return false;
+    for(x = 0; x < get_width(b->game); ++x) {
+        for(y = 0; y < get_height(b->game); ++y) {
+            uint32_t owner = gamma_field_owner(b->game, x, y);
+            if(owner != 0 && owner != b->player && gamma_golden_move(b->game, b->player, x, y)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
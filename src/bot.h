@@ -0,0 +1,77 @@
+/** @file
+ * Interfejs komputerowego gracza gry gamma
+ *
+ * Gracz komputerowy ocenia ruchy metoda Monte Carlo: wykonuje ruch na
+ * kopii gry, a potem losowe ruchy wszystkich graczy, i zapamietuje sredni
+ * wynik kazdego ocenianego ruchu. Ocenianie odbywa sie w osobnym watku
+ * przez caly czas zycia gracza, rowniez w trakcie ruchow innych graczy,
+ * na wlasnej kopii gry uaktualnianej przez subskrypcje zmian planszy.
+ * Jesli graczowi podano ksiazke otwarc, ruch z ksiazki ma pierwszenstwo
+ * przed ocenionymi ruchami.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#ifndef BOT_H
+#define BOT_H
+#include <stdbool.h>
+#include <stdint.h>
+#include "gamma.h"
+#include "opening_book.h"
+
+/**
+ * Struktura przechowujaca stan gracza komputerowego.
+ */
+typedef struct bot bot_t;
+
+/** @brief Tworzy gracza komputerowego.
+ * Kopiuje gre @p g, subskrybuje jej zmiany i uruchamia watek oceniajacy
+ * ruchy. Gra @p g musi istniec dluzej niz gracz.
+ * @param[out] b - wskaznik, pod ktorym zapisywany jest utworzony gracz,
+ * @param[in,out] g - wskaznik na gre,
+ * @param[in] player - numer gracza, ktorym gra komputer.
+ * @return Wartosc @p true, jesli udalo sie utworzyc gracza,
+ * @p false w przeciwnym przypadku.
+ */
+bool bot_init(bot_t **b, gamma_t *g, uint32_t player);
+
+/** @brief Usuwa gracza komputerowego.
+ * Zatrzymuje watek oceniajacy ruchy i konczy subskrypcje zmian gry.
+ * Nic nie robi, jesli @p b ma wartosc NULL.
+ * @param[in] b - wskaznik na usuwanego gracza.
+ */
+void delete_bot(bot_t *b);
+
+/** @brief Podaje graczowi ksiazke otwarc.
+ * Ksiazka musi istniec dluzej niz gracz.
+ * @param[in,out] b - wskaznik na gracza,
+ * @param[in] book - wskaznik na ksiazke lub NULL.
+ */
+void bot_set_book(bot_t *b, opening_book_t *book);
+
+/** @brief Podaje ruch z ksiazki otwarc dla aktualnej pozycji gry.
+ * Wywolujacy musi miec wylaczny dostep do gry.
+ * @param[in] b - wskaznik na gracza,
+ * @param[out] x - numer kolumny ruchu,
+ * @param[out] y - numer wiersza ruchu,
+ * @param[out] golden - czy ruch jest zlotym ruchem.
+ * @return Wartosc @p true, jesli ksiazka zawiera pozycje, a ruch jest
+ * legalny, @p false w przeciwnym przypadku lub jesli gracz nie ma ksiazki.
+ */
+bool bot_book_move(bot_t *b, uint32_t *x, uint32_t *y, bool *golden);
+
+/** @brief Wykonuje ruch gracza komputerowego.
+ * Wykonuje na grze podanej w @ref bot_init ruch z ksiazki otwarc, a jesli
+ * go nie ma, najlepiej oceniony dotychczas ruch, ktory jest legalny.
+ * Jesli zaden oceniony ruch nie jest legalny, wykonuje dowolny legalny
+ * zwykly ruch, a gdy go nie ma, dowolny legalny zloty ruch. Wywolujacy
+ * musi miec wylaczny dostep do gry.
+ * @param[in,out] b - wskaznik na gracza.
+ * @return Wartosc @p true, jesli wykonano ruch, @p false jesli gracz nie
+ * znalazl legalnego ruchu.
+ */
+bool bot_play(bot_t *b);
+
+#endif //BOT_H
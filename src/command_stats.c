@@ -0,0 +1,180 @@
+/** @file
+ * Implementacja interfejsu command_stats.h
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "command_stats.h"
+#include "batch_mode_and_parser_constants.h"
+#include "event_counters.h"
+
+#define SUB_BUCKET_BITS 4 ///< liczba bitow podzialu przedzialu histogramu
+#define SUB_BUCKETS (1u << SUB_BUCKET_BITS) ///< liczba czesci przedzialu
+#define HISTOGRAM_BUCKETS ((64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS) /**< liczba
+                                                 * kubelkow histogramu **/
+#define NUMBER_OF_STAT_COMMANDS (GAMMA_BOARD - GAMMA_MOVE + 2) /**< liczba
+                                                 * rodzajow komend **/
+
+/** @struct command_stat
+ * @brief Statystyki jednego rodzaju komendy.
+ */
+typedef struct command_stat {
+    uint64_t calls; ///< liczba wywolan
+    uint64_t successes; ///< liczba wywolan z niezerowym wynikiem
+    uint64_t total_ticks; ///< laczny czas wywolan
+    uint64_t max_ticks; ///< najdluzszy czas wywolania
+    uint64_t histogram[HISTOGRAM_BUCKETS]; ///< histogram czasow wywolan
+} command_stat_t;
+
+/** @struct command_stats
+ * @brief Struktura przechowujaca statystyki komend.
+ */
+struct command_stats {
+    command_stat_t commands[NUMBER_OF_STAT_COMMANDS]; ///< statystyki komend
+    char *target; ///< "stderr" lub sciezka pliku z podsumowaniami
+    uint64_t start_ticks; ///< wartosc licznika czasu przy utworzeniu
+    uint64_t start_ns; ///< czas zegara monotonicznego przy utworzeniu
+};
+
+/** Nazwy komend w kolejnosci od @ref GAMMA_MOVE do @ref GAMMA_BOARD,
+ * a po nich @ref GAMMA_BOARD_DIFF. */
+static const char *command_names[NUMBER_OF_STAT_COMMANDS] = {
+    "m", "g", "b", "f", "q", "p", "d"
+};
+
+/** @brief Podaje czas zegara monotonicznego w nanosekundach.
+ * @return czas w nanosekundach.
+ */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+uint64_t command_stats_clock(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return now_ns();
+#endif
+}
+
+/** @brief Podaje numer kubelka histogramu dla danej wartosci.
+ * @param[in] value - wartosc.
+ * @return numer kubelka.
+ */
+static uint32_t bucket_of(uint64_t value) {
+    if(value < SUB_BUCKETS) return (uint32_t) value;
+    uint32_t exponent = 63 - (uint32_t) __builtin_clzll(value);
+    uint32_t sub = (uint32_t) (value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+}
+
+/** @brief Podaje najmniejsza wartosc nalezaca do kubelka.
+ * @param[in] bucket - numer kubelka.
+ * @return najmniejsza wartosc kubelka.
+ */
+static uint64_t bucket_lower_bound(uint32_t bucket) {
+    if(bucket < SUB_BUCKETS) return bucket;
+    uint32_t exponent = bucket / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+    uint64_t sub = bucket % SUB_BUCKETS;
+    return (SUB_BUCKETS + sub) << (exponent - SUB_BUCKET_BITS);
+}
+
+bool command_stats_init(command_stats_t **s, const char *target) {
+    *s = calloc(1, sizeof(command_stats_t));
+    if(*s == NULL) return false;
+    (*s)->target = strdup(target);
+    if((*s)->target == NULL) {
+        free(*s);
+        *s = NULL;
+        return false;
+    }
+    (*s)->start_ticks = command_stats_clock();
+    (*s)->start_ns = now_ns();
+    event_counters_enable();
+    return true;
+}
+
+void delete_command_stats(command_stats_t *s) {
+    if(s != NULL) {
+        free(s->target);
+        free(s);
+    }
+}
+
+void command_stats_record(command_stats_t *s, uint32_t command, bool success,
+                          uint64_t ticks) {
+    uint32_t index = (command == GAMMA_BOARD_DIFF)
+                     ? NUMBER_OF_STAT_COMMANDS - 1 : command - GAMMA_MOVE;
+    command_stat_t *c = &s->commands[index];
+    c->calls++;
+    c->successes += success;
+    c->total_ticks += ticks;
+    if(ticks > c->max_ticks) c->max_ticks = ticks;
+    c->histogram[bucket_of(ticks)]++;
+}
+
+/** @brief Podaje percentyl czasow wywolan.
+ * @param[in] c - statystyki komendy,
+ * @param[in] fraction - percentyl jako ulamek z przedzialu (0, 1].
+ * @return dolna granica kubelka zawierajacego percentyl.
+ */
+static uint64_t percentile(const command_stat_t *c, double fraction) {
+    uint64_t rank = (uint64_t) ((double) c->calls * fraction);
+    if(rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for(uint32_t b = 0; b < HISTOGRAM_BUCKETS; ++b) {
+        seen += c->histogram[b];
+        if(seen >= rank) return bucket_lower_bound(b);
+    }
+    return c->max_ticks;
+}
+
+void command_stats_dump(command_stats_t *s) {
+    bool to_stderr = (strcmp(s->target, "stderr") == 0);
+    FILE *out = to_stderr ? stderr : fopen(s->target, "a");
+    if(out == NULL) return;
+
+    uint64_t elapsed_ns = now_ns() - s->start_ns;
+    uint64_t elapsed_ticks = command_stats_clock() - s->start_ticks;
+    double ns_per_tick = (elapsed_ticks == 0) ? 1.0
+                         : (double) elapsed_ns / (double) elapsed_ticks;
+
+    fprintf(out, "# batch stats after %.3f s, latency in ns\n", elapsed_ns / 1e9);
+    fprintf(out, "# cmd\tcalls\tok\tfailed\tmean\tp50\tp90\tp99\tp99.9\tmax\n");
+    for(uint32_t i = 0; i < NUMBER_OF_STAT_COMMANDS; ++i) {
+        const command_stat_t *c = &s->commands[i];
+        if(c->calls == 0) continue;
+        fprintf(out, "%s\t%" PRIu64 "\t%" PRIu64 "\t%" PRIu64
+                "\t%.0f\t%.0f\t%.0f\t%.0f\t%.0f\t%.0f\n",
+                command_names[i], c->calls, c->successes, c->calls - c->successes,
+                ns_per_tick * (double) c->total_ticks / (double) c->calls,
+                ns_per_tick * (double) percentile(c, 0.5),
+                ns_per_tick * (double) percentile(c, 0.9),
+                ns_per_tick * (double) percentile(c, 0.99),
+                ns_per_tick * (double) percentile(c, 0.999),
+                ns_per_tick * (double) c->max_ticks);
+    }
+    const event_counters_t *e = &event_counters;
+    fprintf(out, "# events\tfind_calls=%" PRIu64 "\tfind_steps=%" PRIu64
+            "\tfind_avg_path=%.2f\tfind_max_path=%" PRIu64 "\tdfs_cells=%" PRIu64
+            "\tclear_visited_calls=%" PRIu64 "\tclear_visited_cells=%" PRIu64 "\n",
+            e->find_calls, e->find_steps,
+            e->find_calls == 0 ? 0.0 : (double) e->find_steps / (double) e->find_calls,
+            e->find_max_path, e->dfs_cells, e->clear_visited_calls,
+            e->clear_visited_cells);
+
+    if(to_stderr) fflush(out);
+    else fclose(out);
+}
@@ -0,0 +1,70 @@
+/** @file
+ * Interfejs statystyk komend trybu wsadowego
+ *
+ * Dla kazdego rodzaju komendy (@p m, @p g, @p b, @p f, @p q, @p p)
+ * zbierana jest liczba wywolan, liczba wywolan zakonczonych sukcesem
+ * (wykonanym ruchem lub wypisana plansza; zapytania o stan gry zawsze sie
+ * udaja) i histogram czasow wykonania o logarytmicznych
+ * przedzialach, z ktorych kazdy dzielony jest na 16 rownych czesci
+ * (jak w HdrHistogram), co daje blad wzgledny ponizej 7%.
+ * Czas mierzony jest licznikiem cykli procesora, jesli jest dostepny.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#ifndef COMMAND_STATS_H
+#define COMMAND_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * Struktura przechowujaca statystyki komend.
+ */
+typedef struct command_stats command_stats_t;
+
+/** @brief Tworzy puste statystyki i wlacza liczniki zdarzen silnika.
+ * @param[out] s - wskaznik, pod ktory zostana zapisane statystyki,
+ * @param[in] target - napis "stderr" lub sciezka pliku, do ktorego
+ * dopisywane beda podsumowania.
+ * @return Wartosc @p true, jesli udalo sie zaalokowac pamiec,
+ * @p false w przeciwnym przypadku.
+ */
+bool command_stats_init(command_stats_t **s, const char *target);
+
+/** @brief Usuwa statystyki.
+ * Nic nie robi, jesli wskaznik ma wartosc NULL.
+ * @param[in] s - wskaznik na statystyki.
+ */
+void delete_command_stats(command_stats_t *s);
+
+/** @brief Odczytuje licznik czasu uzywany do pomiarow.
+ * @return wartosc licznika cykli lub zegara monotonicznego.
+ */
+uint64_t command_stats_clock(void);
+
+/** @brief Zapisuje wykonanie komendy.
+ * @param[in,out] s - wskaznik na statystyki,
+ * @param[in] command - rodzaj komendy, jedna z wartosci od @ref GAMMA_MOVE
+ * do @ref GAMMA_BOARD lub @ref GAMMA_BOARD_DIFF,
+ * @param[in] success - czy komenda sie powiodla: dla ruchow czy ruch
+ * wykonano, dla komend wypisujacych plansze czy udalo sie ja wypisac,
+ * a dla zapytan o stan gry zawsze @p true,
+ * @param[in] ticks - czas wykonania zmierzony funkcja
+ * @ref command_stats_clock.
+ */
+void command_stats_record(command_stats_t *s, uint32_t command, bool success,
+                          uint64_t ticks);
+
+/** @brief Wypisuje podsumowanie statystyk.
+ * Wypisuje dla kazdej komendy liczbe wywolan, sukcesow i porazek, sredni
+ * czas i percentyle czasu w nanosekundach, a takze liczniki zdarzen
+ * wewnetrznych silnika biezacego watku.
+ * @param[in] s - wskaznik na statystyki.
+ */
+void command_stats_dump(command_stats_t *s);
+
+#endif //COMMAND_STATS_H
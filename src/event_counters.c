@@ -0,0 +1,17 @@
+/** @file
+ * Definicja licznikow z pliku event_counters.h
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#include "event_counters.h"
+
+_Thread_local event_counters_t event_counters;
+
+bool event_counters_enabled = false;
+
+void event_counters_enable(void) {
+    event_counters_enabled = true;
+}
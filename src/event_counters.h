@@ -0,0 +1,56 @@
+/** @file
+ * Liczniki zdarzen wewnetrznych silnika gry gamma
+ *
+ * Liczniki sa zmiennymi lokalnymi watku, wiec ich zwiekszanie nie wymaga
+ * synchronizacji. Sa domyslnie wylaczone, zeby nie obciazac goracych
+ * sciezek silnika; wlacza je @ref event_counters_enable, wolana przy
+ * wlaczeniu statystyk komend (zmienna GAMMA_STATS).
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#ifndef EVENT_COUNTERS_H
+#define EVENT_COUNTERS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @struct event_counters
+ * @brief Liczniki zdarzen wewnetrznych silnika.
+ */
+typedef struct event_counters {
+    uint64_t find_calls; ///< liczba wywolan funkcji find
+    uint64_t find_steps; ///< laczna dlugosc sciezek przechodzonych przez find
+    uint64_t find_max_path; ///< najdluzsza sciezka przechodzona przez find
+    uint64_t dfs_cells; ///< liczba pol odwiedzonych przez przeszukiwania obszarow
+    uint64_t clear_visited_calls; ///< liczba czyszczen tablicy odwiedzonych pol
+    uint64_t clear_visited_cells; ///< liczba pol wyczyszczonych w tej tablicy
+} event_counters_t;
+
+/** Liczniki zdarzen biezacego watku. */
+extern _Thread_local event_counters_t event_counters;
+
+/** Czy liczniki sa wlaczone; ustawiane przed utworzeniem gier. */
+extern bool event_counters_enabled;
+
+/** @brief Wlacza zliczanie zdarzen we wszystkich watkach.
+ * Nalezy ja wywolac, zanim silnik zacznie pracowac.
+ */
+void event_counters_enable(void);
+
+/** Zwieksza licznik @p field biezacego watku o @p value,
+ * jesli liczniki sa wlaczone. */
+#define EVENT_ADD(field, value)                                        \
+    (__builtin_expect(event_counters_enabled, 0)                       \
+     ? (void) (event_counters.field += (value)) : (void) 0)
+
+/** Podnosi licznik @p field biezacego watku do @p value, jesli jest
+ * mniejszy, a liczniki sa wlaczone. */
+#define EVENT_MAX(field, value)                                        \
+    (__builtin_expect(event_counters_enabled, 0)                       \
+     && event_counters.field < (value)                                 \
+     ? (void) (event_counters.field = (value)) : (void) 0)
+
+#endif //EVENT_COUNTERS_H
@@ -6,7 +6,9 @@
  * @date 15.04.2020
  */
 
+#include <string.h>
 #include "fau.h"
+#include "event_counters.h"
 
 /** @struct pair
  * @brief Struktura przechowująca pare koordynatow.
@@ -113,19 +115,32 @@ void set_default_parent(fau_t *f, uint32_t x, uint32_t y) {
     f->size[x][y] = 0;
 }
 
-pair_t *find(fau_t *f, pair_t *p) {
+/** @brief Znajduje korzen drzewa, kompresujac sciezke.
+ * @param[in,out] f – wskaznik na drzewo find and union,
+ * @param[in] p - wskaznik na pare, ktorej korzenia poszukujemy,
+ * @param[in] depth - liczba krokow wykonanych dotychczas na sciezce.
+ * @return Wskaznik na strukture bedaca szukanym ojcem w drzewie find and union
+ */
+static pair_t *find_root(fau_t *f, pair_t *p, uint64_t depth) {
     pair_t temp;
     temp.x = p->x;
     temp.y = p->y;
     if (are_equal(&(f->parent[p->x][p->y]),&temp)) {
+        EVENT_ADD(find_steps, depth);
+        EVENT_MAX(find_max_path, depth);
         return p;
     }
     else {
-        f->parent[p->x][p->y] = *find(f, &f->parent[p->x][p->y]);;
+        f->parent[p->x][p->y] = *find_root(f, &f->parent[p->x][p->y], depth + 1);
         return &(f->parent[p->x][p->y]);
     }
 }
 
+pair_t *find(fau_t *f, pair_t *p) {
+    EVENT_ADD(find_calls, 1);
+    return find_root(f, p, 0);
+}
+
 void unite(fau_t *f, pair_t *a, pair_t *b) {
     a = find(f, a);
     b = find(f, b);
@@ -140,3 +155,52 @@ void unite(fau_t *f, pair_t *a, pair_t *b) {
         }
     }
 }
+
+size_t pair_size(void) {
+    return sizeof(pair_t);
+}
+
+uint64_t columns_size(uint32_t width, uint32_t height, uint64_t cell) {
+    uint64_t cells, bytes;
+    if(__builtin_mul_overflow((uint64_t) width, (uint64_t) height, &cells)
+       || __builtin_mul_overflow(cells, cell, &bytes)
+       || __builtin_add_overflow(bytes, (uint64_t) width * sizeof(void *), &bytes)) {
+        return UINT64_MAX;
+    }
+    return bytes;
+}
+
+void fau_memory_usage(uint32_t width, uint32_t height,
+                      uint64_t *parent, uint64_t *size) {
+    *parent = columns_size(width, height, sizeof(pair_t));
+    if(*parent != UINT64_MAX) *parent += sizeof(fau_t);
+    *size = columns_size(width, height, sizeof(uint32_t));
+}
+
+void fau_copy(fau_t *dst, fau_t *src, uint32_t height) {
+    for(uint32_t x = 0; x < src->width; ++x) {
+        memcpy(dst->parent[x], src->parent[x], sizeof(pair_t) * height);
+        memcpy(dst->size[x], src->size[x], sizeof(uint32_t) * height);
+    }
+}
+
+void fau_root(fau_t *f, uint32_t x, uint32_t y, uint32_t *root_x, uint32_t *root_y) {
+    while(f->parent[x][y].x != x || f->parent[x][y].y != y) {
+        pair_t parent = f->parent[x][y];
+        x = parent.x;
+        y = parent.y;
+    }
+    *root_x = x;
+    *root_y = y;
+}
+
+void fau_prefetch(fau_t *f, uint32_t x, uint32_t y) {
+    __builtin_prefetch(&f->parent[x][y], 1);
+    __builtin_prefetch(&f->size[x][y], 1);
+}
+
+void fau_unite_fields(fau_t *f, uint32_t x1, uint32_t y1, uint32_t x2, uint32_t y2) {
+    pair_t a = { x1, y1 };
+    pair_t b = { x2, y2 };
+    unite(f, &a, &b);
+}
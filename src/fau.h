@@ -121,5 +121,73 @@ pair_t *find(fau_t *f, pair_t *p);
  */
 void unite(fau_t *f, pair_t *a, pair_t *b);
 
+/** @brief Podaje rozmiar struktury pary koordynatow.
+ * @return liczba bajtow zajmowanych przez jedna pare koordynatow.
+ */
+size_t pair_size(void);
+
+/** @brief Podaje rozmiar dwuwymiarowej tablicy alokowanej kolumnami.
+ * Tablica sklada sie z @p width wskaznikow na kolumny i @p width * @p height
+ * pol; tak alokowane sa drzewo find and union i plansza gry.
+ * @param[in] width – liczba kolumn,
+ * @param[in] height – liczba pol w kolumnie,
+ * @param[in] cell – rozmiar pola w bajtach.
+ * @return liczba bajtow lub UINT64_MAX przy przepelnieniu.
+ */
+uint64_t columns_size(uint32_t width, uint32_t height, uint64_t cell);
+
+/** @brief Podaje pamiec zajmowana przez drzewo find and union.
+ * Podaje liczbe bajtow alokowanych przez @ref fau_init dla drzewa
+ * o wymiarach @p width na @p height, bez narzutu alokatora.
+ * Dla wymiarow, ktorych pamieci nie da sie wyrazic liczba 64-bitowa,
+ * zwraca UINT64_MAX.
+ * @param[in] width – szerokosc drzewa,
+ * @param[in] height – wysokosc drzewa,
+ * @param[out] parent – liczba bajtow tablicy ojcow wraz ze struktura drzewa,
+ * @param[out] size – liczba bajtow tablicy rozmiarow drzew.
+ */
+void fau_memory_usage(uint32_t width, uint32_t height,
+                      uint64_t *parent, uint64_t *size);
+
+/** @brief Kopiuje drzewo find and union.
+ * Ustawia ojcow i rozmiary drzewa @p dst tak jak w drzewie @p src.
+ * Oba drzewa musza miec te same wymiary.
+ * @param[in,out] dst – wskaznik na drzewo, do ktorego kopiujemy,
+ * @param[in] src – wskaznik na kopiowane drzewo,
+ * @param[in] height – wysokosc obu drzew.
+ */
+void fau_copy(fau_t *dst, fau_t *src, uint32_t height);
+
+/** @brief Znajduje korzen drzewa pola bez kompresji sciezki.
+ * Nie zmienia drzewa, wiec moze byc uzywana do oceny ruchu bez jego
+ * wykonywania.
+ * @param[in] f – wskaznik na drzewo find and union,
+ * @param[in] x – numer kolumny pola,
+ * @param[in] y – numer wiersza pola,
+ * @param[out] root_x – numer kolumny korzenia,
+ * @param[out] root_y – numer wiersza korzenia.
+ */
+void fau_root(fau_t *f, uint32_t x, uint32_t y, uint32_t *root_x, uint32_t *root_y);
+
+/** @brief Sprowadza do pamieci podrecznej wpis pola w drzewie.
+ * Nie zmienia drzewa i niczego nie odczytuje poza wskaznikami kolumn.
+ * @param[in] f – wskaznik na drzewo find and union,
+ * @param[in] x – numer kolumny pola,
+ * @param[in] y – numer wiersza pola.
+ */
+void fau_prefetch(fau_t *f, uint32_t x, uint32_t y);
+
+/** @brief Laczy zbiory dwoch pol w drzewie find and union.
+ * Odpowiednik @ref unite przyjmujacy koordynaty pol, ktory nie wymaga
+ * wspoldzielonych struktur par, wiec moze byc wolany rownolegle dla
+ * rozlacznych czesci drzewa.
+ * @param[in,out] f – wskaznik na drzewo find and union,
+ * @param[in] x1 – numer kolumny pierwszego pola,
+ * @param[in] y1 – numer wiersza pierwszego pola,
+ * @param[in] x2 – numer kolumny drugiego pola,
+ * @param[in] y2 – numer wiersza drugiego pola.
+ */
+void fau_unite_fields(fau_t *f, uint32_t x1, uint32_t y1, uint32_t x2, uint32_t y2);
+
 
 #endif
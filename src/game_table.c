@@ -0,0 +1,141 @@
+/** @file
+ * Implementacja interfejsu game_table.h
+ *
+ * Tablica uzywa adresowania otwartego z liniowym probkowaniem;
+ * przy usuwaniu kolejne elementy grupy sa przesuwane wstecz,
+ * wiec tablica nie potrzebuje znacznikow usuniecia.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#include "game_table.h"
+
+#define GAME_TABLE_INITIAL_CAPACITY 64 ///< poczatkowa liczba kubelkow
+
+/** @struct game_slot
+ * @brief Kubelek tablicy haszujacej.
+ */
+typedef struct game_slot {
+    uint32_t id; ///< numer gry
+    gamma_t *game; ///< wskaznik na gre lub NULL dla pustego kubelka
+} game_slot_t;
+
+/** @struct game_table
+ * @brief Struktura przechowujaca tablice haszujaca gier.
+ */
+struct game_table {
+    game_slot_t *slots; ///< tablica kubelkow
+    uint64_t capacity; ///< liczba kubelkow, potega dwojki
+    uint64_t size; ///< liczba zajetych kubelkow
+};
+
+/** @brief Haszuje numer gry.
+ * @param[in] id - numer gry,
+ * @param[in] capacity - liczba kubelkow, potega dwojki.
+ * @return numer kubelka.
+ */
+static uint64_t slot_of(uint32_t id, uint64_t capacity) {
+    return ((uint64_t) id * 0x9E3779B97F4A7C15u >> 32) & (capacity - 1);
+}
+
+bool game_table_init(game_table_t **t) {
+    *t = malloc(sizeof(game_table_t));
+    if(*t == NULL) return false;
+    (*t)->slots = calloc(GAME_TABLE_INITIAL_CAPACITY, sizeof(game_slot_t));
+    (*t)->capacity = GAME_TABLE_INITIAL_CAPACITY;
+    (*t)->size = 0;
+    if((*t)->slots == NULL) {
+        free(*t);
+        *t = NULL;
+        return false;
+    }
+    return true;
+}
+
+void delete_game_table(game_table_t *t) {
+    if(t != NULL) {
+        for(uint64_t i = 0; i < t->capacity; ++i) {
+            gamma_delete(t->slots[i].game);
+        }
+        free(t->slots);
+        free(t);
+    }
+}
+
+/** @brief Znajduje kubelek z gra o danym numerze lub pierwszy pusty kubelek.
+ * @param[in] t - wskaznik na tablice gier,
+ * @param[in] id - numer gry.
+ * @return indeks kubelka.
+ */
+static uint64_t probe(game_table_t *t, uint32_t id) {
+    uint64_t i = slot_of(id, t->capacity);
+    while(t->slots[i].game != NULL && t->slots[i].id != id) {
+        i = (i + 1) & (t->capacity - 1);
+    }
+    return i;
+}
+
+/** @brief Podwaja liczbe kubelkow tablicy.
+ * @param[in,out] t - wskaznik na tablice gier.
+ * @return Wartosc @p true, jesli udalo sie zaalokowac pamiec,
+ * @p false w przeciwnym przypadku.
+ */
+static bool grow(game_table_t *t) {
+    game_slot_t *old = t->slots;
+    uint64_t old_capacity = t->capacity;
+    game_slot_t *slots = calloc(old_capacity * 2, sizeof(game_slot_t));
+    if(slots == NULL) return false;
+    t->slots = slots;
+    t->capacity = old_capacity * 2;
+    for(uint64_t i = 0; i < old_capacity; ++i) {
+        if(old[i].game != NULL) {
+            t->slots[probe(t, old[i].id)] = old[i];
+        }
+    }
+    free(old);
+    return true;
+}
+
+gamma_t *game_table_find(game_table_t *t, uint32_t id) {
+    return t->slots[probe(t, id)].game;
+}
+
+bool game_table_insert(game_table_t *t, uint32_t id, gamma_t *g) {
+    if(game_table_find(t, id) != NULL) return false;
+    if((t->size + 1) * 4 > t->capacity * 3 && !grow(t)) return false;
+    uint64_t i = probe(t, id);
+    t->slots[i].id = id;
+    t->slots[i].game = g;
+    t->size++;
+    return true;
+}
+
+bool game_table_remove(game_table_t *t, uint32_t id) {
+    uint64_t i = probe(t, id);
+    if(t->slots[i].game == NULL) return false;
+    gamma_delete(t->slots[i].game);
+    t->slots[i].game = NULL;
+    t->size--;
+
+    uint64_t mask = t->capacity - 1;
+    uint64_t j = i;
+    while(true) {
+        j = (j + 1) & mask;
+        if(t->slots[j].game == NULL) break;
+        uint64_t home = slot_of(t->slots[j].id, t->capacity);
+        /* Element moze zostac przesuniety do dziury i tylko wtedy, gdy jego
+         * kubelek docelowy nie lezy cyklicznie w przedziale (i, j]. */
+        if(((j - home) & mask) >= ((j - i) & mask)) {
+            t->slots[i] = t->slots[j];
+            t->slots[j].game = NULL;
+            i = j;
+        }
+    }
+    return true;
+}
+
+uint64_t game_table_size(game_table_t *t) {
+    return t->size;
+}
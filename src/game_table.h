@@ -0,0 +1,65 @@
+/** @file
+ * Interfejs tablicy haszujacej przechowujacej gry wedlug ich numerow
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#ifndef GAME_TABLE_H
+#define GAME_TABLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "gamma.h"
+
+/**
+ * Struktura przechowujaca tablice haszujaca numer gry -> gra.
+ */
+typedef struct game_table game_table_t;
+
+/** @brief Tworzy pusta tablice gier.
+ * @param[out] t - wskaznik, pod ktory zostanie zapisana nowa tablica.
+ * @return Wartosc @p true, jesli udalo sie zaalokowac pamiec,
+ * @p false w przeciwnym przypadku.
+ */
+bool game_table_init(game_table_t **t);
+
+/** @brief Usuwa tablice gier wraz ze wszystkimi przechowywanymi grami.
+ * Nic nie robi, jesli wskaznik ma wartosc NULL.
+ * @param[in] t - wskaznik na usuwana tablice.
+ */
+void delete_game_table(game_table_t *t);
+
+/** @brief Wyszukuje gre o danym numerze.
+ * @param[in] t - wskaznik na tablice gier,
+ * @param[in] id - numer gry.
+ * @return Wskaznik na gre lub NULL, jesli gry o tym numerze nie ma w tablicy.
+ */
+gamma_t *game_table_find(game_table_t *t, uint32_t id);
+
+/** @brief Dodaje gre do tablicy.
+ * @param[in,out] t - wskaznik na tablice gier,
+ * @param[in] id - numer gry,
+ * @param[in] g - wskaznik na dodawana gre.
+ * @return Wartosc @p true, jesli gra zostala dodana, @p false jesli gra
+ * o tym numerze juz istnieje lub nie udalo sie zaalokowac pamieci.
+ */
+bool game_table_insert(game_table_t *t, uint32_t id, gamma_t *g);
+
+/** @brief Usuwa gre z tablicy i zwalnia ja.
+ * @param[in,out] t - wskaznik na tablice gier,
+ * @param[in] id - numer gry.
+ * @return Wartosc @p true, jesli gra o tym numerze istniala,
+ * @p false w przeciwnym przypadku.
+ */
+bool game_table_remove(game_table_t *t, uint32_t id);
+
+/** @brief Podaje liczbe gier w tablicy.
+ * @param[in] t - wskaznik na tablice gier.
+ * @return liczba przechowywanych gier.
+ */
+uint64_t game_table_size(game_table_t *t);
+
+#endif //GAME_TABLE_H
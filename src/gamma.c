@@ -6,8 +6,53 @@
  * @date 16.05.2020
  */
 
+#define _GNU_SOURCE
+#include <fcntl.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #include "gamma.h"
+#include "board_mirror.h"
+#include "event_counters.h"
+#include "thread_pool.h"
+
+#define MAX_PLAYER_DIGITS 10 ///< ilosc cyfr najwiekszego numeru gracza
+#define PARALLEL_MIN_CELLS (1u << 20) /**< od jakiej ilosci pol planszy
+                                        * przegladanie calej planszy jest
+                                        * dzielone pomiedzy watki **/
+/** Odczytuje wartosc, ktora moze byc rownoczesnie zmieniana przez pisarza. */
+#define RELAXED_LOAD(lvalue) __atomic_load_n(&(lvalue), __ATOMIC_RELAXED)
+/** Zapisuje wartosc, ktora moze byc rownoczesnie czytana przez czytelnika. */
+#define RELAXED_STORE(lvalue, value) \
+    __atomic_store_n(&(lvalue), (value), __ATOMIC_RELAXED)
+#define DIFF_LINE_LEN (3 * MAX_PLAYER_DIGITS + 3) /**< najwieksza dlugosc
+                                                 * linii wyniku
+                                                 * @ref gamma_board_diff **/
+#define TRANSFORM_MIRROR_X 1 ///< przeksztalcenie odbija numery kolumn
+#define TRANSFORM_MIRROR_Y 2 ///< przeksztalcenie odbija numery wierszy
+#define TRANSFORM_TRANSPOSE 4 /**< przeksztalcenie zamienia kolumny z wierszami
+                               * po odbiciach **/
+#define PARALLEL_CHUNKS_PER_THREAD 4 /**< na ile fragmentow na watek dzielona
+                                       * jest praca rownolegla **/
+#define BATCH_PREFETCH_DISTANCE 8 /**< o ile ruchow naprzod @ref gamma_move_batch
+                                   * sprowadza wpisy drzewa find and union do
+                                   * pamieci podrecznej; pola planszy sa
+                                   * sprowadzane dwa razy wczesniej **/
+#define FLAT_PLAYERS_LIMIT 4096 /**< najwieksza liczba graczy, dla ktorej
+                                 * stan graczy jest zwykla tablica
+                                 * indeksowana numerem gracza **/
+#define BATCH_WRITE_GROUP 64 /**< ile ruchow @ref gamma_move_batch wykonuje
+                              * w jednej zmianie stanu gry **/
+
+/** @struct gamma_subscriber
+ * @brief Subskrypcja zmian planszy.
+ */
+typedef struct gamma_subscriber {
+    uint32_t id; ///< numer subskrypcji
+    gamma_change_fn fn; ///< funkcja powiadamiana o zmianach
+    void *ctx; ///< kontekst funkcji
+} gamma_subscriber_t;
 
 /** @struct gamma
  * @brief Struktura przechowująca stan gry.
@@ -15,11 +60,18 @@
  * informacje na szerokosci i wysokosci planszy,
  * ilosci graczy i mozliwej maksymalnej ilosci rozlacznych obszarow,
  * ilosci obszarow poszczegolnych graczy i ilosc zajmowanych przez nich pol,
- * informacje o tym ktorzy gracze moga wykonac golden move,
+ * informacje o tym ktorzy gracze moga wykonac golden move
+ * (tylko dla graczy, ktorzy wykonali jakis ruch),
+ * laczna ilosc zajetych pol,
+ * ilosc graczy zajmujacych jakies pole wraz z podzialem na dlugosc ich numerow
+ * i najwiekszy numer takiego gracza,
  * wskaznik do struktury drzewa find and union
+ * opcjonalny dziennik ruchow,
+ * licznik sekwencyjny pozwalajacy czytac stan gry z innych watkow,
+ * subskrypcje zmian planszy
  * oraz zmienne pomocnicze:
- * tablica uzywana do przeszukiwania obszaru w
- * @ref gamma_golden_move oraz @ref check_golden_move
+ * znaczniki i stos uzywane do przeszukiwania obszaru w
+ * @ref gamma_golden_move oraz @ref evaluate_golden_move
  * i dwie pomocnicze zmienne typu pair_t* uzywane 
  * do przeszukiwania drzewa find and union
  */
@@ -28,19 +80,70 @@ struct gamma {
     uint32_t height; ///< wysokosc planszy
     uint32_t players; ///< ilosc graczy
     uint32_t areas; ///< maksymalna ilosc rozlacznych obszarow
-    uint32_t **board; ///< tablica przechowujaca stan gry
-    uint64_t *players_areas; /**<tablica pamietajaca ilosc rozlacznych
-                                * obszarow zajmowanych przez
-                                * poszczegolnych graczy **/
-    uint64_t *players_field_count; /**< tablica pamietajaca ilosc pol
-                                  * zajmowanych przez poszczegolnych graczy **/
-    bool *possible_golden_move; /**< tablica pamietajaca
-                                * o mozliwosci wykonania golden move przez graczy**/
+    uint32_t **board; ///< tablica przechowujaca stan gry, wskazniki na kolumny
+    uint32_t *cells; /**< ciagla tablica pol planszy, na ktorej kolumny
+                      * wskazuje @p board **/
+    board_mirror_header_t *shared; /**< naglowek segmentu pamieci wspoldzielonej
+                                    * z polami planszy lub NULL **/
+    size_t shared_size; ///< rozmiar zmapowanego segmentu
+    char *shared_name; ///< nazwa segmentu pamieci wspoldzielonej lub NULL
+    player_entry_t *flat_players; /**< stan graczy indeksowany numerem
+                                   * gracza, gdy graczy jest nie wiecej niz
+                                   * @ref FLAT_PLAYERS_LIMIT, lub NULL **/
+    player_table_t *player_table; /**< ilosc obszarow i pol oraz wykorzystanie
+                                   * golden move przez graczy, ktorzy
+                                   * wykonali jakis ruch, gdy graczy jest
+                                   * wiecej niz @ref FLAT_PLAYERS_LIMIT,
+                                   * lub NULL **/
+    uint64_t busy_fields; ///< laczna ilosc zajetych pol
+    uint32_t active_players; ///< ilosc graczy zajmujacych przynajmniej jedno pole
+    uint32_t active_players_by_width[MAX_PLAYER_DIGITS + 1]; /**< ilosc graczy
+                                  * zajmujacych przynajmniej jedno pole,
+                                  * ktorych numer ma dana ilosc cyfr **/
+    uint32_t max_active_player; /**< najwiekszy numer gracza zajmujacego
+                                 * przynajmniej jedno pole lub 0 **/
     fau_t *f; ///< struktura przechowujaca find and union
-    bool **visited; /**< pomocnicza tablica do przeszukiwania obszaru
-                    * w @ref gamma_golden_move oraz @ref check_golden_move **/
+    uint32_t *visited; /**< znaczniki odwiedzenia pol przy przeszukiwaniu
+                        * obszaru, pole (x, y) ma indeks x * height + y;
+                        * pole jest odwiedzone, jesli jego znacznik jest
+                        * rowny @p visit_epoch **/
+    uint32_t visit_epoch; ///< znacznik biezacego przeszukiwania
+    uint64_t *walk_stack; /**< stos pol do odwiedzenia przy przeszukiwaniu
+                           * obszaru, alokowany przy pierwszym zlotym ruchu
+                           * lub jego ocenie **/
     pair_t *a, *b; /**< pomocnicze zmienne typu pair_t*
                     * uzywane do przeszukiwania drzewa find and union **/
+    move_log_t *log; /**< dziennik, do ktorego dopisywane sa udane ruchy,
+                      * lub NULL **/
+    bool owns_log; ///< czy dziennik jest zamykany razem z gra
+    uint64_t *seq; /**< licznik sekwencyjny, nieparzysty w trakcie ruchu;
+                    * czytelnik powtarza odczyt, jesli licznik sie zmienil;
+                    * wskazuje na @p local_seq lub na licznik w naglowku
+                    * segmentu pamieci wspoldzielonej **/
+    uint64_t local_seq; ///< licznik sekwencyjny gry bez segmentu
+    gamma_subscriber_t *subscribers; ///< subskrypcje zmian planszy
+    uint32_t subscriber_count; ///< ilosc subskrypcji
+    uint32_t subscriber_capacity; ///< rozmiar tablicy @p subscribers
+    uint32_t next_subscriber_id; ///< numer kolejnej subskrypcji
+    uint64_t changes; ///< ilosc wykonanych zmian planszy
+    bool dirty_tracking; /**< czy zmienione pola sa sledzone; wlaczane
+                          * przy pierwszym uzyciu zbioru zmienionych pol **/
+    uint64_t *dirty_bits; /**< mapa bitowa pol zmienionych od ostatniego
+                           * @ref gamma_clear_diff, bit x * height + y,
+                           * lub NULL, jesli pola nie sa sledzone **/
+    uint64_t *dirty_cells; /**< numery x * height + y zmienionych pol
+                            * w kolejnosci pierwszej zmiany **/
+    uint64_t dirty_count; ///< ilosc zmienionych pol w @p dirty_cells
+    uint64_t dirty_capacity; ///< rozmiar tablicy @p dirty_cells
+    bool dirty_overflow; /**< czy lista zmienionych pol przekroczyla limit
+                          * lub nie udalo sie jej powiekszyc; wtedy
+                          * zmienione pola sa wyznaczane z mapy bitowej **/
+    uint64_t symmetry_hash[GAMMA_SYMMETRIES]; /**< skroty zajetych pol planszy
+                                               * po kazdym z przeksztalcen;
+                                               * przeksztalcenia zamieniajace
+                                               * kolumny z wierszami tylko dla
+                                               * planszy kwadratowej **/
+    uint64_t golden_hash; ///< skrot graczy, ktorzy wykonali zloty ruch
 };
 
 /**
@@ -50,156 +153,201 @@ typedef struct gamma gamma_t;
 
 void gamma_delete(gamma_t *g) {
     if(g != NULL) {
-        for(uint32_t i = 0; i < g->width; i++) {
-            if(g->board != NULL)free(g->board[i]);
-            if(g->visited != NULL)free(g->visited[i]);
+        if(g->shared != NULL) {
+            munmap(g->shared, g->shared_size);
+            shm_unlink(g->shared_name);
+        }
+        else {
+            free(g->cells);
         }
+        free(g->shared_name);
         free(g->board);
         free(g->visited);
-        free(g->players_areas);
-        free(g->players_field_count);
-        free(g->possible_golden_move);
+        free(g->walk_stack);
+        free(g->flat_players);
+        delete_player_table(g->player_table);
         delete_fau(g->f);
         delete_pair(g->a);
         delete_pair(g->b);
+        free(g->subscribers);
+        free(g->dirty_bits);
+        free(g->dirty_cells);
+        if(g->owns_log) {
+            move_log_close(g->log);
+        }
+        else if(g->log != NULL) {
+            move_log_sync(g->log);
+        }
         free(g);
     }
 }
 
+/** @brief funkcja tworzaca segment pamieci wspoldzielonej na pola planszy.
+ * Tworzy segment o nazwie @p name, zapisuje w nim naglowek
+ * i ustawia @p cells gry na pola segmentu.
+ * @param[in,out] g - wskaznik na strukture gry,
+ * @param[in] name - nazwa nowego segmentu.
+ * @return true jesli udalo sie utworzyc segment, false w przeciwnym wypadku.
+ */
+static bool shared_board_init(gamma_t *g, const char *name) {
+    uint64_t cells_offset = (sizeof(board_mirror_header_t) + 63) / 64 * 64;
+    uint64_t size = cells_offset
+                    + (uint64_t) g->width * (uint64_t) g->height * sizeof(uint32_t);
+    g->shared_name = strdup(name);
+    if(g->shared_name == NULL) {
+        return false;
+    }
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if(fd < 0) {
+        return false;
+    }
+    void *map = MAP_FAILED;
+    if(ftruncate(fd, (off_t) size) == 0) {
+        map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if(map == MAP_FAILED) {
+        shm_unlink(name);
+        return false;
+    }
+    g->shared = map;
+    g->shared_size = size;
+    memcpy(g->shared->magic, BOARD_MIRROR_MAGIC, sizeof(g->shared->magic));
+    g->shared->version = BOARD_MIRROR_VERSION;
+    g->shared->width = g->width;
+    g->shared->height = g->height;
+    g->shared->players = g->players;
+    g->shared->seq = 0;
+    g->shared->cells_offset = cells_offset;
+    g->cells = (uint32_t *) ((char *) map + cells_offset);
+    g->seq = &g->shared->seq;
+    return true;
+}
+
 /** @brief funkcja alokujaca pamiec na tablice pamietajaca stan gry.
  * funkcja alokujace pamiec na tablice pamietajaca stan gry, zwraca wiadomosc
  * o powodzeniu tej operacji
- * w razie powodzenia ustawia pola na puste (wartosc 0)
+ * w razie powodzenia ustawia pola na puste (wartosc 0).
+ * Pola leza w jednej ciaglej tablicy, kolumna po kolumnie, w pamieci
+ * procesu albo, jesli podano @p shared_name, w nowym segmencie pamieci
+ * wspoldzielonej.
  * @param[in,out] g - wskaznik na strukture gry, dla ktorej alokujemy tablice,
  * @param[in] width - szerokosc gry,
- * @param[in] height - wysokosc gry.
+ * @param[in] height - wysokosc gry,
+ * @param[in] shared_name - nazwa segmentu pamieci wspoldzielonej lub NULL.
  * @return true jesli udalo zaalokowac pamiec, false w przeciwnym wypadku.
  */
-static bool empty_board_init(gamma_t *g, uint32_t width, uint32_t height) {
+static bool empty_board_init(gamma_t *g, uint32_t width, uint32_t height,
+                             const char *shared_name) {
     uint64_t w = width;
     w*=sizeof(uint32_t *);
     g->board = malloc(w);
     if(g->board == NULL) {
         return false;
     }
-    bool flag = true;
-    uint64_t h = height;
-    h *= sizeof(uint32_t);
-    for(uint32_t i = 0; i < width; i++) {
-        g->board[i] = malloc(h);
-        if(g->board[i] == NULL) flag = false;
-    }
-
-    if(flag == false) {
-        return false;
-    }
-    for(uint32_t x = 0; x < width; ++x) {
-        for(uint32_t y = 0; y < height; ++y) {
-            g->board[x][y] = 0;
+    if(shared_name != NULL) {
+        if(!shared_board_init(g, shared_name)) {
+            return false;
         }
     }
-    return true;
-}
-
-/** @brief funkcja alokujaca pamiec na tablice pamietajaca ilosc obszarow graczy.
- * oraz na tablice pamietajaca ilosc pol zajmowanych przez nich.
- * funkcja alokujaca pamiec na tablice pamietajaca ilosc obszarow graczy
- * oraz na tablice pamietajaca ilosc pol zajmowanych przez nich.
- * Zwraca wiadomosc o powodzeniu tej operacji
- * w razie powodzenia wypelnia obie tablice zerami.
- * @param[in,out] g - wskaznik na strukture gry, dla ktorej alokujemy tablice,
- * @param[in] players - ilosc graczy w grze.
- * @return true jesli udalo zaalokowac pamiec, false w przeciwnym wypadku.
- */
-static bool empty_players_areas_player_field_count_init
-					(gamma_t *g, uint32_t players) {
-    uint64_t p = players;
-    g->players_areas = malloc(sizeof(uint64_t) * (p + 1));
-    g->players_field_count = malloc(sizeof(uint64_t) * (p + 1));
-
-    if(g->players_areas == NULL || g->players_field_count == NULL) {
-        return false;
+    else {
+        g->cells = calloc((uint64_t) width * (uint64_t) height, sizeof(uint32_t));
+        if(g->cells == NULL) {
+            return false;
+        }
     }
-
-    for(uint64_t i = 0; i <= p; ++i) {
-        g->players_field_count[i] = g->players_areas[i] = 0;
+    for(uint32_t x = 0; x < width; ++x) {
+        g->board[x] = g->cells + (uint64_t) x * height;
     }
     return true;
 }
 
-/** @brief funkcja czyszczaca pomocniczna tablice @p visited.
- * funkcja czyszczaca pomocniczna tablice @p visited.
+/** @brief funkcja rozpoczynajaca nowe przeszukiwanie obszaru.
+ * Zmienia znacznik biezacego przeszukiwania, przez co zadne pole nie jest
+ * odwiedzone. Znaczniki pol sa zerowane tylko po przepelnieniu licznika.
  * @param[in,out] g - wskaznik na strukture gry,
- * w ktorej trzymana jest tablica visited,
- * @param[in] width - szerokosc gry,
- * @param[in] height - wysokosc gry.
+ * w ktorej trzymana jest tablica visited.
  */
-static void clear_visited(gamma_t *g, uint32_t width, uint32_t height) {
-    uint64_t w = width;
-    uint64_t h = height;
-    for(uint64_t x = 0; x < w; ++x) {
-        for (uint64_t y = 0; y < h; ++y) {
-            g->visited[x][y] = false;
-        }
+static void clear_visited(gamma_t *g) {
+    EVENT_ADD(clear_visited_calls, 1);
+    if(++g->visit_epoch == 0) {
+        uint64_t cells = (uint64_t) g->width * (uint64_t) g->height;
+        EVENT_ADD(clear_visited_cells, cells);
+        memset(g->visited, 0, cells * sizeof(uint32_t));
+        g->visit_epoch = 1;
     }
 }
 
 /** @brief funkcja alokujaca pamiec na pomocnicza tablice visited.
  * funkcja alokujace pamiec na pomocnicza tablice visited, zwraca wiadomosc
  * o powodzeniu tej operacji
- * w razie powodzenia ustawia pola na false.
+ * w razie powodzenia zadne pole nie jest odwiedzone.
  * @param[in,out] g - wskaznik na strukture gry, dla ktorej alokujemy tablice,
  * @param[in] width - szerokosc gry,
  * @param[in] height - wysokosc gry.
  * @return true jesli udalo zaalokowac pamiec, false w przeciwnym wypadku.
  */
 static bool empty_visited_init(gamma_t *g, uint32_t width, uint32_t height) {
-    uint64_t w = width*sizeof(bool*);
-    w*=sizeof(bool*);
-    g->visited = malloc(w);
-    if(g->visited == NULL) {
-        return false;
-    }
-    bool flag = true;
-    for(uint32_t i = 0; i < width; i++) {
-        uint64_t h = height;
-        h*=sizeof(bool);
-        g->visited[i] = malloc(h);
-        if(g->visited[i] == NULL) flag = false;
-    }
-    if(flag == false) {
-        return false;
-    }
-    return true;
+    g->visited = calloc((uint64_t) width * (uint64_t) height, sizeof(uint32_t));
+    g->visit_epoch = 1;
+    return g->visited != NULL;
 }
 
+/** @brief Podaje rozmiar mapy bitowej zmienionych pol.
+ * @param[in] width - szerokosc planszy,
+ * @param[in] height - wysokosc planszy.
+ * @return liczba slow 64-bitowych mapy.
+ */
+static uint64_t dirty_bits_words(uint32_t width, uint32_t height) {
+    return ((uint64_t) width * (uint64_t) height + 63) / 64;
+}
 
-/** @brief funkcja alokujaca pamiec na tablice pamietajaca 
- * informacje mozliwosci golden move.
- * funkcja alokujaca pamiec na tablice pamietajaca 
- * informacje o wykonanych golden move.
- * Zwraca wiadomosc o powodzeniu tej operacji
- * w razie powodzenia wypelnia tablice wartosciami true.
- * @param[in,out] g - wskaznik na strukture gry, dla ktorej alokujemy tablice,
- * @param[in] players - ilosc graczy w grze.
- * @return true jesli udalo zaalokowac pamiec, false w przeciwnym wypadku
+/** @brief Podaje najwieksza dlugosc listy zmienionych pol.
+ * Gdy zmienionych pol jest wiecej, przejrzenie mapy bitowej kosztuje
+ * nie wiecej niz przejrzenie listy, wiec lista nie jest dalej powiekszana.
+ * @param[in] width - szerokosc planszy,
+ * @param[in] height - wysokosc planszy.
+ * @return liczba elementow listy.
  */
-static bool empty_possible_golden_move_init(gamma_t *g, uint32_t players) {
-    uint64_t p = players;
-    g->possible_golden_move = malloc(sizeof(bool) * (p + 1));
+static uint64_t dirty_cells_limit(uint32_t width, uint32_t height) {
+    uint64_t words = dirty_bits_words(width, height);
+    return (words < 64) ? 64 : words;
+}
 
-    if(g->possible_golden_move == NULL) {
+/** @brief funkcja tworzaca pusty stan graczy.
+ * Dla co najwyzej @ref FLAT_PLAYERS_LIMIT graczy alokuje zwykla tablice
+ * wpisow indeksowana numerem gracza, a w przeciwnym przypadku tablice
+ * graczy, ktorej pamiec rosnie z liczba aktywnych graczy.
+ * @param[in,out] g - wskaznik na strukture gry,
+ * @param[in] players - liczba graczy.
+ * @return true jesli udalo sie zaalokowac pamiec, false w przeciwnym wypadku.
+ */
+static bool players_init(gamma_t *g, uint32_t players) {
+    if(players > FLAT_PLAYERS_LIMIT) {
+        return player_table_init(&(g->player_table));
+    }
+    g->flat_players = calloc((uint64_t) players + 1, sizeof(player_entry_t));
+    if(g->flat_players == NULL) {
         return false;
     }
-
-    for(uint64_t i = 0; i <= p; ++i) {
-        g->possible_golden_move[i] = true;
+    for(uint32_t i = 0; i <= players; ++i) {
+        g->flat_players[i].id = i;
     }
     return true;
 }
 
-gamma_t* gamma_new(uint32_t width, uint32_t height,
-                   uint32_t players, uint32_t areas) {
+/** @brief Tworzy strukturę przechowującą stan gry.
+ * @param[in] width   – szerokość planszy, liczba dodatnia,
+ * @param[in] height  – wysokość planszy, liczba dodatnia,
+ * @param[in] players – liczba graczy, liczba dodatnia,
+ * @param[in] areas   – maksymalna liczba obszarów,
+ * @param[in] shared_name – nazwa segmentu pamieci wspoldzielonej na pola
+ * planszy lub NULL.
+ * @return Wskaźnik na utworzoną strukturę lub NULL.
+ */
+static gamma_t* gamma_create(uint32_t width, uint32_t height,
+                             uint32_t players, uint32_t areas,
+                             const char *shared_name) {
     if(width == 0 || height == 0 || areas == 0 || players == 0) return NULL;
     gamma_t *new_board;
     new_board = malloc(sizeof(gamma_t));
@@ -210,10 +358,43 @@ gamma_t* gamma_new(uint32_t width, uint32_t height,
     new_board->height = height;
     new_board->players = players;
     new_board->areas = areas;
+    new_board->log = NULL;
+    new_board->owns_log = false;
+    new_board->local_seq = 0;
+    new_board->seq = &new_board->local_seq;
+    new_board->board = NULL;
+    new_board->cells = NULL;
+    new_board->shared = NULL;
+    new_board->shared_size = 0;
+    new_board->shared_name = NULL;
+    new_board->subscribers = NULL;
+    new_board->subscriber_count = 0;
+    new_board->subscriber_capacity = 0;
+    new_board->next_subscriber_id = 1;
+    new_board->changes = 0;
+    new_board->dirty_tracking = false;
+    new_board->dirty_bits = NULL;
+    new_board->dirty_cells = NULL;
+    new_board->visited = NULL;
+    new_board->walk_stack = NULL;
+    new_board->dirty_count = 0;
+    new_board->dirty_capacity = 0;
+    new_board->dirty_overflow = false;
+    for(int i = 0; i < GAMMA_SYMMETRIES; ++i) {
+        new_board->symmetry_hash[i] = 0;
+    }
+    new_board->golden_hash = 0;
+    new_board->busy_fields = 0;
+    new_board->active_players = 0;
+    for(int i = 0; i <= MAX_PLAYER_DIGITS; ++i) {
+        new_board->active_players_by_width[i] = 0;
+    }
+    new_board->max_active_player = 0;
+    new_board->flat_players = NULL;
+    new_board->player_table = NULL;
     bool flag = true;
-    flag &= empty_players_areas_player_field_count_init(new_board, players);
-    flag &= empty_possible_golden_move_init(new_board, players);
-    flag &= empty_board_init(new_board, width, height);
+    flag &= players_init(new_board, players);
+    flag &= empty_board_init(new_board, width, height, shared_name);
     flag &= empty_visited_init(new_board, width, height);
     flag &= fau_init(&(new_board->f), width, height);
     flag &= pair_init(&(new_board->a));
@@ -225,6 +406,62 @@ gamma_t* gamma_new(uint32_t width, uint32_t height,
     return new_board;
 }
 
+gamma_t* gamma_new(uint32_t width, uint32_t height,
+                   uint32_t players, uint32_t areas) {
+    return gamma_create(width, height, players, areas, NULL);
+}
+
+gamma_t* gamma_new_shared(uint32_t width, uint32_t height,
+                          uint32_t players, uint32_t areas, const char *name) {
+    if(name == NULL) {
+        return NULL;
+    }
+    return gamma_create(width, height, players, areas, name);
+}
+
+/** @brief Sumuje skladniki pamieci zajmowanej przez gre.
+ * @param[in,out] stats - struktura, w ktorej ustawiane jest pole @p total.
+ */
+static void memory_stats_total(gamma_memory_stats_t *stats) {
+    uint64_t parts[] = { stats->board, stats->visited, stats->fau_parent,
+                         stats->fau_size, stats->players, stats->other };
+    stats->total = 0;
+    for(size_t i = 0; i < sizeof(parts) / sizeof(parts[0]); ++i) {
+        if(__builtin_add_overflow(stats->total, parts[i], &stats->total)) {
+            stats->total = UINT64_MAX;
+            break;
+        }
+    }
+}
+
+void gamma_memory_estimate(uint32_t width, uint32_t height, uint32_t players,
+                           gamma_memory_stats_t *stats) {
+    stats->board = columns_size(width, height, sizeof(uint32_t));
+    stats->visited = (uint64_t) width * (uint64_t) height;
+    if(__builtin_mul_overflow(stats->visited, sizeof(uint32_t), &stats->visited)) {
+        stats->visited = UINT64_MAX;
+    }
+    fau_memory_usage(width, height, &stats->fau_parent, &stats->fau_size);
+    stats->players = (players <= FLAT_PLAYERS_LIMIT)
+                     ? sizeof(player_entry_t) * ((uint64_t) players + 1)
+                     : player_table_memory_estimate();
+    stats->other = sizeof(gamma_t) + 2 * pair_size()
+                   + (dirty_bits_words(width, height)
+                      + dirty_cells_limit(width, height)) * sizeof(uint64_t);
+    memory_stats_total(stats);
+}
+
+gamma_t* gamma_new_with_budget(uint32_t width, uint32_t height,
+                               uint32_t players, uint32_t areas,
+                               uint64_t budget) {
+    gamma_memory_stats_t stats;
+    gamma_memory_estimate(width, height, players, &stats);
+    if(stats.total > budget) {
+        return NULL;
+    }
+    return gamma_new(width, height, players, areas);
+}
+
 /**@brief funkcja sprawzdajaca czy gra zostala poprawnie zainicjowana.
  * funkcja sprawdzajaca czy gra zostala poprawnie zainicjowana.
  * @param[in] g - wskaznik na gre, ktorej poprawne alkowanie jest sprawdzane.
@@ -256,6 +493,168 @@ static bool xy_valid(gamma_t *g, uint32_t x, uint32_t y) {
     return (x < g->width && y < g->height);
 }
 
+/**@brief rozpoczyna zmiane stanu gry.
+ * Ustawia nieparzysta wartosc licznika sekwencyjnego, przez co czytelnicy
+ * rozpoczynajacy odczyt czekaja, a trwajacy powtorza odczyt.
+ * @param[in,out] g - wskaznik na gre.
+ */
+static void write_begin(gamma_t *g) {
+    __atomic_store_n(g->seq, *g->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**@brief konczy zmiane stanu gry.
+ * @param[in,out] g - wskaznik na gre.
+ */
+static void write_end(gamma_t *g) {
+    __atomic_store_n(g->seq, *g->seq + 1, __ATOMIC_RELEASE);
+}
+
+/**@brief rozpoczyna odczyt stanu gry.
+ * Czeka, az zaden ruch nie bedzie w trakcie wykonywania.
+ * @param[in] g - wskaznik na gre.
+ * @return wartosc licznika sekwencyjnego do przekazania @ref read_retry.
+ */
+static uint64_t read_begin(gamma_t *g) {
+    uint64_t seq;
+    while((seq = __atomic_load_n(g->seq, __ATOMIC_ACQUIRE)) & 1) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+    return seq;
+}
+
+/**@brief sprawdza, czy odczyt trzeba powtorzyc.
+ * @param[in] g - wskaznik na gre,
+ * @param[in] seq - wartosc zwrocona przez @ref read_begin.
+ * @return true jesli w trakcie odczytu stan gry sie zmienil.
+ */
+static bool read_retry(gamma_t *g, uint64_t seq) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(g->seq, __ATOMIC_RELAXED) != seq;
+}
+
+/**@brief wyszukuje wpis gracza.
+ * Przy malej liczbie graczy wpis lezy w zwyklej tablicy, wiec nie trzeba
+ * przechodzic przez indeks tablicy graczy.
+ * @param[in] g - wskaznik na gre,
+ * @param[in] player - poprawny numer gracza.
+ * @return wskaznik na wpis gracza lub NULL, jesli gracz nie ma wpisu.
+ */
+static player_entry_t *find_entry(gamma_t *g, uint32_t player) {
+    if(g->flat_players != NULL) {
+        return &g->flat_players[player];
+    }
+    return player_table_find(g->player_table, player);
+}
+
+/**@brief wyszukuje wpis gracza, tworzac go w razie potrzeby.
+ * @param[in,out] g - wskaznik na gre,
+ * @param[in] player - poprawny numer gracza.
+ * @return wskaznik na wpis gracza lub NULL, jesli nie udalo sie zaalokowac
+ * pamieci.
+ */
+static player_entry_t *get_entry(gamma_t *g, uint32_t player) {
+    if(g->flat_players != NULL) {
+        return &g->flat_players[player];
+    }
+    return player_table_get(g->player_table, player);
+}
+
+/**@brief podaje ilosc rozlacznych obszarow zajmowanych przez gracza.
+ * @param[in] g - wskaznik na gre,
+ * @param[in] player - numer gracza.
+ * @return ilosc obszarow gracza, zero jesli gracz nie wykonal zadnego ruchu.
+ */
+static uint64_t player_areas(gamma_t *g, uint32_t player) {
+    player_entry_t *e = find_entry(g, player);
+    return (e == NULL) ? 0 : RELAXED_LOAD(e->areas);
+}
+
+/**@brief podaje ilosc pol zajmowanych przez gracza.
+ * @param[in] g - wskaznik na gre,
+ * @param[in] player - numer gracza.
+ * @return ilosc pol gracza, zero jesli gracz nie wykonal zadnego ruchu.
+ */
+static uint64_t player_field_count(gamma_t *g, uint32_t player) {
+    player_entry_t *e = find_entry(g, player);
+    return (e == NULL) ? 0 : RELAXED_LOAD(e->field_count);
+}
+
+/**@brief sprawdza czy gracz wykonal juz golden move.
+ * @param[in] g - wskaznik na gre,
+ * @param[in] player - numer gracza.
+ * @return true jesli gracz wykonal juz golden move, false w przeciwnym przypadku.
+ */
+static bool golden_move_used(gamma_t *g, uint32_t player) {
+    player_entry_t *e = find_entry(g, player);
+    return (e != NULL && RELAXED_LOAD(e->golden_move_used));
+}
+
+static uint64_t num_of_digits(uint32_t number);
+
+/**@brief wyznacza najwiekszy numer gracza zajmujacego jakies pole.
+ * Wolana tylko wtedy, gdy dotychczasowy gracz o najwiekszym numerze stracil
+ * ostatnie pole, co zdarza sie jedynie przy zlotym ruchu.
+ * @param[in] g - wskaznik na gre.
+ * @return numer gracza lub 0, jesli plansza jest pusta.
+ */
+static uint32_t find_max_active_player(gamma_t *g) {
+    if(g->flat_players != NULL) {
+        uint32_t player = g->max_active_player;
+        while(player > 0 && g->flat_players[player].field_count == 0) {
+            player--;
+        }
+        return player;
+    }
+    player_entry_t *entries = player_table_entries(g->player_table);
+    uint32_t max = 0;
+    for(uint32_t i = 0; i < player_table_size(g->player_table); ++i) {
+        if(entries[i].field_count != 0 && entries[i].id > max) {
+            max = entries[i].id;
+        }
+    }
+    return max;
+}
+
+/**@brief uaktualnia liczniki aktywnych graczy po zmianie ilosci pol gracza.
+ * @param[in,out] g - wskaznik na gre,
+ * @param[in] player - numer gracza,
+ * @param[in] before - ilosc pol gracza przed zmiana,
+ * @param[in] after - ilosc pol gracza po zmianie.
+ */
+static void field_count_changed(gamma_t *g, uint32_t player,
+                                uint64_t before, uint64_t after) {
+    if(before == 0 && after != 0) {
+        uint64_t digits = num_of_digits(player);
+        RELAXED_STORE(g->active_players, g->active_players + 1);
+        RELAXED_STORE(g->active_players_by_width[digits],
+                      g->active_players_by_width[digits] + 1);
+        if(player > g->max_active_player) {
+            RELAXED_STORE(g->max_active_player, player);
+        }
+    }
+    else if(before != 0 && after == 0) {
+        uint64_t digits = num_of_digits(player);
+        RELAXED_STORE(g->active_players, g->active_players - 1);
+        RELAXED_STORE(g->active_players_by_width[digits],
+                      g->active_players_by_width[digits] - 1);
+        if(player == g->max_active_player) {
+            RELAXED_STORE(g->max_active_player, find_max_active_player(g));
+        }
+    }
+}
+
+/**@brief podaje wpis gracza, ktorego pionek stoi na planszy.
+ * @param[in] g - wskaznik na gre,
+ * @param[in] owner - numer gracza zajmujacego jakies pole.
+ * @return wskaznik na wpis gracza.
+ */
+static player_entry_t *owner_entry(gamma_t *g, uint32_t owner) {
+    return find_entry(g, owner);
+}
+
 /**@brief sprawdza czy pole ma sasiada o tym samym numerze gracza.
  * sprawdza czy pole ma sasiada o tym samym numerze gracza.
  * @param[in] g - wskaznik na gre, w ktorej sprawdzane jest istnienie sasiada,
@@ -272,7 +671,7 @@ static bool check_if_around_same_player(gamma_t *g, uint32_t player,
 	{ (y==0 ? y : y - 1), y, (y==UINT32_MAX || y == g->height - 1) ? y : y + 1, y };
 
     for(int i = 0; i < 4; ++i) {
-        if(!(xs[i] == x && ys[i] == y) && (g->board[xs[i]][ys[i]] == player)) {
+        if(!(xs[i] == x && ys[i] == y) && (RELAXED_LOAD(g->board[xs[i]][ys[i]]) == player)) {
             return true;
         }
     }
@@ -304,21 +703,34 @@ static void connect_areas(gamma_t *g, uint32_t x, uint32_t y) {
 
 }
 
-bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
-    if(!(gamma_valid(g) && player_valid(g,player) && xy_valid(g,x,y))) {
+/**@brief wykonuje ruch, wolana pomiedzy @ref write_begin i @ref write_end.
+ * @param[in,out] g - wskaznik na gre,
+ * @param[in] player - numer gracza,
+ * @param[in] x - numer kolumny,
+ * @param[in] y - numer wiersza.
+ * @return true jesli ruch zostal wykonany, false w przeciwnym przypadku.
+ */
+static bool apply_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
+    if(!(player_valid(g,player) && xy_valid(g,x,y))) {
         return false;
     } else if(g->board[x][y] != 0) {
         return false;
     }
     else {
         bool new_area = !check_if_around_same_player(g, player, x, y);
-        if(g->players_areas[player] == g->areas && new_area == true) {
+        if(player_areas(g, player) == g->areas && new_area == true) {
+            return false;
+        }
+        player_entry_t *e = get_entry(g, player);
+        if(e == NULL) {
             return false;
         }
         else {
-            g->board[x][y] = player;
-            g->players_areas[player] += (uint64_t)new_area;
-            g->players_field_count[player]++;
+            RELAXED_STORE(g->board[x][y], player);
+            uint64_t areas = e->areas + (uint64_t)new_area;
+            RELAXED_STORE(e->field_count, e->field_count + 1);
+            RELAXED_STORE(g->busy_fields, g->busy_fields + 1);
+            field_count_changed(g, player, e->field_count - 1, e->field_count);
             if(new_area == false) {
                 uint32_t xs[] =
                         {x, (x == 0 ? x : x - 1), 
@@ -348,234 +760,715 @@ bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
                     }
                 }
                 for (int i = 0; i < 4; ++i) {
-                    if(different_area_counter[i] == 1) g->players_areas[player]--;
+                    if(different_area_counter[i] == 1) areas--;
                 }
-                g->players_areas[player]++;
+                areas++;
             }
+            RELAXED_STORE(e->areas, areas);
             connect_areas(g,x,y);
             return true;
         }
     }
 }
 
-uint64_t gamma_busy_fields(gamma_t *g, uint32_t player) {
-    if(!(gamma_valid(g) && player_valid(g,player))) {
-        return 0;
+/**@brief zapamietuje, ze pole zmienilo wlasciciela.
+ * Nic nie robi, jesli zmienione pola nie sa sledzone. Pole jest dopisywane
+ * do listy zmienionych pol tylko przy pierwszej zmianie od ostatniego
+ * @ref gamma_clear_diff. Jesli lista osiagnela limit lub nie uda sie jej
+ * powiekszyc, ustawiany jest znacznik @p dirty_overflow i dalej
+ * uaktualniana jest tylko mapa bitowa.
+ * @param[in,out] g - wskaznik na gre,
+ * @param[in] x - numer kolumny,
+ * @param[in] y - numer wiersza.
+ */
+static void mark_dirty(gamma_t *g, uint32_t x, uint32_t y) {
+    if(!g->dirty_tracking) {
+        return;
     }
-    else {
-        return g->players_field_count[player];
+    uint64_t cell = (uint64_t) x * g->height + y;
+    uint64_t bit = (uint64_t) 1 << (cell % 64);
+    if((g->dirty_bits[cell / 64] & bit) != 0) {
+        return;
     }
+    g->dirty_bits[cell / 64] |= bit;
+    if(g->dirty_overflow) {
+        return;
+    }
+    if(g->dirty_count == g->dirty_capacity) {
+        uint64_t limit = dirty_cells_limit(g->width, g->height);
+        uint64_t capacity = (g->dirty_capacity == 0) ? 16 : 2 * g->dirty_capacity;
+        if(capacity > limit) {
+            capacity = limit;
+        }
+        uint64_t *cells = (g->dirty_count == limit) ? NULL
+                          : realloc(g->dirty_cells, sizeof(uint64_t) * capacity);
+        if(cells == NULL) {
+            g->dirty_overflow = true;
+            return;
+        }
+        g->dirty_cells = cells;
+        g->dirty_capacity = capacity;
+    }
+    g->dirty_cells[g->dirty_count++] = cell;
 }
 
-bool gamma_golden_possible(gamma_t *g, uint32_t player) {
-    if(!(gamma_valid(g) && player_valid(g, player))) {
-        return false;
-    } else if(g->possible_golden_move[player] == false) {
+/**@brief wlacza sledzenie zmienionych pol.
+ * Do chwili wlaczenia zmienione sa dokladnie pola zajete, wiec po wlaczeniu
+ * wszystkie zajete pola sa zaznaczane w mapie bitowej.
+ * @param[in,out] g - wskaznik na gre.
+ * @return true jesli pola sa sledzone, false jesli nie udalo sie zaalokowac
+ * pamieci.
+ */
+static bool enable_dirty_tracking(gamma_t *g) {
+    if(g->dirty_tracking) {
+        return true;
+    }
+    g->dirty_bits = calloc(dirty_bits_words(g->width, g->height), sizeof(uint64_t));
+    if(g->dirty_bits == NULL) {
         return false;
     }
-    else {
-        for(uint32_t i = 1; i <= g->players; ++i) {
-            if(i != player && g->players_field_count[i] != 0) {
-                return true;
-            }
+    for(uint64_t cell = 0; cell < (uint64_t) g->width * g->height; ++cell) {
+        if(g->cells[cell] != 0) {
+            g->dirty_bits[cell / 64] |= (uint64_t) 1 << (cell % 64);
         }
-        return false;
     }
+    g->dirty_overflow = true;
+    g->dirty_tracking = true;
+    return true;
 }
 
-/**@brief przechodzi obszar nalezacy do jednego gracza
- * przechodzi obszar nalezacy do jednego gracza metoda dfs
- * uzywa pomocniczej tablicy @p visited
- * @param[in] g - gra w ktorej przechodzony jest obszar
- * @param[in] player - gracz, ktorego obszar jest przechodzony
- * @param[in] x - pierwszy koordynat odwiedzanego pola
- * @param[in] y - drugi koordynat odwiedzanego pola
- */
-static void DFS(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
-    if(g->visited[x][y] == false) {
-        g->visited[x][y] = true;
-        uint32_t xs[] = 
-		{ x, (x == 0 ? x : x - 1), x, 
-		((x==UINT32_MAX || x == g->width - 1) ? x : x + 1) };
-    	uint32_t ys[] = 
-		{(y == 0 ? y : y - 1), y, 
-		(y==UINT32_MAX || y == g->height - 1) ? y : y + 1, y };
-        for(int i = 0; i < 4; ++i){
-            if(g->visited[xs[i]][ys[i]] == false && g->board[xs[i]][ys[i]] == player) {
-                DFS(g,player,xs[i],ys[i]);
-            }
+/**@brief miesza liczbe 64-bitowa (splitmix64).
+ * @param[in] x - mieszana liczba.
+ * @return skrot liczby.
+ */
+static uint64_t hash_mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15u;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9u;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBu;
+    return x ^ (x >> 31);
+}
+
+/**@brief podaje ilosc symetrii planszy.
+ * @param[in] g - wskaznik na gre.
+ * @return 8 dla planszy kwadratowej, 4 w przeciwnym przypadku.
+ */
+static uint32_t symmetry_count(gamma_t *g) {
+    return (g->width == g->height) ? GAMMA_SYMMETRIES : GAMMA_SYMMETRIES / 2;
+}
+
+/**@brief przeksztalca wspolrzedne pola.
+ * @param[in] g - wskaznik na gre,
+ * @param[in] transform - numer przeksztalcenia,
+ * @param[in] x - numer kolumny,
+ * @param[in] y - numer wiersza,
+ * @param[out] tx - numer kolumny obrazu pola,
+ * @param[out] ty - numer wiersza obrazu pola.
+ */
+static void transform_field(gamma_t *g, uint32_t transform, uint32_t x, uint32_t y,
+                            uint32_t *tx, uint32_t *ty) {
+    if(transform & TRANSFORM_MIRROR_X) x = g->width - 1 - x;
+    if(transform & TRANSFORM_MIRROR_Y) y = g->height - 1 - y;
+    *tx = (transform & TRANSFORM_TRANSPOSE) ? y : x;
+    *ty = (transform & TRANSFORM_TRANSPOSE) ? x : y;
+}
+
+/**@brief uaktualnia skroty planszy po zmianie wlasciciela pola.
+ * @param[in,out] g - wskaznik na gre,
+ * @param[in] x - numer kolumny,
+ * @param[in] y - numer wiersza,
+ * @param[in] old_owner - poprzedni wlasciciel pola lub 0,
+ * @param[in] new_owner - nowy wlasciciel pola.
+ */
+static void symmetry_hash_update(gamma_t *g, uint32_t x, uint32_t y,
+                                 uint32_t old_owner, uint32_t new_owner) {
+    for(uint32_t t = 0; t < symmetry_count(g); ++t) {
+        uint32_t tx, ty;
+        transform_field(g, t, x, y, &tx, &ty);
+        uint64_t cell = hash_mix((uint64_t) tx * g->height + ty);
+        uint64_t hash = g->symmetry_hash[t] ^ hash_mix(cell + new_owner);
+        if(old_owner != 0) {
+            hash ^= hash_mix(cell + old_owner);
         }
+        RELAXED_STORE(g->symmetry_hash[t], hash);
     }
 }
 
-/** @brief Sprawdza czy mozna wykonac złoty ruch.
- * Sprawdza czy mozna wykonac zloty ruch na polu @p x @p y
- * @param[in] g   – wskaźnik na strukturę przechowującą stan gry,
- * @param[in] player  – numer gracza,
- * @param[in] x       – numer kolumny,
- * @param[in] y       – numer wiersza.
- * @return Wartość @p true, jeśli ruch moze zostac wykonany, a @p false,
- * w przeciwnym przypadku.
+/**@brief powiadamia subskrybentow o zmianie pola.
+ * @param[in,out] g - wskaznik na gre,
+ * @param[in] kind - rodzaj ruchu,
+ * @param[in] x - numer kolumny,
+ * @param[in] y - numer wiersza,
+ * @param[in] old_owner - poprzedni wlasciciel pola.
  */
-static bool check_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
-    if(g->board[x][y] == 0 || g->board[x][y] == player 
-	|| g->possible_golden_move[player] == false) {
-        return false;
-    } else
-    {
-        bool new_area = !check_if_around_same_player(g, player, x, y);
-        if(new_area == true && g->players_areas[player] == g->areas) {
-            return false;
-        } else {
-            uint32_t prev_player = g->board[x][y];
-            g->board[x][y] = player;
-            clear_visited(g, g->width, g->height);
-            uint32_t xs[] = { x, (x==0 ? x : x - 1), 
-			     x, ((x==UINT32_MAX || x == g->width - 1) ? x : x + 1) };
-            uint32_t ys[] = { (y==0 ? y : y-1), y, 
-			     (y==UINT32_MAX || y == g->height - 1) ? y : y + 1, y};
-            uint64_t different_area_counter[] = { 0, 0, 0, 0 };
-            for(int i = 0; i < 4; ++i) {
-                if(!(x==xs[i] && y==ys[i])  && g->board[xs[i]][ys[i]]!=0) {
-                    bool flag = true;
-                    pair_set_value(g->a,xs[i],ys[i]);
-                    for(int j = i+1; j < 4; ++j) {
-                        if(!(x==xs[j] && y==ys[j])  && g->board[xs[j]][ys[j]]!=0) {
-                            pair_set_value(g->b,xs[j], ys[j]);
-
-                            if (are_equal(find(g->f, g->a),  find(g->f, g->b))) {
-                                flag = false;
-                            }
-                        }
-                    }
-                    if(flag) {
-                        different_area_counter[i]++;
-                    }
-                }
-            }
-            for(int i = 0; i < 4; ++i) {
-                if(!(x==xs[i] && y==ys[i]) &&
-                   (g->board[xs[i]][ys[i]] == player || 
-		    g->board[xs[i]][ys[i]] == prev_player)) {
-
-                    if(g->visited[xs[i]][ys[i]] == false  && g->board[xs[i]][ys[i]]!=0) {
+static void notify_change(gamma_t *g, uint8_t kind, uint32_t x, uint32_t y,
+                          uint32_t old_owner) {
+    gamma_change_t change;
+    change.seq = ++g->changes;
+    if(g->subscriber_count == 0) {
+        return;
+    }
+    change.kind = kind;
+    change.x = x;
+    change.y = y;
+    change.old_owner = old_owner;
+    change.new_owner = g->board[x][y];
+    change.old_owner_areas = (old_owner == 0) ? 0 : player_areas(g, old_owner);
+    change.new_owner_areas = player_areas(g, change.new_owner);
+    for(uint32_t i = 0; i < g->subscriber_count; ++i) {
+        g->subscribers[i].fn(g->subscribers[i].ctx, &change);
+    }
+}
 
-                        DFS(g,g->board[xs[i]][ys[i]],xs[i],ys[i]);
-                        different_area_counter[i]--;
-                    }
-                }
-            }
-            g->board[x][y] = prev_player;
-            bool is_possible = true;
-            for(int i = 0; i<4; ++i) {
-                if(!(x==xs[i] && y==ys[i]) &&
-                   (g->board[xs[i]][ys[i]] == player || 
-		    g->board[xs[i]][ys[i]] == prev_player)) {
+static bool evaluate_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y,
+                          gamma_move_delta_t *delta);
+static bool evaluate_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y,
+                                 gamma_move_delta_t *delta);
 
-                    g->players_areas[g->board[xs[i]][ys[i]]] -= different_area_counter[i];
-                }
-            }
-            for(int i = 0; i<4; ++i) {
-                if(!(x==xs[i] && y==ys[i]) &&
-                   (g->board[xs[i]][ys[i]] == player || 
-		    g->board[xs[i]][ys[i]] == prev_player)) {
+/**@brief dopisuje ruch do dziennika gry, zanim zostanie wykonany.
+ * Do dziennika trafiaja tylko legalne ruchy, a ruch jest wykonywany dopiero
+ * po przyjeciu wpisu, wiec odtworzenie dziennika nie pominie zadnego
+ * wykonanego ruchu. Wolana poza @ref write_begin i @ref write_end, zeby
+ * czytelnicy nie czekali na zapis na dysk.
+ * @param[in,out] g - wskaznik na gre,
+ * @param[in] kind - @ref MOVE_LOG_MOVE lub @ref MOVE_LOG_GOLDEN_MOVE,
+ * @param[in] player - numer gracza,
+ * @param[in] x - numer kolumny,
+ * @param[in] y - numer wiersza.
+ * @return true jesli gra nie ma dziennika lub ruch jest legalny i zostal
+ * dopisany, false w przeciwnym przypadku.
+ */
+static bool log_move(gamma_t *g, uint8_t kind, uint32_t player,
+                     uint32_t x, uint32_t y) {
+    if(g->log == NULL) {
+        return true;
+    }
+    bool legal = (kind == MOVE_LOG_MOVE) ? evaluate_move(g, player, x, y, NULL)
+                 : evaluate_golden_move(g, player, x, y, NULL);
+    return legal && move_log_append(g->log, kind, player, x, y);
+}
 
-                    is_possible &= (g->players_areas[g->board[xs[i]][ys[i]]] <= g->areas);
-                }
-            }
-            for(int i = 0; i<4; ++i) {
-                if(!(x==xs[i] && y==ys[i]) &&
-                   (g->board[xs[i]][ys[i]] == player || 
-		    g->board[xs[i]][ys[i]] == prev_player)) {
+bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
+    if(!gamma_valid(g) || !log_move(g, MOVE_LOG_MOVE, player, x, y)) {
+        return false;
+    }
+    write_begin(g);
+    bool moved = apply_move(g, player, x, y);
+    if(moved) {
+        symmetry_hash_update(g, x, y, 0, player);
+    }
+    write_end(g);
+    if(moved) {
+        mark_dirty(g, x, y);
+        notify_change(g, MOVE_LOG_MOVE, x, y, 0);
+    }
+    return moved;
+}
 
-                    g->players_areas[g->board[xs[i]][ys[i]]] += different_area_counter[i];
-                }
-            }
-            return is_possible;
-        }
+/**@brief sprowadza do pamieci podrecznej pola planszy potrzebne do ruchu.
+ * Nieprawidlowe ruchy sa pomijane.
+ * @param[in] g - wskaznik na gre,
+ * @param[in] move - ruch.
+ */
+static void prefetch_board(gamma_t *g, const gamma_batch_move_t *move) {
+    uint32_t x = move->x, y = move->y;
+    if(!xy_valid(g, x, y)) {
+        return;
+    }
+    __builtin_prefetch(&g->board[x][y], 1);
+    if(x > 0) {
+        __builtin_prefetch(&g->board[x - 1][y]);
+    }
+    if(x + 1 < g->width) {
+        __builtin_prefetch(&g->board[x + 1][y]);
     }
 }
 
-/**@brief przechodzi obszar nalezacy do jednego gracza i usuwa kazdemu rodzica w drzewie find and union.
- * przechodzi obszar nalezacy do jednego gracza metoda dfs
- * uzywa pomocniczej tablicy @p visited
- * i usuwa kazdemu rodzica w drzewie find and union.
- * @param[in,out] g - gra w ktorej przechodzony jest obszar,
- * @param[in] player - gracz, ktorego obszar jest przechodzony,
- * @param[in] x - pierwszy koordynat odwiedzanego pola,
- * @param[in] y - drugi koordynat odwiedzanego pola.
+/**@brief sprowadza do pamieci podrecznej wpis pola w drzewie find and union.
+ * Pomija ruchy na zajete pola, ktore zostana odrzucone bez zagladania do
+ * drzewa. Pole planszy powinno juz byc w pamieci podrecznej dzieki
+ * @ref prefetch_board.
+ * @param[in] g - wskaznik na gre,
+ * @param[in] move - ruch.
  */
-static void DFS_clear_parent(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
-    if(g->visited[x][y] == false) {
-        set_default_parent(g->f,x,y);
-        g->visited[x][y] = true;
-        uint32_t xs[] = { x, (x == 0 ? x : x - 1), x, 
-			 ((x == UINT32_MAX || x == g->width - 1) ? x : x + 1) };
-        uint32_t ys[] = {( y== 0 ? y : y-1), y,
-			 (y == UINT32_MAX || y == g->height - 1) ? y : y + 1, y };
-        for(int i = 0; i < 4; ++i) {
-            if(g->visited[xs[i]][ys[i]] == false && g->board[xs[i]][ys[i]] == player) {
-                DFS_clear_parent(g, player, xs[i], ys[i]);
-            }
-        }
+static void prefetch_fau(gamma_t *g, const gamma_batch_move_t *move) {
+    if(xy_valid(g, move->x, move->y) && g->board[move->x][move->y] == 0) {
+        fau_prefetch(g->f, move->x, move->y);
     }
 }
 
-/**@brief przechodzi obszar nalezacy do jednego gracza i 
- * usuwa kazdemu rodzica w drzewie find and union.
- * przechodzi obszar nalezacy do jednego gracza metoda dfs
- * uzywa pomocniczej tablicy @p visited
- * i ustawia kazdemu rodzica w drzewie find and union na
- * @p parentx @p parenty
- *
- * @param[in,out] g - gra w ktorej przechodzony jest obszar
- * @param[in] player - gracz, ktorego obszar jest przechodzony
- * @param[in] x - pierwszy koordynat odwiedzanego pola
- * @param[in] y - drugi koordynat odwiedzanego pola
- * @param[in] parentx - pierwszy koordynat pola ojca
- * @param[in] parenty - drugi koordynat pola ojca
- */
-static void DFS_set_parent(gamma_t *g, uint32_t player, uint32_t x, uint32_t y,
-                                                uint32_t parentx, uint32_t parenty) {
-    if(g->visited[x][y] == false) {
-        g->visited[x][y] = true;
-        uint32_t xs[] =
-                { x, (x == 0 ? x : x-1), x, 
-		  ((x == UINT32_MAX || x == g->width - 1) ? x : x + 1)};
-        uint32_t ys[] =
-                { (y == 0 ? y : y - 1), y, 
-		  (y == UINT32_MAX || y == g->height - 1) ? y : y + 1, y};
-        for(int i = 0; i < 4; ++i) {
-            if(g->visited[xs[i]][ys[i]] == false && g->board[xs[i]][ys[i]] == player) {
-                pair_set_value(g->a,x,y);
-                pair_set_value(g->b,xs[i],ys[i]);
-                unite(g->f,g->a,g->b);
-                DFS_set_parent(g, player, xs[i], ys[i], parentx, parenty);
+uint64_t gamma_move_batch(gamma_t *g, const gamma_batch_move_t *moves, uint64_t n,
+                          bool *results) {
+    if(!gamma_valid(g) || (moves == NULL && n > 0)) {
+        return 0;
+    }
+    uint64_t moved_count = 0;
+    for(uint64_t i = 0; i < 2 * BATCH_PREFETCH_DISTANCE && i < n; ++i) {
+        prefetch_board(g, &moves[i]);
+    }
+    for(uint64_t start = 0; start < n; start += BATCH_WRITE_GROUP) {
+        uint64_t end = (n - start < BATCH_WRITE_GROUP) ? n : start + BATCH_WRITE_GROUP;
+        bool grouped = (g->subscriber_count == 0 && g->log == NULL);
+        if(grouped) {
+            write_begin(g);
+        }
+        for(uint64_t i = start; i < end; ++i) {
+            if(i + 2 * BATCH_PREFETCH_DISTANCE < n) {
+                prefetch_board(g, &moves[i + 2 * BATCH_PREFETCH_DISTANCE]);
+            }
+            if(i + BATCH_PREFETCH_DISTANCE < n) {
+                prefetch_fau(g, &moves[i + BATCH_PREFETCH_DISTANCE]);
+            }
+            uint32_t player = moves[i].player, x = moves[i].x, y = moves[i].y;
+            bool moved = grouped || log_move(g, MOVE_LOG_MOVE, player, x, y);
+            if(!grouped) {
+                write_begin(g);
+            }
+            moved = moved && apply_move(g, player, x, y);
+            if(moved) {
+                symmetry_hash_update(g, x, y, 0, player);
             }
+            if(!grouped) {
+                write_end(g);
+            }
+            if(moved) {
+                mark_dirty(g, x, y);
+                notify_change(g, MOVE_LOG_MOVE, x, y, 0);
+                moved_count++;
+            }
+            if(results != NULL) {
+                results[i] = moved;
+            }
+        }
+        if(grouped) {
+            write_end(g);
         }
     }
+    return moved_count;
 }
 
-bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
-    if(!(gamma_valid(g) && player_valid(g,player) && xy_valid(g,x,y))) {
+uint64_t gamma_busy_fields(gamma_t *g, uint32_t player) {
+    if(!(gamma_valid(g) && player_valid(g,player))) {
+        return 0;
+    }
+    else {
+        uint64_t seq, fields;
+        do {
+            seq = read_begin(g);
+            fields = player_field_count(g, player);
+        } while(read_retry(g, seq));
+        return fields;
+    }
+}
+
+bool gamma_golden_possible(gamma_t *g, uint32_t player) {
+    if(!(gamma_valid(g) && player_valid(g, player))) {
         return false;
     }
-    else if(check_golden_move(g,player,x,y)) {
-        g->possible_golden_move[player] = false;
-        uint32_t prev_player = g->board[x][y];
-        g->players_field_count[prev_player]--;
-        if(check_if_around_same_player(g,prev_player,x,y) == false) {
-            g->players_areas[prev_player]--;
-        }
-        g->players_field_count[player]++;
-        g->board[x][y] = player;
-        if(check_if_around_same_player(g,player,x,y) == false) {
-            g->players_areas[player]++;
-        }
+    uint64_t seq;
+    bool possible;
+    do {
+        seq = read_begin(g);
+        possible = !golden_move_used(g, player)
+                   && RELAXED_LOAD(g->active_players) > (player_field_count(g, player) != 0);
+    } while(read_retry(g, seq));
+    return possible;
+}
 
-        uint32_t xs[] = { x, (x == 0 ? x : x - 1), x, 
-                         ((x == UINT32_MAX || x == g->width - 1) ? x : x + 1)};
-        uint32_t ys[] = {(y == 0 ? y : y - 1), y, 
+/**@brief podaje sasiadow pola lezacych na planszy.
+ * @param[in] g - wskaznik na gre,
+ * @param[in] x - numer kolumny pola,
+ * @param[in] y - numer wiersza pola,
+ * @param[out] xs - numery kolumn sasiadow,
+ * @param[out] ys - numery wierszy sasiadow.
+ * @return ilosc sasiadow, od 0 do 4.
+ */
+static int neighbours(gamma_t *g, uint32_t x, uint32_t y, uint32_t xs[4], uint32_t ys[4]) {
+    int count = 0;
+    if(x > 0) {
+        xs[count] = x - 1;
+        ys[count++] = y;
+    }
+    if(x + 1 < g->width) {
+        xs[count] = x + 1;
+        ys[count++] = y;
+    }
+    if(y > 0) {
+        xs[count] = x;
+        ys[count++] = y - 1;
+    }
+    if(y + 1 < g->height) {
+        xs[count] = x;
+        ys[count++] = y + 1;
+    }
+    return count;
+}
+
+/**@brief sprawdza, czy pole bylo odwiedzone w biezacym przeszukiwaniu.
+ * @param[in] g - wskaznik na gre,
+ * @param[in] x - numer kolumny pola,
+ * @param[in] y - numer wiersza pola.
+ * @return true jesli pole bylo odwiedzone, false w przeciwnym przypadku.
+ */
+static bool is_visited(gamma_t *g, uint32_t x, uint32_t y) {
+    return g->visited[(uint64_t) x * g->height + y] == g->visit_epoch;
+}
+
+/**@brief oznacza pole jako odwiedzone w biezacym przeszukiwaniu.
+ * @param[in,out] g - wskaznik na gre,
+ * @param[in] x - numer kolumny pola,
+ * @param[in] y - numer wiersza pola.
+ */
+static void set_visited(gamma_t *g, uint32_t x, uint32_t y) {
+    g->visited[(uint64_t) x * g->height + y] = g->visit_epoch;
+    EVENT_ADD(dfs_cells, 1);
+}
+
+/**@brief zapewnia istnienie stosu przeszukiwania obszaru.
+ * Stos miesci wszystkie pola planszy, bo kazde pole jest na niego
+ * wkladane najwyzej raz w jednym przeszukiwaniu.
+ * @param[in,out] g - wskaznik na gre.
+ * @return true jesli stos istnieje, false jesli nie udalo sie zaalokowac
+ * pamieci.
+ */
+static bool reserve_walk_stack(gamma_t *g) {
+    if(g->walk_stack == NULL) {
+        g->walk_stack = malloc(sizeof(uint64_t) * (uint64_t) g->width * g->height);
+    }
+    return g->walk_stack != NULL;
+}
+
+#define WALK_CLEAR_PARENT 0 ///< przeszukiwanie ustawia polom domyslnego ojca
+#define WALK_SET_PARENT 1 /**< przeszukiwanie laczy kazde pole z polem,
+                            * z ktorego do niego doszlo **/
+
+/**@brief przechodzi obszar nalezacy do jednego gracza.
+ * Przechodzi obszar iteracyjnie, uzywajac stosu @p walk_stack i znacznikow
+ * @p visited, i dla kazdego pola obszaru ustawia domyslnego ojca w drzewie
+ * find and union albo laczy je z polem, z ktorego do niego doszlo.
+ * Nic nie robi, jesli pole poczatkowe bylo juz odwiedzone.
+ * @param[in,out] g - gra w ktorej przechodzony jest obszar,
+ * @param[in] player - gracz, ktorego obszar jest przechodzony,
+ * @param[in] x - pierwszy koordynat pola poczatkowego,
+ * @param[in] y - drugi koordynat pola poczatkowego,
+ * @param[in] action - @ref WALK_CLEAR_PARENT lub @ref WALK_SET_PARENT.
+ */
+static void walk_area(gamma_t *g, uint32_t player, uint32_t x, uint32_t y, int action) {
+    if(is_visited(g, x, y)) {
+        return;
+    }
+    uint64_t top = 0;
+    set_visited(g, x, y);
+    g->walk_stack[top++] = (uint64_t) x * g->height + y;
+    while(top > 0) {
+        uint64_t cell = g->walk_stack[--top];
+        uint32_t cx = (uint32_t) (cell / g->height);
+        uint32_t cy = (uint32_t) (cell % g->height);
+        if(action == WALK_CLEAR_PARENT) {
+            set_default_parent(g->f, cx, cy);
+        }
+        uint32_t xs[4], ys[4];
+        int n = neighbours(g, cx, cy, xs, ys);
+        for(int i = 0; i < n; ++i) {
+            if(!is_visited(g, xs[i], ys[i]) && g->board[xs[i]][ys[i]] == player) {
+                set_visited(g, xs[i], ys[i]);
+                if(action == WALK_SET_PARENT) {
+                    pair_set_value(g->a, cx, cy);
+                    pair_set_value(g->b, xs[i], ys[i]);
+                    unite(g->f, g->a, g->b);
+                }
+                g->walk_stack[top++] = (uint64_t) xs[i] * g->height + ys[i];
+            }
+        }
+    }
+}
+
+/**@brief liczy rozne obszary gracza wsrod sasiadow pola.
+ * Korzenie drzewa find and union sa szukane bez kompresji sciezek,
+ * wiec gra nie jest zmieniana.
+ * @param[in] g - wskaznik na gre,
+ * @param[in] player - numer gracza,
+ * @param[in] x - numer kolumny pola,
+ * @param[in] y - numer wiersza pola.
+ * @return ilosc roznych obszarow gracza sasiadujacych z polem, od 0 do 4.
+ */
+static uint32_t neighbour_areas(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
+    uint32_t xs[4], ys[4], roots_x[4], roots_y[4];
+    int n = neighbours(g, x, y, xs, ys);
+    uint32_t count = 0;
+    for(int i = 0; i < n; ++i) {
+        if(g->board[xs[i]][ys[i]] != player) {
+            continue;
+        }
+        uint32_t root_x, root_y;
+        fau_root(g->f, xs[i], ys[i], &root_x, &root_y);
+        bool seen = false;
+        for(uint32_t j = 0; j < count; ++j) {
+            seen |= (roots_x[j] == root_x && roots_y[j] == root_y);
+        }
+        if(!seen) {
+            roots_x[count] = root_x;
+            roots_y[count++] = root_y;
+        }
+    }
+    return count;
+}
+
+/**@brief liczy obszary, na ktore rozpadlby sie obszar po zwolnieniu pola.
+ * Przechodzi obszar wlasciciela pola od kolejnych jego sasiadow, omijajac
+ * pole, i konczy przeszukiwanie, gdy odwiedzi wszystkich sasiadow.
+ * Wymaga stosu @p walk_stack.
+ * @param[in,out] g - wskaznik na gre, zmieniane sa tylko znaczniki
+ * odwiedzenia,
+ * @param[in] x - numer kolumny zajetego pola,
+ * @param[in] y - numer wiersza zajetego pola.
+ * @return ilosc obszarow sasiadujacych z polem po jego zwolnieniu, 0 jesli
+ * zaden sasiad nie nalezy do wlasciciela pola.
+ */
+static uint32_t split_areas(gamma_t *g, uint32_t x, uint32_t y) {
+    uint32_t owner = g->board[x][y];
+    uint32_t xs[4], ys[4];
+    int n = neighbours(g, x, y, xs, ys);
+    int remaining = 0;
+    for(int i = 0; i < n; ++i) {
+        if(g->board[xs[i]][ys[i]] == owner) {
+            xs[remaining] = xs[i];
+            ys[remaining++] = ys[i];
+        }
+    }
+    if(remaining <= 1) {
+        return (uint32_t) remaining;
+    }
+    clear_visited(g);
+    set_visited(g, x, y);
+    uint32_t areas = 0;
+    for(int i = 0; i < n && remaining > 0; ++i) {
+        if(is_visited(g, xs[i], ys[i])) {
+            continue;
+        }
+        areas++;
+        uint64_t top = 0;
+        set_visited(g, xs[i], ys[i]);
+        remaining--;
+        g->walk_stack[top++] = (uint64_t) xs[i] * g->height + ys[i];
+        while(top > 0 && remaining > 0) {
+            uint64_t cell = g->walk_stack[--top];
+            uint32_t nxs[4], nys[4];
+            int m = neighbours(g, (uint32_t) (cell / g->height),
+                               (uint32_t) (cell % g->height), nxs, nys);
+            for(int j = 0; j < m; ++j) {
+                if(!is_visited(g, nxs[j], nys[j]) && g->board[nxs[j]][nys[j]] == owner) {
+                    set_visited(g, nxs[j], nys[j]);
+                    if((nxs[j] == x && (nys[j] + 1 == y || nys[j] == y + 1))
+                       || (nys[j] == y && (nxs[j] + 1 == x || nxs[j] == x + 1))) {
+                        remaining--;
+                    }
+                    g->walk_stack[top++] = (uint64_t) nxs[j] * g->height + nys[j];
+                }
+            }
+        }
+    }
+    return areas;
+}
+
+/**@brief sprawdza, czy pole byloby wolne i sasiadowalo z polem gracza.
+ * @param[in] g - wskaznik na gre,
+ * @param[in] player - numer gracza,
+ * @param[in] cx - numer kolumny sprawdzanego pola,
+ * @param[in] cy - numer wiersza sprawdzanego pola,
+ * @param[in] x - numer kolumny pola o zmienionym wlascicielu,
+ * @param[in] y - numer wiersza pola o zmienionym wlascicielu,
+ * @param[in] owner - wlasciciel pola (@p x, @p y).
+ * @return true jesli pole (@p cx, @p cy) jest wolne i sasiaduje z polem
+ * gracza, gdy pole (@p x, @p y) nalezy do @p owner.
+ */
+static bool free_adjacent(gamma_t *g, uint32_t player, uint32_t cx, uint32_t cy,
+                          uint32_t x, uint32_t y, uint32_t owner) {
+    if(((cx == x && cy == y) ? owner : g->board[cx][cy]) != 0) {
+        return false;
+    }
+    uint32_t xs[4], ys[4];
+    int n = neighbours(g, cx, cy, xs, ys);
+    for(int i = 0; i < n; ++i) {
+        if(((xs[i] == x && ys[i] == y) ? owner : g->board[xs[i]][ys[i]]) == player) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**@brief liczy wolne pola sasiadujace z polami gracza po zmianie pola.
+ * @param[in] g - wskaznik na gre,
+ * @param[in] player - numer gracza,
+ * @param[in] x - numer kolumny pola o zmienionym wlascicielu,
+ * @param[in] y - numer wiersza pola o zmienionym wlascicielu,
+ * @param[in] owner - wlasciciel pola (@p x, @p y).
+ * @return ilosc wolnych pol sasiadujacych z polami gracza.
+ */
+static uint64_t count_free_adjacent(gamma_t *g, uint32_t player,
+                                    uint32_t x, uint32_t y, uint32_t owner) {
+    uint64_t count = 0;
+    for(uint32_t cx = 0; cx < g->width; ++cx) {
+        for(uint32_t cy = 0; cy < g->height; ++cy) {
+            count += free_adjacent(g, player, cx, cy, x, y, owner);
+        }
+    }
+    return count;
+}
+
+/**@brief liczy zmiane wyniku @ref gamma_free_fields gracza po zmianie pola.
+ * Jesli gracz przed zmiana i po niej ma najwiecej obszarow, wystarczy
+ * sprawdzic pole i jego sasiadow. Jesli liczba obszarow gracza przekracza
+ * przy zmianie granice, trzeba przejrzec cala plansze.
+ * @param[in] g - wskaznik na gre,
+ * @param[in] player - numer gracza,
+ * @param[in] areas_after - ilosc obszarow gracza po zmianie,
+ * @param[in] x - numer kolumny zmienianego pola,
+ * @param[in] y - numer wiersza zmienianego pola,
+ * @param[in] owner - wlasciciel pola po zmianie,
+ * @param[in] empty_change - zmiana ilosci wolnych pol planszy.
+ * @return zmiana wyniku @ref gamma_free_fields gracza.
+ */
+static int64_t free_fields_change(gamma_t *g, uint32_t player, uint64_t areas_after,
+                                  uint32_t x, uint32_t y, uint32_t owner,
+                                  int64_t empty_change) {
+    uint32_t old_owner = g->board[x][y];
+    bool below_before = player_areas(g, player) < g->areas;
+    bool below_after = areas_after < g->areas;
+    if(below_before && below_after) {
+        return empty_change;
+    }
+    if(!below_before && !below_after) {
+        uint32_t xs[5], ys[5];
+        int n = neighbours(g, x, y, xs, ys);
+        xs[n] = x;
+        ys[n++] = y;
+        int64_t change = 0;
+        for(int i = 0; i < n; ++i) {
+            change += free_adjacent(g, player, xs[i], ys[i], x, y, owner);
+            change -= free_adjacent(g, player, xs[i], ys[i], x, y, old_owner);
+        }
+        return change;
+    }
+    int64_t empty = (int64_t) ((uint64_t) g->width * g->height - g->busy_fields);
+    int64_t before = below_before ? empty
+                     : (int64_t) count_free_adjacent(g, player, x, y, old_owner);
+    int64_t after = below_after ? empty + empty_change
+                    : (int64_t) count_free_adjacent(g, player, x, y, owner);
+    return after - before;
+}
+
+/**@brief ocenia ruch bez wykonywania go.
+ * @param[in] g - wskaznik na gre,
+ * @param[in] player - numer gracza,
+ * @param[in] x - numer kolumny,
+ * @param[in] y - numer wiersza,
+ * @param[out] delta - zmiany stanu gry po ruchu lub NULL.
+ * @return true jesli ruch jest legalny, false w przeciwnym przypadku.
+ */
+static bool evaluate_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y,
+                          gamma_move_delta_t *delta) {
+    if(!(player_valid(g, player) && xy_valid(g, x, y)) || g->board[x][y] != 0) {
+        return false;
+    }
+    uint32_t joined = neighbour_areas(g, player, x, y);
+    uint64_t areas = player_areas(g, player);
+    if(joined == 0 && areas == g->areas) {
+        return false;
+    }
+    if(delta != NULL) {
+        delta->old_owner = 0;
+        delta->areas = 1 - (int64_t) joined;
+        delta->fields = 1;
+        delta->free_fields = free_fields_change(g, player, areas + 1 - joined,
+                                                x, y, player, -1);
+        delta->old_owner_areas = 0;
+        delta->old_owner_fields = 0;
+        delta->old_owner_free_fields = 0;
+    }
+    return true;
+}
+
+/** @brief Ocenia zloty ruch bez wykonywania go.
+ * Zloty ruch jest legalny, jesli pole nalezy do innego gracza, gracz nie
+ * wykonal jeszcze zlotego ruchu, nie przekroczy limitu obszarow, a obszar
+ * poprzedniego wlasciciela pola nie rozpadnie sie na tyle czesci, ze
+ * przekroczy on limit obszarow. Zmienia tylko znaczniki odwiedzenia pol.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza,
+ * @param[in] x       – numer kolumny,
+ * @param[in] y       – numer wiersza,
+ * @param[out] delta  – zmiany stanu gry po ruchu lub NULL.
+ * @return Wartość @p true, jeśli ruch moze zostac wykonany, a @p false,
+ * w przeciwnym przypadku lub jesli nie udalo sie zaalokowac pamieci.
+ */
+static bool evaluate_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y,
+                                 gamma_move_delta_t *delta) {
+    if(!(player_valid(g, player) && xy_valid(g, x, y))) {
+        return false;
+    }
+    uint32_t old_owner = g->board[x][y];
+    if(old_owner == 0 || old_owner == player || golden_move_used(g, player)
+       || !reserve_walk_stack(g)) {
+        return false;
+    }
+    uint32_t joined = neighbour_areas(g, player, x, y);
+    uint64_t areas = player_areas(g, player);
+    if(joined == 0 && areas == g->areas) {
+        return false;
+    }
+    uint64_t old_areas = player_areas(g, old_owner);
+    uint64_t old_areas_after = old_areas - 1 + split_areas(g, x, y);
+    if(old_areas_after > g->areas) {
+        return false;
+    }
+    if(delta != NULL) {
+        delta->old_owner = old_owner;
+        delta->areas = 1 - (int64_t) joined;
+        delta->fields = 1;
+        delta->free_fields = free_fields_change(g, player, areas + 1 - joined,
+                                                x, y, player, 0);
+        delta->old_owner_areas = (int64_t) old_areas_after - (int64_t) old_areas;
+        delta->old_owner_fields = -1;
+        delta->old_owner_free_fields = free_fields_change(g, old_owner, old_areas_after,
+                                                          x, y, player, 0);
+    }
+    return true;
+}
+
+/**@brief wykonuje zloty ruch, wolana pomiedzy @ref write_begin i @ref write_end.
+ * @param[in,out] g - wskaznik na gre,
+ * @param[in] player - numer gracza,
+ * @param[in] x - numer kolumny,
+ * @param[in] y - numer wiersza.
+ * @return true jesli ruch zostal wykonany, false w przeciwnym przypadku.
+ */
+static bool apply_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
+    if(!(player_valid(g,player) && xy_valid(g,x,y))) {
+        return false;
+    }
+    else if(evaluate_golden_move(g, player, x, y, NULL)) {
+        player_entry_t *e = get_entry(g, player);
+        if(e == NULL) {
+            return false;
+        }
+        RELAXED_STORE(e->golden_move_used, true);
+        uint32_t prev_player = g->board[x][y];
+        player_entry_t *prev = owner_entry(g, prev_player);
+        RELAXED_STORE(prev->field_count, prev->field_count - 1);
+        field_count_changed(g, prev_player, prev->field_count + 1, prev->field_count);
+        if(check_if_around_same_player(g,prev_player,x,y) == false) {
+            RELAXED_STORE(prev->areas, prev->areas - 1);
+        }
+        RELAXED_STORE(e->field_count, e->field_count + 1);
+        field_count_changed(g, player, e->field_count - 1, e->field_count);
+        RELAXED_STORE(g->board[x][y], player);
+        if(check_if_around_same_player(g,player,x,y) == false) {
+            RELAXED_STORE(e->areas, e->areas + 1);
+        }
+
+        uint32_t xs[] = { x, (x == 0 ? x : x - 1), x, 
+                         ((x == UINT32_MAX || x == g->width - 1) ? x : x + 1)};
+        uint32_t ys[] = {(y == 0 ? y : y - 1), y, 
                          (y == UINT32_MAX || y == g->height - 1) ? y : y + 1, y};
         uint64_t different_area_counter[] = {0, 0, 0, 0};
         for(int i = 0; i < 4; ++i) {
@@ -597,26 +1490,23 @@ bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
         }
         set_default_parent(g->f,x,y);
 
-        clear_visited(g, g->width, g->height);
+        clear_visited(g);
         for(int i = 0; i < 4; ++i) {
             if(!(x==xs[i] && y==ys[i]) &&
                    (g->board[xs[i]][ys[i]] == player || 
 		    g->board[xs[i]][ys[i]] == prev_player)) {
 
-                if(g->visited[xs[i]][ys[i]] == false) {
-                    DFS_clear_parent(g,g->board[xs[i]][ys[i]],xs[i],ys[i]);
-                }
+                walk_area(g, g->board[xs[i]][ys[i]], xs[i], ys[i], WALK_CLEAR_PARENT);
             }
         }
-        clear_visited(g, g->width, g->height);
+        clear_visited(g);
         for(int i = 0; i < 4; ++i) {
             if(!(x==xs[i] && y==ys[i]) &&
                    (g->board[xs[i]][ys[i]] == player || 
 		    g->board[xs[i]][ys[i]] == prev_player)) {
 
-                if(g->visited[xs[i]][ys[i]] == false) {
-
-                    DFS_set_parent(g,g->board[xs[i]][ys[i]],xs[i],ys[i],xs[i],ys[i]);
+                if(!is_visited(g, xs[i], ys[i])) {
+                    walk_area(g, g->board[xs[i]][ys[i]], xs[i], ys[i], WALK_SET_PARENT);
                     different_area_counter[i]--;
                 }
             }
@@ -627,7 +1517,8 @@ bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
                    (g->board[xs[i]][ys[i]] == player || 
 		    g->board[xs[i]][ys[i]] == prev_player)) {
 
-                g->players_areas[g->board[xs[i]][ys[i]]] -= different_area_counter[i];
+                player_entry_t *owner = owner_entry(g, g->board[xs[i]][ys[i]]);
+                RELAXED_STORE(owner->areas, owner->areas - different_area_counter[i]);
             }
         }
         return true;
@@ -637,31 +1528,117 @@ bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
     }
 }
 
+bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
+    if(!gamma_valid(g) || !log_move(g, MOVE_LOG_GOLDEN_MOVE, player, x, y)) {
+        return false;
+    }
+    uint32_t old_owner = xy_valid(g, x, y) ? g->board[x][y] : 0;
+    write_begin(g);
+    bool moved = apply_golden_move(g, player, x, y);
+    if(moved) {
+        symmetry_hash_update(g, x, y, old_owner, player);
+        RELAXED_STORE(g->golden_hash,
+                      g->golden_hash ^ hash_mix(((uint64_t) 1 << 63) | player));
+    }
+    write_end(g);
+    if(moved) {
+        mark_dirty(g, x, y);
+        notify_change(g, MOVE_LOG_GOLDEN_MOVE, x, y, old_owner);
+    }
+    return moved;
+}
+
+bool gamma_move_delta(gamma_t *g, uint32_t player, uint32_t x, uint32_t y,
+                      gamma_move_delta_t *delta) {
+    return gamma_valid(g) && evaluate_move(g, player, x, y, delta);
+}
+
+bool gamma_golden_move_delta(gamma_t *g, uint32_t player, uint32_t x, uint32_t y,
+                             gamma_move_delta_t *delta) {
+    return gamma_valid(g) && evaluate_golden_move(g, player, x, y, delta);
+}
+
+/**@brief podaje na ile fragmentow podzielic przegladanie planszy.
+ * @param[in] cells - ilosc przegladanych pol,
+ * @param[in] rows - ilosc dzielonych wierszy lub kolumn.
+ * @return 1 dla malych plansz, w przeciwnym przypadku ilosc fragmentow
+ * dla puli watkow, nie wieksza niz @p rows.
+ */
+static uint32_t board_scan_chunks(uint64_t cells, uint64_t rows) {
+    if(cells < PARALLEL_MIN_CELLS) {
+        return 1;
+    }
+    uint64_t chunks = (uint64_t) thread_pool_threads() * PARALLEL_CHUNKS_PER_THREAD;
+    return (uint32_t) (chunks < rows ? chunks : rows);
+}
+
+/** @struct free_fields_scan
+ * @brief Parametry rownoleglego liczenia wolnych pol sasiadujacych z graczem.
+ */
+typedef struct free_fields_scan {
+    gamma_t *g; ///< przegladana gra
+    uint32_t player; ///< gracz, dla ktorego liczone sa pola
+    uint64_t *partial; ///< wyniki kolejnych fragmentow
+} free_fields_scan_t;
+
+/**@brief liczy wolne pola sasiadujace z polami gracza w pasie kolumn.
+ * Kolumny planszy leza w pamieci w sposob ciagly, wiec plansza dzielona
+ * jest na pasy kolumn. Wynik fragmentu zapisywany jest pod jego numerem,
+ * a sumowanie w kolejnosci fragmentow daje wynik niezalezny od przydzialu
+ * pracy do watkow. Kazde pole jest czytane raz: petla idzie wzdluz kolumny,
+ * pamietajac biezace i nastepne pole, a pola sasiednich kolumn czyta
+ * tylko dla wolnych pol.
+ * @param[in,out] ctx - wskaznik na strukture @ref free_fields_scan,
+ * @param[in] begin - pierwsza kolumna pasa,
+ * @param[in] end - kolumna za ostatnia kolumna pasa,
+ * @param[in] chunk - numer fragmentu.
+ */
+static void count_adjacent_free(void *ctx, uint64_t begin, uint64_t end,
+                                uint32_t chunk) {
+    free_fields_scan_t *scan = ctx;
+    gamma_t *g = scan->g;
+    uint32_t player = scan->player, height = g->height;
+    uint64_t count = 0;
+    for (uint64_t x = begin; x < end; ++x) {
+        uint32_t *left = (x > 0) ? g->board[x - 1] : NULL;
+        uint32_t *column = g->board[x];
+        uint32_t *right = (x + 1 < g->width) ? g->board[x + 1] : NULL;
+        uint32_t above = 0, cell = RELAXED_LOAD(column[0]);
+        for (uint32_t y = 0; y < height; ++y) {
+            uint32_t below = (y + 1 < height) ? RELAXED_LOAD(column[y + 1]) : 0;
+            if (cell == 0) {
+                count += (above == player || below == player
+                          || (left != NULL && RELAXED_LOAD(left[y]) == player)
+                          || (right != NULL && RELAXED_LOAD(right[y]) == player));
+            }
+            above = cell;
+            cell = below;
+        }
+    }
+    scan->partial[chunk] = count;
+}
+
 uint64_t gamma_free_fields(gamma_t *g, uint32_t player) {
     if(!(gamma_valid(g) && player_valid(g,player))) {
         return 0;
     } else {
-        uint64_t allfields;
-        if (g->players_areas[player] < g->areas) {
-            allfields = (uint64_t) g->width * (uint64_t) g->height;
-            for (uint64_t i = 1; i <= g->players; ++i) {
-                allfields -= g->players_field_count[i];
-            }
-        } else {
-            allfields = (uint64_t) g->width * (uint64_t) g->height;
-            for (uint64_t i = 1; i <= g->players; ++i) {
-                allfields -= g->players_field_count[i];
-            }
-            allfields = 0;
-            for (uint32_t x = 0; x < g->width; ++x) {
-                for (uint32_t y = 0; y < g->height; ++y) {
-                    if (g->board[x][y] == 0 && 
-			check_if_around_same_player(g, player, x, y) == true) {
-                        allfields++;
-                    }
+        uint64_t allfields, seq;
+        do {
+            seq = read_begin(g);
+            if (player_areas(g, player) < g->areas) {
+                allfields = (uint64_t) g->width * (uint64_t) g->height;
+                allfields -= RELAXED_LOAD(g->busy_fields);
+            } else {
+                uint32_t chunks = board_scan_chunks((uint64_t) g->width * g->height, g->width);
+                uint64_t partial[chunks];
+                free_fields_scan_t scan = { g, player, partial };
+                thread_pool_parallel_for(g->width, chunks, count_adjacent_free, &scan);
+                allfields = 0;
+                for (uint32_t i = 0; i < chunks; ++i) {
+                    allfields += partial[i];
                 }
             }
-        }
+        } while(read_retry(g, seq));
         return allfields;
     }
 }
@@ -681,64 +1658,312 @@ static uint64_t num_of_digits(uint32_t number){
     return (counter == 0 ? 1 : counter);
 }
 
-/**@brief funkcja zwracajaca wieksza z dwoch liczb.
- * funkcja zwracajaca wieksza z dwoch liczb.
- * @param[in] a - pierwsza liczba,
- * @param[in] b - druga liczba.
- * @return max(a,b).
+/** @struct board_render
+ * @brief Parametry wypisywania prostokata planszy do bufora.
+ */
+typedef struct board_render {
+    gamma_t *g; ///< wypisywana gra
+    char *buffor; ///< bufor wynikowy
+    uint64_t max_len; ///< ilosc znakow jednego pola
+    uint64_t limit; /**< najmniejszy numer gracza, ktory nie miesci sie
+                     * w @p max_len znakach **/
+    uint32_t x0; ///< pierwsza wypisywana kolumna
+    uint32_t x1; ///< ostatnia wypisywana kolumna
+    uint32_t y1; ///< najwyzszy wypisywany wiersz, wypisywany jako pierwszy
+} board_render_t;
+
+/**@brief wypisuje wiersze prostokata planszy do bufora.
+ * Wiersz wyjscia o numerze @p r odpowiada wierszowi planszy y1 - r
+ * i zaczyna sie w buforze na pozycji r * ((x1 - x0 + 1) * max_len + 1).
+ * Jesli plansza jest rownoczesnie zmieniana, pole moze zawierac numer
+ * dluzszy niz @p max_len; jest on wtedy pomijany, a caly odczyt i tak
+ * zostanie powtorzony.
+ * @param[in,out] ctx - wskaznik na strukture @ref board_render,
+ * @param[in] begin - pierwszy wypisywany wiersz wyjscia,
+ * @param[in] end - wiersz wyjscia za ostatnim wypisywanym,
+ * @param[in] chunk - nieuzywany numer fragmentu.
+ */
+static void render_rows(void *ctx, uint64_t begin, uint64_t end, uint32_t chunk) {
+    (void) chunk;
+    board_render_t *r = ctx;
+    gamma_t *g = r->g;
+    char *buffor = r->buffor;
+    uint64_t max_len = r->max_len;
+    uint64_t columns = (uint64_t) r->x1 - r->x0 + 1;
+    uint64_t ptr = begin * (columns * max_len + 1), startptr;
+    for (uint64_t row = begin; row < end; ++row) {
+        uint32_t y = r->y1 - (uint32_t) row;
+        for (uint32_t x = r->x0; x <= r->x1; ++x) {
+            uint64_t temp = RELAXED_LOAD(g->board[x][y]);
+            if (temp >= r->limit) {
+                temp = 0;
+            }
+            startptr = ptr;
+            ptr += max_len - 1;
+            if (temp == 0) {
+                buffor[ptr--] = '.';
+            }
+            while (temp > 0) {
+                buffor[ptr--] = (char) (temp % 10 + '0');
+                temp /= 10;
+            }
+            ptr++;
+            while (ptr > startptr) {
+                buffor[--ptr] = ' ';
+            }
+            ptr += max_len;
+        }
+        buffor[ptr++] = '\n';
+    }
+}
+
+/**@brief wypisuje prostokat planszy do nowego bufora.
+ * @param[in] g - wskaznik na gre,
+ * @param[in] x0 - pierwsza kolumna,
+ * @param[in] y0 - najnizszy wiersz,
+ * @param[in] x1 - ostatnia kolumna, nie mniejsza od @p x0,
+ * @param[in] y1 - najwyzszy wiersz, nie mniejszy od @p y0.
+ * @return Wskaźnik na zaalokowany bufor lub NULL, jeśli nie udało się
+ * zaalokować pamięci.
  */
-static uint64_t max(uint64_t a, uint64_t b) {
-    return ((a < b) ? b : a);
+static char* render_region(gamma_t *g, uint32_t x0, uint32_t y0,
+                           uint32_t x1, uint32_t y1) {
+    char *buffor = NULL;
+    uint64_t w = (uint64_t) x1 - x0 + 1;
+    uint64_t h = (uint64_t) y1 - y0 + 1;
+    uint64_t seq;
+    do {
+        free(buffor);
+        seq = read_begin(g);
+        uint64_t max_len = size_of_max_player(g);
+        buffor = malloc(sizeof(char) * (1 + h + w * h * max_len));
+        if (buffor == NULL) {
+            return NULL;
+        }
+        uint64_t limit = 1;
+        for (uint64_t i = 0; i < max_len; ++i) {
+            limit *= 10;
+        }
+        board_render_t render = { g, buffor, max_len, limit, x0, x1, y1 };
+        thread_pool_parallel_for(h, board_scan_chunks(w * h, h), render_rows, &render);
+        buffor[h * (w * max_len + 1)] = '\0';
+    } while (read_retry(g, seq));
+
+    return buffor;
 }
 
 char* gamma_board(gamma_t *g) {
     if(!gamma_valid(g)) {
         return NULL;
     }
-    else {
-        uint64_t count_signs = 1 + (uint64_t) g->height;
-        uint64_t max_len = 1;
-        for (int64_t y = (int32_t) (g->height - 1); y >= 0; --y) {
-            for (uint32_t x = 0; x < g->width; ++x) {
-                max_len = max(max_len, num_of_digits(g->board[x][y]));
-            }
+    return render_region(g, 0, 0, g->width - 1, g->height - 1);
+}
+
+char* gamma_board_region(gamma_t *g, uint32_t x0, uint32_t y0,
+                         uint32_t x1, uint32_t y1) {
+    if(!(gamma_valid(g) && xy_valid(g, x1, y1)) || x0 > x1 || y0 > y1) {
+        return NULL;
+    }
+    return render_region(g, x0, y0, x1, y1);
+}
+
+/**@brief dopisuje do bufora linie opisujaca pole.
+ * @param[in,out] buffor - bufor, do ktorego dopisywana jest linia,
+ * @param[in] ptr - pozycja w buforze, od ktorej dopisywana jest linia,
+ * @param[in] x - numer kolumny,
+ * @param[in] y - numer wiersza,
+ * @param[in] owner - wlasciciel pola.
+ * @return pozycja w buforze za dopisana linia.
+ */
+static uint64_t diff_line(char *buffor, uint64_t ptr,
+                          uint32_t x, uint32_t y, uint32_t owner) {
+    return ptr + (uint64_t) sprintf(buffor + ptr, "%u %u %u\n", x, y, owner);
+}
+
+/**@brief sprawdza, czy pole nalezy do zbioru zmienionych pol.
+ * @param[in] g - wskaznik na gre,
+ * @param[in] tracked - czy zmienione pola sa sledzone,
+ * @param[in] cell - numer pola x * height + y.
+ * @return true jesli pole jest zaznaczone w mapie bitowej lub, gdy pola
+ * nie sa sledzone, jest zajete.
+ */
+static bool cell_changed(gamma_t *g, bool tracked, uint64_t cell) {
+    if(tracked) {
+        return (g->dirty_bits[cell / 64] >> (cell % 64)) & 1;
+    }
+    return g->cells[cell] != 0;
+}
+
+char* gamma_board_diff(gamma_t *g) {
+    if(!gamma_valid(g)) {
+        return NULL;
+    }
+    bool tracked = enable_dirty_tracking(g);
+    bool scan = !tracked || g->dirty_overflow;
+    uint64_t count = g->dirty_count;
+    if(!tracked) {
+        count = g->busy_fields;
+    }
+    else if(g->dirty_overflow) {
+        count = 0;
+        for(uint64_t i = 0; i < dirty_bits_words(g->width, g->height); ++i) {
+            count += (uint64_t) __builtin_popcountll(g->dirty_bits[i]);
         }
-        char *buffor;
-	uint64_t w, h;
-	w = g->width;
-	h = g->height;
-        buffor = malloc(sizeof(char) * 
-			((count_signs) + w * h * (uint64_t) max_len));
-        if (buffor == NULL) {
-            return NULL;
-        } 
-	else {
-            uint64_t ptr = 0, startptr;
-            for (int32_t y = (int64_t) (g->height - 1); y >= 0; --y) {
-                for (uint32_t x = 0; x < g->width; ++x) {
-                    startptr = ptr;
-                    ptr += max_len - 1;
-                    if (g->board[x][y] == 0) {
-                        buffor[ptr--] = '.';
-                    }
-                    uint64_t temp = g->board[x][y];
-                    while (temp > 0) {
-                        buffor[ptr--] = (char) (temp % 10 + '0');
-                        temp /= 10;
-                    }
-                    ptr++;
-                    while (ptr > startptr) {
-                        buffor[--ptr] = ' ';
-                    }
-                    ptr += max_len;
+    }
+    char *buffor = malloc(DIFF_LINE_LEN + count * DIFF_LINE_LEN + 1);
+    if(buffor == NULL) {
+        return NULL;
+    }
+    uint64_t ptr = (uint64_t) sprintf(buffor, "%lu\n", count);
+    if(scan) {
+        for(uint32_t x = 0; x < g->width; ++x) {
+            for(uint32_t y = 0; y < g->height; ++y) {
+                if(cell_changed(g, tracked, (uint64_t) x * g->height + y)) {
+                    ptr = diff_line(buffor, ptr, x, y, g->board[x][y]);
                 }
-                buffor[ptr++] = '\n';
             }
-            buffor[ptr] = '\0';
+        }
+    }
+    else {
+        for(uint64_t i = 0; i < count; ++i) {
+            uint32_t x = (uint32_t) (g->dirty_cells[i] / g->height);
+            uint32_t y = (uint32_t) (g->dirty_cells[i] % g->height);
+            ptr = diff_line(buffor, ptr, x, y, g->board[x][y]);
+        }
+    }
+    gamma_clear_diff(g);
+    return buffor;
+}
 
-            return buffor;
+void gamma_clear_diff(gamma_t *g) {
+    if(!gamma_valid(g) || !enable_dirty_tracking(g)) {
+        return;
+    }
+    if(g->dirty_overflow) {
+        memset(g->dirty_bits, 0,
+               dirty_bits_words(g->width, g->height) * sizeof(uint64_t));
+        g->dirty_overflow = false;
+    }
+    else {
+        for(uint64_t i = 0; i < g->dirty_count; ++i) {
+            g->dirty_bits[g->dirty_cells[i] / 64] = 0;
         }
     }
+    g->dirty_count = 0;
+}
+
+bool gamma_track_diff(gamma_t *g) {
+    return gamma_valid(g) && enable_dirty_tracking(g);
+}
+
+bool gamma_diff_tracked(gamma_t *g) {
+    return gamma_valid(g) && g->dirty_tracking;
+}
+
+bool gamma_copy(gamma_t *dst, gamma_t *src) {
+    if(dst == NULL || src == NULL || dst->width != src->width
+       || dst->height != src->height || dst->players != src->players
+       || dst->areas != src->areas) {
+        return false;
+    }
+    write_begin(dst);
+    memcpy(dst->cells, src->cells,
+           sizeof(uint32_t) * (uint64_t) src->width * (uint64_t) src->height);
+    fau_copy(dst->f, src->f, src->height);
+    bool copied = true;
+    if(dst->flat_players != NULL) {
+        memcpy(dst->flat_players, src->flat_players,
+               sizeof(player_entry_t) * ((uint64_t) src->players + 1));
+    }
+    else {
+        copied = player_table_copy(dst->player_table, src->player_table);
+    }
+    RELAXED_STORE(dst->busy_fields, src->busy_fields);
+    RELAXED_STORE(dst->active_players, src->active_players);
+    for(int i = 0; i <= MAX_PLAYER_DIGITS; ++i) {
+        RELAXED_STORE(dst->active_players_by_width[i], src->active_players_by_width[i]);
+    }
+    RELAXED_STORE(dst->max_active_player, src->max_active_player);
+    for(int i = 0; i < GAMMA_SYMMETRIES; ++i) {
+        RELAXED_STORE(dst->symmetry_hash[i], src->symmetry_hash[i]);
+    }
+    RELAXED_STORE(dst->golden_hash, src->golden_hash);
+    write_end(dst);
+    if(dst->dirty_tracking) {
+        gamma_clear_diff(dst);
+    }
+    return copied;
+}
+
+gamma_t* gamma_clone(gamma_t *g) {
+    if(g == NULL) {
+        return NULL;
+    }
+    gamma_t *clone = gamma_new(g->width, g->height, g->players, g->areas);
+    if(clone != NULL && !gamma_copy(clone, g)) {
+        gamma_delete(clone);
+        return NULL;
+    }
+    return clone;
+}
+
+uint32_t gamma_field_owner(gamma_t *g, uint32_t x, uint32_t y) {
+    if(!(gamma_valid(g) && xy_valid(g, x, y))) {
+        return 0;
+    }
+    return g->board[x][y];
+}
+
+bool gamma_golden_move_used(gamma_t *g, uint32_t player) {
+    if(!(gamma_valid(g) && player_valid(g, player))) {
+        return false;
+    }
+    return golden_move_used(g, player);
+}
+
+uint64_t gamma_canonical_hash(gamma_t *g, uint32_t to_move, uint32_t *transform) {
+    if(!gamma_valid(g) || (to_move != 0 && !player_valid(g, to_move))) {
+        return 0;
+    }
+    uint64_t seq, hash;
+    uint32_t best;
+    do {
+        seq = read_begin(g);
+        best = 0;
+        hash = RELAXED_LOAD(g->symmetry_hash[0]);
+        for(uint32_t t = 1; t < symmetry_count(g); ++t) {
+            uint64_t h = RELAXED_LOAD(g->symmetry_hash[t]);
+            if(h < hash) {
+                hash = h;
+                best = t;
+            }
+        }
+        hash ^= RELAXED_LOAD(g->golden_hash);
+    } while(read_retry(g, seq));
+    if(to_move != 0) {
+        hash ^= hash_mix(((uint64_t) 1 << 62) | to_move);
+    }
+    if(transform != NULL) {
+        *transform = best;
+    }
+    return hash;
+}
+
+bool gamma_transform_field(gamma_t *g, uint32_t transform, uint32_t x, uint32_t y,
+                           uint32_t *tx, uint32_t *ty) {
+    if(!(gamma_valid(g) && xy_valid(g, x, y)) || transform >= symmetry_count(g)) {
+        return false;
+    }
+    transform_field(g, transform, x, y, tx, ty);
+    return true;
+}
+
+uint32_t gamma_inverse_transform(uint32_t transform) {
+    if(!(transform & TRANSFORM_TRANSPOSE)) {
+        return transform;
+    }
+    return TRANSFORM_TRANSPOSE | ((transform & TRANSFORM_MIRROR_X) ? TRANSFORM_MIRROR_Y : 0)
+           | ((transform & TRANSFORM_MIRROR_Y) ? TRANSFORM_MIRROR_X : 0);
 }
 
 uint32_t get_height(gamma_t *g) {
@@ -749,18 +1974,257 @@ uint32_t get_width(gamma_t *g) {
     return g->width;
 }
 
+uint32_t get_players(gamma_t *g) {
+    return g->players;
+}
+
+uint32_t get_areas(gamma_t *g) {
+    return g->areas;
+}
+
 uint64_t fields_taken_by_player(gamma_t *g, uint32_t player) {
     if (player == 0 || player > g->players) {
         return 0;
     }
     else {
-        return g->players_field_count[player];
+        return player_field_count(g, player);
     }
 }
 
 uint32_t size_of_max_player(gamma_t *g) {
-    for(int i = g->players; i >= 1; --i) {
-        if(g->players_field_count[i] != 0) return num_of_digits(i);
+    for(int width = MAX_PLAYER_DIGITS; width > 1; --width) {
+        if(RELAXED_LOAD(g->active_players_by_width[width]) != 0) return width;
     }
     return 1;
 }
+
+uint32_t gamma_max_active_player(gamma_t *g) {
+    if(!gamma_valid(g)) {
+        return 0;
+    }
+    return RELAXED_LOAD(g->max_active_player);
+}
+
+void gamma_memory_usage(gamma_t *g, gamma_memory_stats_t *stats) {
+    if(gamma_valid(g)) {
+        gamma_memory_estimate(g->width, g->height, g->players, stats);
+        if(g->player_table != NULL) {
+            stats->players = player_table_memory_usage(g->player_table);
+        }
+        stats->other += sizeof(gamma_subscriber_t) * (uint64_t) g->subscriber_capacity;
+        stats->other -= (dirty_bits_words(g->width, g->height)
+                         + dirty_cells_limit(g->width, g->height)) * sizeof(uint64_t);
+        if(g->dirty_bits != NULL) {
+            stats->other += sizeof(uint64_t) * dirty_bits_words(g->width, g->height);
+        }
+        stats->other += sizeof(uint64_t) * g->dirty_capacity;
+        if(g->walk_stack != NULL) {
+            stats->visited += sizeof(uint64_t) * (uint64_t) g->width * g->height;
+        }
+        if(g->shared != NULL) {
+            stats->board += g->shared->cells_offset;
+        }
+        memory_stats_total(stats);
+    }
+}
+
+uint32_t gamma_subscribe(gamma_t *g, gamma_change_fn fn, void *ctx) {
+    if(!gamma_valid(g) || fn == NULL || g->next_subscriber_id == 0) {
+        return 0;
+    }
+    if(g->subscriber_count == g->subscriber_capacity) {
+        uint32_t capacity = (g->subscriber_capacity == 0) ? 4 : 2 * g->subscriber_capacity;
+        gamma_subscriber_t *subscribers =
+                realloc(g->subscribers, sizeof(gamma_subscriber_t) * capacity);
+        if(subscribers == NULL) {
+            return 0;
+        }
+        g->subscribers = subscribers;
+        g->subscriber_capacity = capacity;
+    }
+    gamma_subscriber_t *s = &g->subscribers[g->subscriber_count++];
+    s->id = g->next_subscriber_id++;
+    s->fn = fn;
+    s->ctx = ctx;
+    return s->id;
+}
+
+bool gamma_unsubscribe(gamma_t *g, uint32_t id) {
+    if(!gamma_valid(g)) {
+        return false;
+    }
+    for(uint32_t i = 0; i < g->subscriber_count; ++i) {
+        if(g->subscribers[i].id == id) {
+            for(uint32_t j = i + 1; j < g->subscriber_count; ++j) {
+                g->subscribers[j - 1] = g->subscribers[j];
+            }
+            g->subscriber_count--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void gamma_attach_log(gamma_t *g, move_log_t *log) {
+    if(gamma_valid(g)) {
+        if(g->owns_log) {
+            move_log_close(g->log);
+        }
+        g->log = log;
+        g->owns_log = false;
+    }
+}
+
+/** @brief odtwarza jeden wpis dziennika na grze.
+ * @param[in,out] ctx - wskaznik na gre, na ktorej odtwarzany jest ruch,
+ * @param[in] kind - rodzaj ruchu,
+ * @param[in] player - numer gracza,
+ * @param[in] x - numer kolumny,
+ * @param[in] y - numer wiersza.
+ * @return @p true jesli ruch udalo sie wykonac, @p false w przeciwnym przypadku.
+ */
+static bool replay_record(void *ctx, uint8_t kind,
+                          uint32_t player, uint32_t x, uint32_t y) {
+    gamma_t *g = ctx;
+    if(kind == MOVE_LOG_GOLDEN_MOVE) {
+        return gamma_golden_move(g, player, x, y);
+    }
+    return gamma_move(g, player, x, y);
+}
+
+gamma_t* gamma_replay(const char *path) {
+    uint32_t width, height, players, areas;
+    if(!move_log_read_header(path, &width, &height, &players, &areas)) {
+        return NULL;
+    }
+    gamma_t *g = gamma_new(width, height, players, areas);
+    if(g == NULL) {
+        return NULL;
+    }
+    bool consistent = true;
+    int64_t replayed = move_log_replay(path, replay_record, g);
+    if(replayed < 0) {
+        consistent = false;
+    }
+    else {
+        /* Odtwarzanie przerywa sie na pierwszym ruchu, ktorego nie udalo sie
+         * wykonac, wiec dziennik jest spojny wtedy, gdy przejrzenie go bez
+         * wykonywania ruchow daje te sama liczbe wpisow. */
+        consistent = (move_log_replay(path, NULL, NULL) == replayed);
+    }
+    if(!consistent) {
+        gamma_delete(g);
+        return NULL;
+    }
+    return g;
+}
+
+gamma_t* gamma_new_logged(const char *path, uint32_t width, uint32_t height,
+                          uint32_t players, uint32_t areas,
+                          uint32_t sync_every_moves, uint32_t sync_every_ms) {
+    move_log_t *log;
+    if(path == NULL || width == 0 || height == 0 || players == 0 || areas == 0
+       || !move_log_open(&log, path, width, height, players, areas,
+                      sync_every_moves, sync_every_ms)) {
+        return NULL;
+    }
+    gamma_t *g = gamma_replay(path);
+    if(g == NULL) {
+        move_log_close(log);
+        return NULL;
+    }
+    g->log = log;
+    g->owns_log = true;
+    return g;
+}
+
+/**@brief laczy w drzewie find and union sasiednie pola gracza w pasie kolumn.
+ * Pierwsze przejscie etykietowania spojnych skladowych: kazde pole jest
+ * laczone z sasiadem ponizej i z lewej, jesli naleza do tego samego gracza.
+ * Pasy kolumn sa rozlaczne, wiec moga byc przetwarzane rownolegle; pola na
+ * granicach pasow sa laczone pozniej.
+ * @param[in,out] ctx - wskaznik na gre,
+ * @param[in] begin - pierwsza kolumna pasa,
+ * @param[in] end - kolumna za ostatnia kolumna pasa,
+ * @param[in] chunk - numer fragmentu.
+ */
+static void label_columns(void *ctx, uint64_t begin, uint64_t end, uint32_t chunk) {
+    (void) chunk;
+    gamma_t *g = ctx;
+    for(uint32_t x = (uint32_t) begin; x < end; ++x) {
+        for(uint32_t y = 0; y < g->height; ++y) {
+            uint32_t owner = g->board[x][y];
+            if(owner == 0) {
+                continue;
+            }
+            if(y > 0 && g->board[x][y - 1] == owner) {
+                fau_unite_fields(g->f, x, y, x, y - 1);
+            }
+            if(x > begin && g->board[x - 1][y] == owner) {
+                fau_unite_fields(g->f, x, y, x - 1, y);
+            }
+        }
+    }
+}
+
+gamma_t* gamma_from_cells(uint32_t width, uint32_t height, uint32_t players,
+                          uint32_t areas, const uint32_t *cells) {
+    if(cells == NULL) {
+        return NULL;
+    }
+    gamma_t *g = gamma_new(width, height, players, areas);
+    if(g == NULL) {
+        return NULL;
+    }
+    for(uint32_t x = 0; x < width; ++x) {
+        for(uint32_t y = 0; y < height; ++y) {
+            uint32_t owner = cells[(uint64_t) x * height + y];
+            if(owner > players) {
+                gamma_delete(g);
+                return NULL;
+            }
+            g->board[x][y] = owner;
+        }
+    }
+
+    uint32_t chunks = board_scan_chunks((uint64_t) width * height, width);
+    thread_pool_parallel_for(width, chunks, label_columns, g);
+    for(uint32_t i = 1; i < chunks; ++i) {
+        uint32_t x = (uint32_t) ((uint64_t) width * i / chunks);
+        for(uint32_t y = 0; y < height; ++y) {
+            if(g->board[x][y] != 0 && g->board[x - 1][y] == g->board[x][y]) {
+                fau_unite_fields(g->f, x, y, x - 1, y);
+            }
+        }
+    }
+
+    /* Drugie przejscie: kazdy korzen drzewa to jeden obszar wlasciciela. */
+    player_entry_t *e = NULL;
+    for(uint32_t x = 0; x < width; ++x) {
+        for(uint32_t y = 0; y < height; ++y) {
+            uint32_t owner = g->board[x][y];
+            if(owner == 0) {
+                continue;
+            }
+            if(e == NULL || e->id != owner) {
+                e = get_entry(g, owner);
+                if(e == NULL) {
+                    gamma_delete(g);
+                    return NULL;
+                }
+            }
+            uint32_t root_x, root_y;
+            fau_root(g->f, x, y, &root_x, &root_y);
+            e->areas += (root_x == x && root_y == y);
+            if(e->areas > areas) {
+                gamma_delete(g);
+                return NULL;
+            }
+            e->field_count++;
+            g->busy_fields++;
+            field_count_changed(g, owner, e->field_count - 1, e->field_count);
+            symmetry_hash_update(g, x, y, 0, owner);
+        }
+    }
+    return g;
+}
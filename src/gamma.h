@@ -1,6 +1,13 @@
 /** @file
  * Interfejs klasy przechowującej stan gry gamma
  *
+ * Funkcje @ref gamma_busy_fields, @ref gamma_free_fields,
+ * @ref gamma_golden_possible, @ref gamma_board i @ref gamma_board_region
+ * moga byc wolane z wielu watkow rownoczesnie z jednym watkiem wykonujacym
+ * ruchy: odczyt jest powtarzany, jesli w jego trakcie wykonano ruch, wiec
+ * zawsze zwraca stan pomiedzy ruchami. Pozostale funkcje wymagaja
+ * wylacznego dostepu do gry.
+ *
  * @author Marcin Peczarski <marpe@mimuw.edu.pl>
  * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
  * @copyright Uniwersytet Warszawski
@@ -14,6 +21,10 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include "fau.h"
+#include "move_log.h"
+#include "player_table.h"
+
+#define GAMMA_SYMMETRIES 8 ///< ilosc symetrii planszy kwadratowej
 
 /**
  * Struktura przechowująca stan gry.
@@ -34,6 +45,119 @@ typedef struct gamma gamma_t;
 gamma_t* gamma_new(uint32_t width, uint32_t height,
                    uint32_t players, uint32_t areas);
 
+/** @brief Tworzy gre z plansza w pamieci wspoldzielonej.
+ * Dziala jak @ref gamma_new, ale pola planszy umieszcza w nowym segmencie
+ * pamieci wspoldzielonej POSIX o nazwie @p name, opisanym w pliku
+ * board_mirror.h, z ktorego inne procesy moga czytac plansze.
+ * Segment jest usuwany przez @ref gamma_delete.
+ * @param[in] width   – szerokość planszy, liczba dodatnia,
+ * @param[in] height  – wysokość planszy, liczba dodatnia,
+ * @param[in] players – liczba graczy, liczba dodatnia,
+ * @param[in] areas   – maksymalna liczba obszarów,
+ *                      jakie może zająć jeden gracz,
+ * @param[in] name    – nazwa segmentu, zaczynajaca sie znakiem '/'.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci, segment o tej nazwie juz istnieje lub któryś
+ * z parametrów jest niepoprawny.
+ */
+gamma_t* gamma_new_shared(uint32_t width, uint32_t height,
+                          uint32_t players, uint32_t areas, const char *name);
+
+/**
+ * Struktura opisujaca pamiec zajmowana przez gre, w bajtach, bez narzutu
+ * alokatora. Dziennik ruchow i jego bufor nie sa wliczane.
+ */
+typedef struct gamma_memory_stats {
+    uint64_t board; ///< plansza
+    uint64_t visited; /**< pomocnicze znaczniki odwiedzonych pol i stos
+                       * przeszukiwania obszarow **/
+    uint64_t fau_parent; ///< tablica ojcow drzewa find and union
+    uint64_t fau_size; ///< tablica rozmiarow drzewa find and union
+    uint64_t players; ///< tablica stanu graczy, ktorzy wykonali jakis ruch
+    uint64_t other; /**< struktura gry, pomocnicze pary koordynatow,
+                     * subskrypcje i zbior zmienionych pol **/
+    uint64_t total; ///< suma powyzszych lub UINT64_MAX przy przepelnieniu
+} gamma_memory_stats_t;
+
+/** @brief Szacuje pamiec potrzebna do utworzenia gry.
+ * Wypelnia @p stats liczba bajtow, ktore zaalokowalaby funkcja
+ * @ref gamma_new dla podanych parametrow, niczego nie alokujac.
+ * @param[in] width   – szerokość planszy,
+ * @param[in] height  – wysokość planszy,
+ * @param[in] players – liczba graczy,
+ * @param[out] stats  – wskaznik na wypelniana strukture.
+ */
+void gamma_memory_estimate(uint32_t width, uint32_t height, uint32_t players,
+                           gamma_memory_stats_t *stats);
+
+/** @brief Podaje pamiec zajmowana przez gre.
+ * Wypelnia @p stats liczba bajtow zajmowanych przez poszczegolne
+ * czesci gry @p g. Nic nie robi, jesli @p g ma wartosc NULL.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[out] stats  – wskaznik na wypelniana strukture.
+ */
+void gamma_memory_usage(gamma_t *g, gamma_memory_stats_t *stats);
+
+/** @brief Tworzy strukturę przechowującą stan gry w ramach limitu pamieci.
+ * Dziala jak @ref gamma_new, ale przed alokacja sprawdza, czy gra zmiesci sie
+ * w limicie @p budget, szacujac jej rozmiar funkcja @ref gamma_memory_estimate.
+ * @param[in] width   – szerokość planszy, liczba dodatnia,
+ * @param[in] height  – wysokość planszy, liczba dodatnia,
+ * @param[in] players – liczba graczy, liczba dodatnia,
+ * @param[in] areas   – maksymalna liczba obszarów,
+ *                      jakie może zająć jeden gracz,
+ * @param[in] budget  – maksymalna liczba bajtow, jaka moze zajac gra.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy gra przekroczylaby
+ * limit, nie udało się zaalokować pamięci lub któryś z parametrów
+ * jest niepoprawny.
+ */
+gamma_t* gamma_new_with_budget(uint32_t width, uint32_t height,
+                               uint32_t players, uint32_t areas,
+                               uint64_t budget);
+
+/** @brief Kopiuje stan gry.
+ * Ustawia stan gry @p dst na stan gry @p src. Obie gry musza miec takie
+ * same parametry. Nie sa kopiowane dziennik ruchow, subskrypcje ani zbior
+ * zmienionych pol, ktory w @p dst jest czyszczony, jesli jest sledzony.
+ * @param[in,out] dst – wskaźnik na grę, do której kopiujemy,
+ * @param[in] src     – wskaźnik na kopiowaną grę.
+ * @return Wartość @p true, jeśli stan został skopiowany, a @p false,
+ * gdy gry maja rozne parametry lub nie udało się zaalokować pamięci;
+ * wtedy stan @p dst jest nieokreslony.
+ */
+bool gamma_copy(gamma_t *dst, gamma_t *src);
+
+/** @brief Tworzy kopie gry.
+ * Tworzy nowa gre o parametrach gry @p g i kopiuje do niej jej stan
+ * funkcja @ref gamma_copy. Kopia nie korzysta z pamieci wspoldzielonej.
+ * @param[in] g       – wskaźnik na kopiowaną grę.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci lub @p g ma wartosc NULL.
+ */
+gamma_t* gamma_clone(gamma_t *g);
+
+/** @brief Tworzy gre z gotowym rozmieszczeniem pionkow.
+ * Tworzy gre o podanych parametrach, na ktorej polu (@p x, @p y) stoi pionek
+ * gracza @p cells[x * height + y] lub nie stoi zaden, jesli ta wartosc jest
+ * rowna 0. Obszary graczy sa wyznaczane jednym przejsciem po planszy, bez
+ * wykonywania ruchow, wiec mozna tak odtworzyc takze pozycje osiagniete
+ * zlotymi ruchami. Poniewaz z planszy nie wynika, kto wykonal juz zloty
+ * ruch, zaden gracz nie ma go wykorzystanego.
+ * @param[in] width   – szerokość planszy, liczba dodatnia,
+ * @param[in] height  – wysokość planszy, liczba dodatnia,
+ * @param[in] players – liczba graczy, liczba dodatnia,
+ * @param[in] areas   – maksymalna liczba obszarów,
+ *                      jakie może zająć jeden gracz,
+ * @param[in] cells   – tablica @p width * @p height numerow graczy
+ *                      zapisanych kolumnami.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci, pole zawiera numer gracza wiekszy od @p players,
+ * ktorys gracz ma wiecej niz @p areas obszarow lub któryś z parametrów jest
+ * niepoprawny.
+ */
+gamma_t* gamma_from_cells(uint32_t width, uint32_t height, uint32_t players,
+                          uint32_t areas, const uint32_t *cells);
+
 /** @brief Usuwa strukturę przechowującą stan gry.
  * Usuwa z pamięci strukturę wskazywaną przez @p g.
  * Nic nie robi, jeśli wskaźnik ten ma wartość NULL.
@@ -55,6 +179,32 @@ void gamma_delete(gamma_t *g);
  */
 bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y);
 
+/**
+ * Ruch z ciagu ruchow wykonywanych przez @ref gamma_move_batch.
+ */
+typedef struct gamma_batch_move {
+    uint32_t player; ///< numer gracza
+    uint32_t x; ///< numer kolumny
+    uint32_t y; ///< numer wiersza
+} gamma_batch_move_t;
+
+/** @brief Wykonuje ciag ruchow.
+ * Wykonuje po kolei ruchy z tablicy @p moves z takim samym skutkiem jak
+ * @ref gamma_move wywolywana dla kazdego z nich, lacznie z dziennikiem,
+ * zbiorem zmienionych pol i powiadomieniami subskrybentow. W czasie
+ * wykonywania ruchu sprowadza do pamieci podrecznej pola planszy i drzewa
+ * find and union kolejnych ruchow. Jesli gra nie ma subskrybentow,
+ * czytelnicy widza stan gry tylko pomiedzy grupami ruchow.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] moves   – tablica ruchow,
+ * @param[in] n       – ilosc ruchow,
+ * @param[out] results – tablica @p n wartosci, pod ktorymi zapisywane jest,
+ *                      czy kolejne ruchy zostaly wykonane; moze byc NULL.
+ * @return Ilosc wykonanych ruchow.
+ */
+uint64_t gamma_move_batch(gamma_t *g, const gamma_batch_move_t *moves, uint64_t n,
+                          bool *results);
+
 /** @brief Wykonuje złoty ruch.
  * Ustawia pionek gracza @p player na polu (@p x, @p y) zajętym przez innego
  * gracza, usuwając pionek innego gracza.
@@ -71,6 +221,56 @@ bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y);
  */
 bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y);
 
+/**
+ * Zmiany stanu gry, ktore spowodowalby ruch. Ruch zmienia tylko stan
+ * wykonujacego go gracza i poprzedniego wlasciciela pola. Wynik
+ * @ref gamma_free_fields kazdego innego gracza zwykly ruch zmniejsza o jeden,
+ * jesli gracz ma mniej obszarow niz wynosi limit lub pole sasiaduje z jego
+ * polem, a zloty ruch go nie zmienia.
+ */
+typedef struct gamma_move_delta {
+    uint32_t old_owner; ///< poprzedni wlasciciel pola, 0 dla zwyklego ruchu
+    int64_t areas; ///< zmiana ilosci obszarow gracza wykonujacego ruch
+    int64_t fields; ///< zmiana wyniku @ref gamma_busy_fields gracza
+    int64_t free_fields; ///< zmiana wyniku @ref gamma_free_fields gracza
+    int64_t old_owner_areas; ///< zmiana ilosci obszarow poprzedniego wlasciciela
+    int64_t old_owner_fields; ///< zmiana ilosci pol poprzedniego wlasciciela
+    int64_t old_owner_free_fields; /**< zmiana wyniku @ref gamma_free_fields
+                                    * poprzedniego wlasciciela **/
+} gamma_move_delta_t;
+
+/** @brief Ocenia ruch bez wykonywania go.
+ * Sprawdza, czy @ref gamma_move z tymi parametrami by sie udal, i podaje
+ * zmiany stanu gry, ktore by spowodowal. Nie zmienia planszy ani drzewa
+ * find and union. Wymaga wylacznego dostepu do gry, tak jak @ref gamma_move.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza,
+ * @param[in] x       – numer kolumny,
+ * @param[in] y       – numer wiersza,
+ * @param[out] delta  – zmiany stanu gry, wypelniane tylko dla legalnego
+ *                      ruchu; moze byc NULL.
+ * @return Wartość @p true, jeśli ruch jest legalny, a @p false w przeciwnym
+ * przypadku lub gdy któryś z parametrów jest niepoprawny.
+ */
+bool gamma_move_delta(gamma_t *g, uint32_t player, uint32_t x, uint32_t y,
+                      gamma_move_delta_t *delta);
+
+/** @brief Ocenia złoty ruch bez wykonywania go.
+ * Odpowiednik @ref gamma_move_delta dla @ref gamma_golden_move. Zmienia
+ * tylko pomocnicze znaczniki odwiedzenia pol.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza,
+ * @param[in] x       – numer kolumny,
+ * @param[in] y       – numer wiersza,
+ * @param[out] delta  – zmiany stanu gry, wypelniane tylko dla legalnego
+ *                      ruchu; moze byc NULL.
+ * @return Wartość @p true, jeśli złoty ruch jest legalny, a @p false
+ * w przeciwnym przypadku, gdy któryś z parametrów jest niepoprawny lub
+ * nie udalo sie zaalokowac pamieci.
+ */
+bool gamma_golden_move_delta(gamma_t *g, uint32_t player, uint32_t x, uint32_t y,
+                             gamma_move_delta_t *delta);
+
 /** @brief Podaje liczbę pól zajętych przez gracza.
  * Podaje liczbę pól zajętych przez gracza @p player.
  * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
@@ -104,6 +304,67 @@ uint64_t gamma_free_fields(gamma_t *g, uint32_t player);
  */
 bool gamma_golden_possible(gamma_t *g, uint32_t player);
 
+/** @brief Podaje wlasciciela pola.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] x       – numer kolumny,
+ * @param[in] y       – numer wiersza.
+ * @return Numer gracza zajmujacego pole (@p x, @p y) lub zero, jesli pole
+ * jest wolne lub któryś z parametrów jest niepoprawny.
+ */
+uint32_t gamma_field_owner(gamma_t *g, uint32_t x, uint32_t y);
+
+/** @brief Sprawdza, czy gracz wykonal juz zloty ruch.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza.
+ * @return Wartosc @p true, jesli gracz wykonal w tej rozgrywce zloty ruch,
+ * @p false w przeciwnym przypadku lub gdy któryś z parametrów jest
+ * niepoprawny.
+ */
+bool gamma_golden_move_used(gamma_t *g, uint32_t player);
+
+/** @brief Podaje kanoniczny skrot pozycji.
+ * Pozycje przeprowadzane na siebie przez symetrie planszy maja ten sam
+ * skrot. Przeksztalcenie @p t odbija numery kolumn, jesli ustawiony jest
+ * bit 1, numery wierszy, jesli ustawiony jest bit 2, a potem, jesli
+ * ustawiony jest bit 4, zamienia kolumny z wierszami; przeksztalcenia
+ * z bitem 4 sa symetriami tylko planszy kwadratowej. Skroty plansz po
+ * kazdym z przeksztalcen sa uaktualniane przy kazdym ruchu, wiec wynik
+ * jest liczony w czasie stalym. Skrot uwzglednia tez graczy, ktorzy
+ * wykonali zloty ruch, i gracza wykonujacego ruch. Skroty gier o roznych
+ * parametrach nie sa rozroznialne.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] to_move – numer gracza wykonujacego ruch lub 0,
+ * @param[out] transform – wskaznik, pod ktorym zapisywany jest numer
+ * przeksztalcenia prowadzacego od planszy @p g do pozycji kanonicznej;
+ * moze byc NULL.
+ * @return Skrot pozycji lub 0, jeśli któryś z parametrów jest niepoprawny.
+ * Skrot pustej planszy, na ktorej nikt nie wykonal zlotego ruchu, przy
+ * @p to_move rownym 0 tez jest rowny 0.
+ */
+uint64_t gamma_canonical_hash(gamma_t *g, uint32_t to_move, uint32_t *transform);
+
+/** @brief Przeksztalca wspolrzedne pola.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] transform – numer przeksztalcenia, jak w
+ * @ref gamma_canonical_hash,
+ * @param[in] x       – numer kolumny,
+ * @param[in] y       – numer wiersza,
+ * @param[out] tx     – numer kolumny obrazu pola,
+ * @param[out] ty     – numer wiersza obrazu pola.
+ * @return Wartosc @p true, jesli przeksztalcono pole, @p false jesli
+ * któryś z parametrów jest niepoprawny lub przeksztalcenie nie jest
+ * symetria planszy.
+ */
+bool gamma_transform_field(gamma_t *g, uint32_t transform, uint32_t x, uint32_t y,
+                           uint32_t *tx, uint32_t *ty);
+
+/** @brief Podaje przeksztalcenie odwrotne.
+ * @param[in] transform – numer przeksztalcenia, mniejszy od
+ * @ref GAMMA_SYMMETRIES.
+ * @return Numer przeksztalcenia odwrotnego do @p transform.
+ */
+uint32_t gamma_inverse_transform(uint32_t transform);
+
 /** @brief Daje napis opisujący stan planszy.
  * Alokuje w pamięci bufor, w którym umieszcza napis zawierający tekstowy
  * opis aktualnego stanu planszy. Przykład znajduje się w pliku gamma_test.c.
@@ -114,6 +375,66 @@ bool gamma_golden_possible(gamma_t *g, uint32_t player);
  */
 char* gamma_board(gamma_t *g);
 
+/** @brief Daje napis opisujący stan prostokata planszy.
+ * Dziala jak @ref gamma_board, ale opisuje tylko kolumny od @p x0 do @p x1
+ * i wiersze od @p y0 do @p y1 wlacznie, zaczynajac od wiersza @p y1.
+ * Szerokosc pola jest taka sama jak w @ref gamma_board, wiec kolumny
+ * wycinka pokrywaja sie z kolumnami calej planszy.
+ * Funkcja wywołująca musi zwolnić ten bufor.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] x0      – pierwsza kolumna, liczba nieujemna niewieksza od @p x1,
+ * @param[in] y0      – najnizszy wiersz, liczba nieujemna niewieksza od @p y1,
+ * @param[in] x1      – ostatnia kolumna, mniejsza od szerokosci planszy,
+ * @param[in] y1      – najwyzszy wiersz, mniejszy od wysokosci planszy.
+ * @return Wskaźnik na zaalokowany bufor lub NULL, jeśli nie udało się
+ * zaalokować pamięci lub któryś z parametrów jest niepoprawny.
+ */
+char* gamma_board_region(gamma_t *g, uint32_t x0, uint32_t y0,
+                         uint32_t x1, uint32_t y1);
+
+/** @brief Daje napis opisujacy pola zmienione od poprzedniego wywolania.
+ * Alokuje w pamięci bufor z opisem pol, ktore zmienily wlasciciela od
+ * utworzenia gry lub od ostatniego wywolania tej funkcji albo
+ * @ref gamma_clear_diff. Pierwsza linia zawiera liczbe pol, a kazda kolejna
+ * trojke "x y wlasciciel" dla jednego pola, w kolejnosci pierwszej zmiany.
+ * Po wypisaniu zbior zmienionych pol jest czyszczony.
+ * Zmienione pola sa sledzone od pierwszego wywolania tej funkcji,
+ * @ref gamma_clear_diff lub @ref gamma_track_diff; wczesniej zmienione
+ * sa dokladnie pola zajete. Jesli zmienionych pol jest wiecej niz okolo
+ * 1/64 planszy, sa one podawane kolumnami, a nie w kolejnosci zmian.
+ * Funkcja wywołująca musi zwolnić ten bufor.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wskaźnik na zaalokowany bufor lub NULL, jeśli nie udało się
+ * zaalokować pamięci; wtedy zbior zmienionych pol nie jest czyszczony.
+ */
+char* gamma_board_diff(gamma_t *g);
+
+/** @brief Czysci zbior pol zmienionych od poprzedniego wywolania.
+ * Kolejne wywolanie @ref gamma_board_diff opisze tylko pola zmienione
+ * po tym wywolaniu. Wlacza sledzenie zmienionych pol, jesli nie bylo
+ * jeszcze wlaczone. Nic nie robi, jesli @p g ma wartosc NULL.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ */
+void gamma_clear_diff(gamma_t *g);
+
+/** @brief Wlacza sledzenie pol zmienionych od utworzenia gry.
+ * Bez wlaczenia sledzenia ruchy nie placa za utrzymywanie zbioru
+ * zmienionych pol. Wlaczenie jest jednorazowe i nie zmienia zbioru:
+ * do tej chwili zmienione sa wszystkie zajete pola.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartosc @p true, jesli pola sa sledzone, @p false jesli nie udalo
+ * sie zaalokowac pamieci lub @p g ma wartosc NULL.
+ */
+bool gamma_track_diff(gamma_t *g);
+
+/** @brief Sprawdza, czy pola zmienione od utworzenia gry sa sledzone.
+ * @param[in] g   – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartosc @p true, jesli sledzenie wlaczono funkcja
+ * @ref gamma_board_diff, @ref gamma_clear_diff lub @ref gamma_track_diff,
+ * @p false w przeciwnym przypadku lub gdy @p g ma wartosc NULL.
+ */
+bool gamma_diff_tracked(gamma_t *g);
+
 /** @brief Daje wiadomosc o ilosci znakow uzywanej do wypisania jednego pola
  * przez funkcje @p gamma_board.
  * Daje wiadomosc o ilosci znakow uzywanej do wypisania jednego pola
@@ -123,6 +444,16 @@ char* gamma_board(gamma_t *g);
  */
 uint32_t size_of_max_player(gamma_t *g);
 
+/** @brief Podaje najwiekszy numer gracza zajmujacego jakies pole.
+ * Wartosc jest utrzymywana przez ruchy i wyznaczana ponownie w zlotym
+ * ruchu, w ktorym gracz o najwiekszym numerze stracil ostatnie pole,
+ * wiec funkcja tylko ja odczytuje i moze byc wolana rownolegle z ruchami.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry.
+ * @return Numer gracza lub 0, jesli plansza jest pusta albo @p g ma
+ * wartosc NULL.
+ */
+uint32_t gamma_max_active_player(gamma_t *g);
+
 /** @brief Daje informacje o wysokosci planszy.
  * Daje informacje o wysokosci planszy.
  * @param[in] g       – wskaźnik na strukturę przechowującą stan gry.
@@ -137,6 +468,20 @@ uint32_t get_height(gamma_t *g);
  */
 uint32_t get_width(gamma_t *g);
 
+/** @brief Daje informacje o ilosci graczy.
+ * Daje informacje o ilosci graczy.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry.
+ * @return wartosc typu uint32_t przekazujaca informacje zwrotna.
+ */
+uint32_t get_players(gamma_t *g);
+
+/** @brief Daje informacje o maksymalnej liczbie obszarow gracza.
+ * Daje informacje o maksymalnej liczbie obszarow gracza.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry.
+ * @return wartosc typu uint32_t przekazujaca informacje zwrotna.
+ */
+uint32_t get_areas(gamma_t *g);
+
 /** @brief Daje informacje o ilosci pol zajetej przez gracza.
  * Daje informacje o szerokosci planszy.
  * @param[in] g       – wskaźnik na strukturę przechowującą stan gry.
@@ -145,5 +490,89 @@ uint32_t get_width(gamma_t *g);
  */
 uint64_t fields_taken_by_player(gamma_t *g, uint32_t player);
 
+/** @brief Podlacza dziennik ruchow do gry.
+ * Od tej chwili kazdy legalny ruch i zloty ruch na grze @p g jest
+ * dopisywany do dziennika @p log przed wykonaniem; ruch, ktorego nie udalo
+ * sie dopisac, nie jest wykonywany. Gra nie przejmuje wlasnosci dziennika,
+ * ale utrwala go przy usuwaniu; wywolujacy musi go zamknac funkcja
+ * @ref move_log_close po usunieciu gry lub po odlaczeniu dziennika.
+ * Podanie NULL odlacza dziennik.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] log     – wskaznik na otwarty dziennik lub NULL.
+ */
+void gamma_attach_log(gamma_t *g, move_log_t *log);
+
+/**
+ * Opis jednej zmiany planszy wykonanej przez udany ruch lub zloty ruch.
+ */
+typedef struct gamma_change {
+    uint64_t seq; ///< numer zmiany w grze, kolejne zmiany maja kolejne numery od 1
+    uint8_t kind; ///< @ref MOVE_LOG_MOVE lub @ref MOVE_LOG_GOLDEN_MOVE
+    uint32_t x; ///< numer kolumny zmienionego pola
+    uint32_t y; ///< numer wiersza zmienionego pola
+    uint32_t old_owner; ///< poprzedni wlasciciel pola, 0 dla zwyklego ruchu
+    uint32_t new_owner; ///< nowy wlasciciel pola
+    uint64_t old_owner_areas; /**< ilosc obszarow poprzedniego wlasciciela
+                               * po zmianie, 0 dla zwyklego ruchu **/
+    uint64_t new_owner_areas; ///< ilosc obszarow nowego wlasciciela po zmianie
+} gamma_change_t;
+
+/** @brief Funkcja powiadamiana o zmianach planszy.
+ * @param[in,out] ctx - kontekst podany przy subskrypcji,
+ * @param[in] change - opis zmiany, wazny tylko w trakcie wywolania.
+ */
+typedef void (*gamma_change_fn)(void *ctx, const gamma_change_t *change);
+
+/** @brief Subskrybuje zmiany planszy.
+ * Po kazdym udanym @ref gamma_move i @ref gamma_golden_move funkcja @p fn
+ * jest wywolywana w watku wykonujacym ruch, po zakonczeniu zmiany stanu gry,
+ * wiec moze czytac stan gry, ale nie moze wykonywac ruchow ani zmieniac
+ * subskrypcji. Subskrybenci sa powiadamiani w kolejnosci subskrypcji.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] fn      – funkcja powiadamiana o zmianach,
+ * @param[in] ctx     – kontekst przekazywany do @p fn.
+ * @return Dodatni numer subskrypcji lub 0, jesli nie udalo sie zaalokowac
+ * pamieci lub któryś z parametrów jest niepoprawny.
+ */
+uint32_t gamma_subscribe(gamma_t *g, gamma_change_fn fn, void *ctx);
+
+/** @brief Konczy subskrypcje zmian planszy.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] id      – numer subskrypcji zwrocony przez @ref gamma_subscribe.
+ * @return Wartosc @p true, jesli subskrypcja istniala, @p false w przeciwnym
+ * przypadku.
+ */
+bool gamma_unsubscribe(gamma_t *g, uint32_t id);
+
+/** @brief Odtwarza gre z dziennika ruchow.
+ * Tworzy gre o parametrach zapisanych w naglowku dziennika @p path
+ * i wykonuje na niej wszystkie zapisane w nim ruchy.
+ * Zwrocona gra nie ma podlaczonego dziennika.
+ * @param[in] path    – sciezka do pliku dziennika.
+ * @return Wskaźnik na odtworzona strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci, plik nie istnieje lub dziennik jest niespojny.
+ */
+gamma_t* gamma_replay(const char *path);
+
+/** @brief Tworzy gre z dziennikiem ruchow lub wznawia ja z dziennika.
+ * Otwiera dziennik @p path funkcja @ref move_log_open. Jesli dziennik
+ * zawiera juz ruchy, odtwarza je tak jak @ref gamma_replay, wiec gra
+ * wznawia sie w stanie sprzed zakonczenia lub awarii procesu. Dziennik
+ * nalezy do gry i jest zamykany przez @ref gamma_delete.
+ * @param[in] path    – sciezka do pliku dziennika,
+ * @param[in] width   – szerokość planszy, liczba dodatnia,
+ * @param[in] height  – wysokość planszy, liczba dodatnia,
+ * @param[in] players – liczba graczy, liczba dodatnia,
+ * @param[in] areas   – maksymalna liczba obszarów,
+ *                      jakie może zająć jeden gracz,
+ * @param[in] sync_every_moves – limit zbuforowanych ruchow dziennika,
+ * @param[in] sync_every_ms    – limit czasu od ostatniego zapisu dziennika.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udalo sie
+ * otworzyc dziennika, jego parametry sa inne niz podane, jest niespojny
+ * lub nie udało się zaalokować pamięci.
+ */
+gamma_t* gamma_new_logged(const char *path, uint32_t width, uint32_t height,
+                          uint32_t players, uint32_t areas,
+                          uint32_t sync_every_moves, uint32_t sync_every_ms);
 
 #endif /* GAMMA_H */
\ No newline at end of file
@@ -0,0 +1,723 @@
+/** @file
+ * Program mierzacy wydajnosc funkcji z interfejsu gamma.h
+ *
+ * Uzycie: gamma_bench [--seed N] [--scale N] [--repeat N] [--only NAZWA]
+ *                     [--baseline PLIK] [--max-regression PROCENT]
+ *                     [--counters 0|1]
+ *
+ * Dla kazdego scenariusza i kazdej funkcji wypisuje na standardowe wyjscie
+ * linie w formacie TSV: nazwe scenariusza, nazwe funkcji, liczbe wywolan,
+ * sredni czas wywolania w nanosekundach, liczbe wywolan na sekunde i sume
+ * kontrolna wynikow. Wyjscie zapisane do pliku moze byc pozniej podane
+ * jako @p --baseline; wtedy dla kazdej linii dopisywany jest czas z pliku
+ * i przyspieszenie, a roznica sum kontrolnych jest zglaszana jako blad,
+ * bo oznacza, ze zmienilo sie zachowanie silnika.
+ *
+ * Z opcja @p --counters 1 kazda linia zawiera dodatkowo srednie wartosci
+ * sprzetowych licznikow wydajnosci na jedno wywolanie (cykle, instrukcje,
+ * instrukcje na cykl, chybienia L1 danych i ostatniego poziomu pamieci
+ * podrecznej, blednie przewidziane skoki) lub '-' dla licznikow,
+ * ktorych nie udalo sie odczytac.
+ *
+ * Wszystkie scenariusze sa generowane deterministycznie z ziarna @p --seed.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "gamma.h"
+#include "perf_counters.h"
+
+#define BENCH_MAX_BASELINE 256 ///< maksymalna liczba linii pliku bazowego
+#define BENCH_NAME_LENGTH 64 ///< maksymalna dlugosc nazwy w pliku bazowym
+
+/** Mierzone funkcje interfejsu gamma.h. */
+enum bench_op_id {
+    OP_NEW, ///< gamma_new
+    OP_MOVE, ///< gamma_move
+    OP_GOLDEN_MOVE, ///< gamma_golden_move
+    OP_BUSY_FIELDS, ///< gamma_busy_fields
+    OP_FREE_FIELDS, ///< gamma_free_fields
+    OP_GOLDEN_POSSIBLE, ///< gamma_golden_possible
+    OP_BOARD, ///< gamma_board
+    OP_DELETE, ///< gamma_delete
+    NUMBER_OF_OPS ///< liczba mierzonych funkcji
+};
+
+/** Nazwy mierzonych funkcji w kolejnosci @ref bench_op_id. */
+static const char *op_names[NUMBER_OF_OPS] = {
+    "gamma_new", "gamma_move", "gamma_golden_move", "gamma_busy_fields",
+    "gamma_free_fields", "gamma_golden_possible", "gamma_board", "gamma_delete"
+};
+
+/** @struct bench_op
+ * @brief Wynik pomiaru jednej funkcji w jednym scenariuszu.
+ */
+typedef struct bench_op {
+    uint64_t calls; ///< liczba wywolan
+    uint64_t ns; ///< laczny czas wywolan
+    uint64_t checksum; ///< suma kontrolna wynikow
+    uint64_t counters[PERF_NUMBER_OF_COUNTERS]; /**< laczne wartosci licznikow
+                                                  * sprzetowych lub
+                                                  * @ref PERF_UNAVAILABLE **/
+} bench_op_t;
+
+/** @struct bench_run
+ * @brief Stan jednego przebiegu scenariusza.
+ */
+typedef struct bench_run {
+    bench_op_t ops[NUMBER_OF_OPS]; ///< wyniki pomiarow funkcji
+    uint64_t rng; ///< stan generatora liczb pseudolosowych
+    uint64_t started_ns; ///< poczatek trwajacego pomiaru
+} bench_run_t;
+
+/** @struct bench_move
+ * @brief Argumenty jednego wywolania ruchu.
+ */
+typedef struct bench_move {
+    uint32_t player; ///< numer gracza
+    uint32_t x; ///< numer kolumny
+    uint32_t y; ///< numer wiersza
+} bench_move_t;
+
+/** @struct baseline_entry
+ * @brief Jedna linia pliku bazowego.
+ */
+typedef struct baseline_entry {
+    char workload[BENCH_NAME_LENGTH]; ///< nazwa scenariusza
+    char op[BENCH_NAME_LENGTH]; ///< nazwa funkcji
+    double ns_per_op; ///< sredni czas wywolania
+    uint64_t checksum; ///< suma kontrolna wynikow
+} baseline_entry_t;
+
+/** Parametry wywolania programu. */
+static struct {
+    uint64_t seed; ///< ziarno generatora
+    uint32_t scale; ///< mnoznik rozmiaru scenariuszy
+    uint32_t repeat; ///< liczba powtorzen scenariusza, wypisywany jest najlepszy
+    const char *only; ///< nazwa jedynego uruchamianego scenariusza lub NULL
+    baseline_entry_t baseline[BENCH_MAX_BASELINE]; ///< wczytany plik bazowy
+    uint32_t baseline_size; ///< liczba linii pliku bazowego
+    double max_regression; ///< dopuszczalne spowolnienie w procentach lub < 0
+    bool failed; ///< czy ktores porownanie z plikiem bazowym sie nie powiodlo
+    bool counters; ///< czy wypisywac wartosci licznikow sprzetowych
+    perf_counters_t *perf; ///< otwarte liczniki sprzetowe lub NULL
+} options = { .seed = 1, .scale = 1, .repeat = 1, .max_regression = -1.0 };
+
+/** @brief Podaje czas zegara monotonicznego w nanosekundach.
+ * @return czas w nanosekundach.
+ */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+/** @brief Generator splitmix64.
+ * @param[in,out] state - stan generatora.
+ * @return kolejna liczba pseudolosowa.
+ */
+static uint64_t next_random(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15u);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9u;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBu;
+    return z ^ (z >> 31);
+}
+
+/** @brief Losuje liczbe z przedzialu [0, bound).
+ * @param[in,out] run - przebieg, ktorego generator jest uzywany,
+ * @param[in] bound - gorne ograniczenie, liczba dodatnia.
+ * @return wylosowana liczba.
+ */
+static uint32_t random_below(bench_run_t *run, uint32_t bound) {
+    return (uint32_t) (((next_random(&run->rng) >> 32) * bound) >> 32);
+}
+
+/** @brief Rozpoczyna pomiar.
+ * @param[in,out] run - przebieg scenariusza.
+ */
+static void op_begin(bench_run_t *run) {
+    if(options.perf != NULL) perf_counters_start(options.perf);
+    run->started_ns = now_ns();
+}
+
+/** @brief Konczy pomiar i dolicza go do wyniku funkcji.
+ * @param[in,out] run - przebieg scenariusza,
+ * @param[in] op - mierzona funkcja,
+ * @param[in] calls - liczba wywolan w pomiarze,
+ * @param[in] checksum - suma kontrolna wynikow wywolan.
+ */
+static void op_end(bench_run_t *run, enum bench_op_id op, uint64_t calls,
+                   uint64_t checksum) {
+    uint64_t elapsed = now_ns() - run->started_ns;
+    uint64_t counters[PERF_NUMBER_OF_COUNTERS];
+    if(options.perf != NULL) {
+        perf_counters_stop(options.perf, counters);
+    }
+    for(int i = 0; i < PERF_NUMBER_OF_COUNTERS; ++i) {
+        if(options.perf == NULL || counters[i] == PERF_UNAVAILABLE
+           || run->ops[op].counters[i] == PERF_UNAVAILABLE) {
+            run->ops[op].counters[i] = PERF_UNAVAILABLE;
+        }
+        else {
+            run->ops[op].counters[i] += counters[i];
+        }
+    }
+    run->ops[op].ns += elapsed;
+    run->ops[op].calls += calls;
+    run->ops[op].checksum = run->ops[op].checksum * 31 + checksum;
+}
+
+/** @brief Tworzy gre i mierzy czas gamma_new.
+ * @param[in,out] run - przebieg scenariusza,
+ * @param[in] width - szerokosc planszy,
+ * @param[in] height - wysokosc planszy,
+ * @param[in] players - liczba graczy,
+ * @param[in] areas - maksymalna liczba obszarow.
+ * @return wskaznik na utworzona gre lub NULL.
+ */
+static gamma_t *timed_new(bench_run_t *run, uint32_t width, uint32_t height,
+                          uint32_t players, uint32_t areas) {
+    op_begin(run);
+    gamma_t *g = gamma_new(width, height, players, areas);
+    op_end(run, OP_NEW, 1, g != NULL);
+    return g;
+}
+
+/** @brief Usuwa gre i mierzy czas gamma_delete.
+ * @param[in,out] run - przebieg scenariusza,
+ * @param[in] g - usuwana gra.
+ */
+static void timed_delete(bench_run_t *run, gamma_t *g) {
+    op_begin(run);
+    gamma_delete(g);
+    op_end(run, OP_DELETE, 1, 0);
+}
+
+/** @brief Wykonuje i mierzy ciag ruchow.
+ * @param[in,out] run - przebieg scenariusza,
+ * @param[in,out] g - gra,
+ * @param[in] moves - ruchy,
+ * @param[in] n - liczba ruchow,
+ * @param[in] golden - czy ruchy sa zlotymi ruchami.
+ */
+static void timed_moves(bench_run_t *run, gamma_t *g, const bench_move_t *moves,
+                        uint64_t n, bool golden) {
+    uint64_t successes = 0;
+    op_begin(run);
+    if(golden) {
+        for(uint64_t i = 0; i < n; ++i) {
+            successes += gamma_golden_move(g, moves[i].player, moves[i].x,
+                                           moves[i].y);
+        }
+    }
+    else {
+        for(uint64_t i = 0; i < n; ++i) {
+            successes += gamma_move(g, moves[i].player, moves[i].x, moves[i].y);
+        }
+    }
+    op_end(run, golden ? OP_GOLDEN_MOVE : OP_MOVE, n, successes);
+}
+
+/** @brief Wykonuje i mierzy zapytania o graczy.
+ * Dla kazdego gracza z tablicy wywoluje gamma_busy_fields,
+ * gamma_golden_possible oraz, dla pierwszych @p free_calls graczy,
+ * gamma_free_fields.
+ * @param[in,out] run - przebieg scenariusza,
+ * @param[in,out] g - gra,
+ * @param[in] players - numery graczy,
+ * @param[in] n - liczba graczy w tablicy,
+ * @param[in] free_calls - liczba wywolan gamma_free_fields.
+ */
+static void timed_queries(bench_run_t *run, gamma_t *g, const uint32_t *players,
+                          uint64_t n, uint64_t free_calls) {
+    uint64_t sum = 0;
+    op_begin(run);
+    for(uint64_t i = 0; i < n; ++i) {
+        sum += gamma_busy_fields(g, players[i]);
+    }
+    op_end(run, OP_BUSY_FIELDS, n, sum);
+
+    sum = 0;
+    op_begin(run);
+    for(uint64_t i = 0; i < n; ++i) {
+        sum += gamma_golden_possible(g, players[i]);
+    }
+    op_end(run, OP_GOLDEN_POSSIBLE, n, sum);
+
+    if(free_calls > n) free_calls = n;
+    sum = 0;
+    op_begin(run);
+    for(uint64_t i = 0; i < free_calls; ++i) {
+        sum += gamma_free_fields(g, players[i]);
+    }
+    op_end(run, OP_FREE_FIELDS, free_calls, sum);
+}
+
+/** @brief Wykonuje i mierzy wywolania gamma_board.
+ * @param[in,out] run - przebieg scenariusza,
+ * @param[in,out] g - gra,
+ * @param[in] n - liczba wywolan.
+ */
+static void timed_board(bench_run_t *run, gamma_t *g, uint64_t n) {
+    uint64_t sum = 0;
+    op_begin(run);
+    for(uint64_t i = 0; i < n; ++i) {
+        char *b = gamma_board(g);
+        if(b != NULL) {
+            sum += strlen(b) + (uint8_t) b[0];
+        }
+        free(b);
+    }
+    op_end(run, OP_BOARD, n, sum);
+}
+
+/** @brief Losuje ruchy o jednostajnie rozlozonych argumentach.
+ * @param[in,out] run - przebieg scenariusza,
+ * @param[in] n - liczba ruchow,
+ * @param[in] width - szerokosc planszy,
+ * @param[in] height - wysokosc planszy,
+ * @param[in] players - liczba graczy.
+ * @return tablica ruchow lub NULL, gdy nie udalo sie zaalokowac pamieci.
+ */
+static bench_move_t *random_moves(bench_run_t *run, uint64_t n, uint32_t width,
+                                  uint32_t height, uint32_t players) {
+    bench_move_t *moves = malloc(n * sizeof(bench_move_t));
+    if(moves == NULL) return NULL;
+    for(uint64_t i = 0; i < n; ++i) {
+        moves[i].player = 1 + random_below(run, players);
+        moves[i].x = random_below(run, width);
+        moves[i].y = random_below(run, height);
+    }
+    return moves;
+}
+
+/** @brief Losuje numery graczy.
+ * @param[in,out] run - przebieg scenariusza,
+ * @param[in] n - liczba numerow,
+ * @param[in] players - liczba graczy.
+ * @return tablica numerow lub NULL, gdy nie udalo sie zaalokowac pamieci.
+ */
+static uint32_t *random_players(bench_run_t *run, uint64_t n, uint32_t players) {
+    uint32_t *result = malloc(n * sizeof(uint32_t));
+    if(result == NULL) return NULL;
+    for(uint64_t i = 0; i < n; ++i) {
+        result[i] = 1 + random_below(run, players);
+    }
+    return result;
+}
+
+/** @brief Scenariusz ogolny: losowe ruchy i zapytania na sredniej planszy.
+ * @param[in,out] run - przebieg scenariusza,
+ * @param[in] scale - mnoznik rozmiaru.
+ * @return @p true, jesli scenariusz sie wykonal.
+ */
+static bool workload_random_fill(bench_run_t *run, uint32_t scale) {
+    uint32_t side = 256 * scale, players = 8, areas = 32;
+    uint64_t n = 4 * (uint64_t) side * side;
+    bench_move_t *moves = random_moves(run, n, side, side, players);
+    bench_move_t *golden = random_moves(run, 20000, side, side, players);
+    uint32_t *queries = random_players(run, 200000, players);
+    gamma_t *g = timed_new(run, side, side, players, areas);
+    bool ok = (moves != NULL && golden != NULL && queries != NULL && g != NULL);
+    if(ok) {
+        timed_moves(run, g, moves, n, false);
+        timed_moves(run, g, golden, 20000, true);
+        timed_queries(run, g, queries, 200000, 200);
+        timed_board(run, g, 10);
+    }
+    if(g != NULL) timed_delete(run, g);
+    free(moves);
+    free(golden);
+    free(queries);
+    return ok;
+}
+
+/** @brief Scenariusz z graczami na limicie obszarow.
+ * Kazdy gracz ma jeden obszar, wiec gamma_free_fields przeglada cala plansze.
+ * @param[in,out] run - przebieg scenariusza,
+ * @param[in] scale - mnoznik rozmiaru.
+ * @return @p true, jesli scenariusz sie wykonal.
+ */
+static bool workload_area_limit(bench_run_t *run, uint32_t scale) {
+    uint32_t side = 256 * scale, players = 4, areas = 1;
+    uint64_t n = 2 * (uint64_t) side * side;
+    bench_move_t *moves = random_moves(run, n, side, side, players);
+    uint32_t *queries = random_players(run, 2000, players);
+    gamma_t *g = timed_new(run, side, side, players, areas);
+    bool ok = (moves != NULL && queries != NULL && g != NULL);
+    if(ok) {
+        timed_moves(run, g, moves, n, false);
+        timed_queries(run, g, queries, 2000, 2000);
+        timed_board(run, g, 10);
+    }
+    if(g != NULL) timed_delete(run, g);
+    free(moves);
+    free(queries);
+    return ok;
+}
+
+/** @brief Buduje sciezke weza: pelne parzyste wiersze polaczone na
+ * przemian przy prawej i lewej krawedzi.
+ * @param[in] side - bok planszy,
+ * @param[out] path - tablica na co najmniej side * side ruchow,
+ * @return dlugosc sciezki.
+ */
+static uint64_t snake_path(uint32_t side, bench_move_t *path) {
+    uint64_t n = 0;
+    for(uint32_t y = 0; y < side; y += 2) {
+        bool to_right = (y / 2) % 2 == 0;
+        for(uint32_t i = 0; i < side; ++i) {
+            path[n++] = (bench_move_t) { 1, to_right ? i : side - 1 - i, y };
+        }
+        if(y + 2 < side) {
+            path[n++] = (bench_move_t) { 1, to_right ? side - 1 : 0, y + 1 };
+        }
+    }
+    return n;
+}
+
+/** @brief Buduje sciezke spirali z odstepem jednego pola miedzy zwojami.
+ * @param[in] side - bok planszy,
+ * @param[out] path - tablica na co najmniej side * side ruchow,
+ * @return dlugosc sciezki.
+ */
+static uint64_t spiral_path(uint32_t side, bench_move_t *path) {
+    static const int dx[] = { 1, 0, -1, 0 }, dy[] = { 0, 1, 0, -1 };
+    int64_t x = 0, y = 0;
+    uint64_t n = 0;
+    path[n++] = (bench_move_t) { 1, 0, 0 };
+    /* Pierwsze trzy odcinki tworza zewnetrzny zwoj, a kazde dwa nastepne
+     * sa o dwa pola krotsze od dwoch poprzednich. */
+    for(int64_t segment = 0; ; ++segment) {
+        int64_t length = (int64_t) side - 1
+                         - (segment == 0 ? 0 : 2 * ((segment - 1) / 2));
+        if(length <= 0) break;
+        int d = (int) (segment % 4);
+        for(int64_t i = 0; i < length; ++i) {
+            x += dx[d];
+            y += dy[d];
+            path[n++] = (bench_move_t) { 1, (uint32_t) x, (uint32_t) y };
+        }
+    }
+    return n;
+}
+
+/** @brief Scenariusz z jednym bardzo dlugim obszarem.
+ * Gracz 1 zajmuje sciezke o jednym obszarze, a gracz 2 probuje zlotych
+ * ruchow na jej polach. Kazda proba przeszukuje caly obszar.
+ * @param[in,out] run - przebieg scenariusza,
+ * @param[in] scale - mnoznik rozmiaru,
+ * @param[in] spiral - czy sciezka jest spirala, a nie wezem.
+ * @return @p true, jesli scenariusz sie wykonal.
+ */
+static bool workload_long_region(bench_run_t *run, uint32_t scale, bool spiral) {
+    uint32_t side = 128 * scale;
+    uint64_t cells = (uint64_t) side * side;
+    bench_move_t *path = malloc(cells * sizeof(bench_move_t));
+    bench_move_t *golden = malloc(500 * sizeof(bench_move_t));
+    uint32_t *queries = random_players(run, 2000, 2);
+    gamma_t *g = timed_new(run, side, side, 2, 1);
+    bool ok = (path != NULL && golden != NULL && queries != NULL && g != NULL);
+    if(ok) {
+        uint64_t n = spiral ? spiral_path(side, path) : snake_path(side, path);
+        timed_moves(run, g, path, n, false);
+        for(int i = 0; i < 500; ++i) {
+            golden[i] = path[1 + random_below(run, (uint32_t) n - 2)];
+            golden[i].player = 2;
+        }
+        timed_moves(run, g, golden, 500, true);
+        timed_queries(run, g, queries, 2000, 200);
+        timed_board(run, g, 10);
+    }
+    if(g != NULL) timed_delete(run, g);
+    free(path);
+    free(golden);
+    free(queries);
+    return ok;
+}
+
+/** @brief Scenariusz z wielka, prawie pusta plansza.
+ * @param[in,out] run - przebieg scenariusza,
+ * @param[in] scale - mnoznik rozmiaru.
+ * @return @p true, jesli scenariusz sie wykonal.
+ */
+static bool workload_huge_sparse(bench_run_t *run, uint32_t scale) {
+    uint32_t side = 2048 * scale, players = 16, areas = 1000000;
+    bench_move_t *moves = random_moves(run, 100000, side, side, players);
+    bench_move_t *golden = random_moves(run, 1000, side, side, players);
+    uint32_t *queries = random_players(run, 100000, players);
+    gamma_t *g = timed_new(run, side, side, players, areas);
+    bool ok = (moves != NULL && golden != NULL && queries != NULL && g != NULL);
+    if(ok) {
+        timed_moves(run, g, moves, 100000, false);
+        timed_moves(run, g, golden, 1000, true);
+        timed_queries(run, g, queries, 100000, 100000);
+        timed_board(run, g, 1);
+    }
+    if(g != NULL) timed_delete(run, g);
+    free(moves);
+    free(golden);
+    free(queries);
+    return ok;
+}
+
+/** @brief Scenariusz z bardzo duza liczba graczy.
+ * @param[in,out] run - przebieg scenariusza,
+ * @param[in] scale - mnoznik rozmiaru.
+ * @return @p true, jesli scenariusz sie wykonal.
+ */
+static bool workload_many_players(bench_run_t *run, uint32_t scale) {
+    uint32_t side = 256 * scale, players = 1000000, areas = 4;
+    uint64_t n = 200000;
+    bench_move_t *moves = random_moves(run, n, side, side, players);
+    bench_move_t *golden = random_moves(run, 2000, side, side, players);
+    uint32_t *queries = random_players(run, 100000, players);
+    gamma_t *g = timed_new(run, side, side, players, areas);
+    bool ok = (moves != NULL && golden != NULL && queries != NULL && g != NULL);
+    if(ok) {
+        timed_moves(run, g, moves, n, false);
+        timed_moves(run, g, golden, 2000, true);
+        timed_queries(run, g, queries, 100000, 200);
+        timed_board(run, g, 10);
+    }
+    if(g != NULL) timed_delete(run, g);
+    free(moves);
+    free(golden);
+    free(queries);
+    return ok;
+}
+
+/** @brief Scenariusz weza, patrz @ref workload_long_region.
+ * @param[in,out] run - przebieg scenariusza,
+ * @param[in] scale - mnoznik rozmiaru.
+ * @return @p true, jesli scenariusz sie wykonal.
+ */
+static bool workload_snake(bench_run_t *run, uint32_t scale) {
+    return workload_long_region(run, scale, false);
+}
+
+/** @brief Scenariusz spirali, patrz @ref workload_long_region.
+ * @param[in,out] run - przebieg scenariusza,
+ * @param[in] scale - mnoznik rozmiaru.
+ * @return @p true, jesli scenariusz sie wykonal.
+ */
+static bool workload_spiral(bench_run_t *run, uint32_t scale) {
+    return workload_long_region(run, scale, true);
+}
+
+/** @struct workload
+ * @brief Opis scenariusza.
+ */
+typedef struct workload {
+    const char *name; ///< nazwa scenariusza
+    bool (*run)(bench_run_t *, uint32_t); ///< funkcja wykonujaca scenariusz
+} workload_t;
+
+/** Wszystkie scenariusze w kolejnosci wykonywania. */
+static const workload_t workloads[] = {
+    { "random_fill", workload_random_fill },
+    { "area_limit", workload_area_limit },
+    { "snake", workload_snake },
+    { "spiral", workload_spiral },
+    { "huge_sparse", workload_huge_sparse },
+    { "many_players", workload_many_players },
+};
+
+/** @brief Wyszukuje linie pliku bazowego.
+ * @param[in] workload - nazwa scenariusza,
+ * @param[in] op - nazwa funkcji.
+ * @return wskaznik na linie lub NULL.
+ */
+static const baseline_entry_t *find_baseline(const char *workload, const char *op) {
+    for(uint32_t i = 0; i < options.baseline_size; ++i) {
+        if(strcmp(options.baseline[i].workload, workload) == 0
+           && strcmp(options.baseline[i].op, op) == 0) {
+            return &options.baseline[i];
+        }
+    }
+    return NULL;
+}
+
+/** @brief Wczytuje plik bazowy.
+ * @param[in] path - sciezka pliku.
+ * @return @p true, jesli plik udalo sie wczytac.
+ */
+static bool load_baseline(const char *path) {
+    FILE *f = fopen(path, "r");
+    if(f == NULL) return false;
+    char *line = NULL;
+    size_t size = 0;
+    while(getline(&line, &size, f) != -1 && options.baseline_size < BENCH_MAX_BASELINE) {
+        baseline_entry_t *e = &options.baseline[options.baseline_size];
+        uint64_t calls;
+        double ops_per_s;
+        if(line[0] != '#' && sscanf(line, "%63s %63s %" SCNu64 " %lf %lf %" SCNu64,
+                                    e->workload, e->op, &calls, &e->ns_per_op,
+                                    &ops_per_s, &e->checksum) == 6) {
+            options.baseline_size++;
+        }
+    }
+    free(line);
+    fclose(f);
+    return true;
+}
+
+/** @brief Wypisuje srednia wartosc licznika na jedno wywolanie.
+ * @param[in] r - wynik pomiaru funkcji,
+ * @param[in] counter - indeks licznika.
+ */
+static void report_counter(const bench_op_t *r, int counter) {
+    if(r->counters[counter] == PERF_UNAVAILABLE) {
+        printf("\t-");
+    }
+    else {
+        printf("\t%.2f", (double) r->counters[counter] / (double) r->calls);
+    }
+}
+
+/** @brief Wypisuje wartosci licznikow sprzetowych na jedno wywolanie.
+ * @param[in] r - wynik pomiaru funkcji.
+ */
+static void report_counters(const bench_op_t *r) {
+    report_counter(r, PERF_CYCLES);
+    report_counter(r, PERF_INSTRUCTIONS);
+    if(r->counters[PERF_CYCLES] == PERF_UNAVAILABLE
+       || r->counters[PERF_INSTRUCTIONS] == PERF_UNAVAILABLE
+       || r->counters[PERF_CYCLES] == 0) {
+        printf("\t-");
+    }
+    else {
+        printf("\t%.2f", (double) r->counters[PERF_INSTRUCTIONS]
+                         / (double) r->counters[PERF_CYCLES]);
+    }
+    report_counter(r, PERF_L1D_MISSES);
+    report_counter(r, PERF_LLC_MISSES);
+    report_counter(r, PERF_BRANCH_MISSES);
+}
+
+/** @brief Wypisuje wyniki scenariusza.
+ * @param[in] name - nazwa scenariusza,
+ * @param[in] best - najlepsze wyniki ze wszystkich powtorzen.
+ */
+static void report(const char *name, const bench_run_t *best) {
+    for(int op = 0; op < NUMBER_OF_OPS; ++op) {
+        const bench_op_t *r = &best->ops[op];
+        if(r->calls == 0) continue;
+        double ns_per_op = (double) r->ns / (double) r->calls;
+        double ops_per_s = r->ns == 0 ? 0.0 : 1e9 * (double) r->calls / (double) r->ns;
+        printf("%s\t%s\t%" PRIu64 "\t%.1f\t%.0f\t%" PRIu64,
+               name, op_names[op], r->calls, ns_per_op, ops_per_s, r->checksum);
+        if(options.counters) {
+            report_counters(r);
+        }
+
+        const baseline_entry_t *base = find_baseline(name, op_names[op]);
+        if(base != NULL) {
+            double speedup = ns_per_op == 0.0 ? 0.0 : base->ns_per_op / ns_per_op;
+            printf("\t%.1f\t%.2f", base->ns_per_op, speedup);
+            if(base->checksum != r->checksum) {
+                printf("\tCHECKSUM_MISMATCH");
+                options.failed = true;
+            }
+            else if(options.max_regression >= 0.0 && ns_per_op
+                    > base->ns_per_op * (1.0 + options.max_regression / 100.0)) {
+                printf("\tREGRESSION");
+                options.failed = true;
+            }
+        }
+        printf("\n");
+    }
+    fflush(stdout);
+}
+
+/** @brief Wypisuje sposob uzycia programu.
+ * @param[in] program - nazwa programu.
+ * @return kod bledu programu.
+ */
+static int usage(const char *program) {
+    fprintf(stderr, "usage: %s [--seed N] [--scale N] [--repeat N] [--only NAME]"
+                    " [--baseline FILE] [--max-regression PERCENT]"
+                    " [--counters 0|1]\n", program);
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    for(int i = 1; i < argc; ++i) {
+        if(i + 1 >= argc) return usage(argv[0]);
+        const char *value = argv[++i];
+        if(strcmp(argv[i - 1], "--seed") == 0) {
+            options.seed = strtoull(value, NULL, 10);
+        }
+        else if(strcmp(argv[i - 1], "--scale") == 0) {
+            options.scale = (uint32_t) strtoul(value, NULL, 10);
+        }
+        else if(strcmp(argv[i - 1], "--repeat") == 0) {
+            options.repeat = (uint32_t) strtoul(value, NULL, 10);
+        }
+        else if(strcmp(argv[i - 1], "--only") == 0) {
+            options.only = value;
+        }
+        else if(strcmp(argv[i - 1], "--baseline") == 0) {
+            if(!load_baseline(value)) {
+                perror(value);
+                return 1;
+            }
+        }
+        else if(strcmp(argv[i - 1], "--max-regression") == 0) {
+            options.max_regression = strtod(value, NULL);
+        }
+        else if(strcmp(argv[i - 1], "--counters") == 0) {
+            options.counters = (strtoul(value, NULL, 10) != 0);
+        }
+        else {
+            return usage(argv[0]);
+        }
+    }
+    if(options.scale == 0 || options.repeat == 0) return usage(argv[0]);
+
+    if(options.counters && !perf_counters_open(&options.perf)) {
+        fprintf(stderr, "%s: hardware counters unavailable\n", argv[0]);
+    }
+
+    printf("# gamma_bench seed=%" PRIu64 " scale=%u repeat=%u\n",
+           options.seed, options.scale, options.repeat);
+    printf("# workload\top\tcalls\tns_per_op\tops_per_s\tchecksum%s%s\n",
+           options.counters ? "\tcycles_per_op\tinstructions_per_op\tipc"
+                              "\tl1d_misses_per_op\tllc_misses_per_op"
+                              "\tbranch_misses_per_op" : "",
+           options.baseline_size > 0 ? "\tbaseline_ns_per_op\tspeedup" : "");
+
+    bool ok = true;
+    for(size_t w = 0; w < sizeof(workloads) / sizeof(workloads[0]); ++w) {
+        if(options.only != NULL && strcmp(options.only, workloads[w].name) != 0) {
+            continue;
+        }
+        bench_run_t best;
+        bool workload_ok = true;
+        for(uint32_t r = 0; r < options.repeat && workload_ok; ++r) {
+            bench_run_t run;
+            memset(&run, 0, sizeof(run));
+            run.rng = options.seed * 0x100000001B3u + w;
+            if(!workloads[w].run(&run, options.scale)) {
+                fprintf(stderr, "%s: out of memory\n", workloads[w].name);
+                ok = workload_ok = false;
+            }
+            for(int op = 0; op < NUMBER_OF_OPS; ++op) {
+                if(r == 0 || run.ops[op].ns < best.ops[op].ns) {
+                    best.ops[op] = run.ops[op];
+                }
+            }
+        }
+        if(workload_ok) report(workloads[w].name, &best);
+    }
+
+    perf_counters_close(options.perf);
+    return !ok ? 1 : (options.failed ? 2 : 0);
+}
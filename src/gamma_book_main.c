@@ -0,0 +1,197 @@
+/** @file
+ * Program budujacy ksiazke otwarc gry gamma
+ *
+ * Uzycie: gamma_book SZEROKOSC WYSOKOSC GRACZE OBSZARY RUCHY CZAS_MS PLIK
+ *
+ * Przeglada wszystkie pozycje osiagalne z pustej planszy w co najwyzej
+ * RUCHY-1 zwyklych ruchach, po jednej z kazdej klasy pozycji symetrycznych,
+ * i dla kazdej z nich wybiera najlepszy ruch solverem z limitem CZAS_MS
+ * milisekund na pozycje. Zapisuje ksiazke do PLIKU i wypisuje na
+ * standardowe wyjscie ilosc wpisow oraz ilosc pozycji z dokladnym wynikiem.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include "opening_book.h"
+#include "solver.h"
+
+#define BOOK_TABLE_BITS 22 ///< logarytm rozmiaru tablicy transpozycji solvera
+
+/** @struct book_builder
+ * @brief Stan budowania ksiazki.
+ */
+typedef struct book_builder {
+    solver_t *solver; ///< solver wybierajacy ruchy
+    uint64_t time_ms; ///< limit czasu na pozycje
+    opening_book_entry_t *entries; ///< zebrane wpisy
+    uint64_t count; ///< ilosc zebranych wpisow
+    uint64_t capacity; ///< rozmiar tablicy @p entries
+    uint64_t *seen; ///< zbior odwiedzonych kluczy, adresowany otwarcie
+    uint64_t seen_mask; ///< rozmiar zbioru pomniejszony o jeden
+    uint64_t exact; ///< ilosc pozycji z dokladnym wynikiem
+    const char *error; ///< opis bledu, ktory przerwal budowanie
+} book_builder_t;
+
+/** @brief Dopisuje klucz do zbioru odwiedzonych pozycji.
+ * Klucz 0 jest zastepowany przez 1, bo 0 oznacza wolne miejsce.
+ * @param[in,out] b - stan budowania,
+ * @param[in] key - klucz pozycji,
+ * @param[out] fresh - @p true, jesli klucza nie bylo w zbiorze.
+ * @return Wartosc @p false, jesli klucza nie bylo w zbiorze, a zbior
+ * jest pelny.
+ */
+static bool mark_seen(book_builder_t *b, uint64_t key, bool *fresh) {
+    if(key == 0) key = 1;
+    *fresh = false;
+    for(uint64_t i = 0; i <= b->seen_mask; ++i) {
+        uint64_t *slot = &b->seen[(key + i) & b->seen_mask];
+        if(*slot == key) return true;
+        if(*slot == 0) {
+            *slot = key;
+            *fresh = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief Dopisuje wpis ksiazki.
+ * @param[in,out] b - stan budowania,
+ * @param[in] entry - dopisywany wpis.
+ * @return Wartosc @p true, jesli udalo sie zaalokowac pamiec.
+ */
+static bool add_entry(book_builder_t *b, const opening_book_entry_t *entry) {
+    if(b->count == b->capacity) {
+        uint64_t capacity = (b->capacity == 0) ? 64 : 2 * b->capacity;
+        opening_book_entry_t *entries = realloc(b->entries,
+                                                sizeof(opening_book_entry_t) * capacity);
+        if(entries == NULL) return false;
+        b->entries = entries;
+        b->capacity = capacity;
+    }
+    b->entries[b->count++] = *entry;
+    return true;
+}
+
+/** @brief Dopisuje do ksiazki pozycje i pozycje osiagalne z niej.
+ * @param[in,out] b - stan budowania,
+ * @param[in] g - pozycja,
+ * @param[in] to_move - gracz wykonujacy ruch,
+ * @param[in] plies - ilosc ruchow, dla ktorych budowane sa wpisy.
+ * @return Wartosc @p true, jesli udalo sie zbudowac wpisy, w przeciwnym
+ * przypadku @p false i opis bledu w @p b->error.
+ */
+static bool build(book_builder_t *b, gamma_t *g, uint32_t to_move, uint32_t plies) {
+    if(plies == 0) return true;
+    uint32_t transform;
+    uint64_t key = gamma_canonical_hash(g, to_move, &transform);
+    bool fresh;
+    if(!mark_seen(b, key, &fresh)) {
+        b->error = "too many positions for the set of visited positions";
+        return false;
+    }
+    if(!fresh) return true;
+
+    solver_result_t result;
+    if(!solver_solve(b->solver, g, to_move, to_move, b->time_ms, &result, NULL)) {
+        b->error = "solver could not search the position";
+        return false;
+    }
+    /* Gracze bez ruchu sa pomijani, a klucz dotyczy gracza wykonujacego ruch. */
+    if(!result.has_move || result.to_move != to_move) return true;
+    opening_book_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.key = key;
+    gamma_transform_field(g, transform, result.x, result.y, &entry.x, &entry.y);
+    entry.flags = (result.golden ? OPENING_BOOK_GOLDEN : 0)
+                  | (result.exact ? OPENING_BOOK_EXACT : 0);
+    entry.depth = result.depth;
+    entry.value = result.value;
+    entry.nodes = result.nodes;
+    b->exact += result.exact;
+    gamma_t *child;
+    if(!add_entry(b, &entry) || (child = gamma_clone(g)) == NULL) {
+        b->error = "out of memory";
+        return false;
+    }
+    uint32_t next = to_move % get_players(g) + 1;
+    bool ok = true;
+    for(uint32_t x = 0; x < get_width(g) && ok; ++x) {
+        for(uint32_t y = 0; y < get_height(g) && ok; ++y) {
+            if(gamma_move(child, to_move, x, y)) {
+                ok = build(b, child, next, plies - 1);
+                gamma_copy(child, g);
+            }
+        }
+    }
+    gamma_delete(child);
+    return ok;
+}
+
+/** @brief Wczytuje dodatnia liczbe z argumentu programu.
+ * @param[in] text - argument,
+ * @param[out] value - wczytana liczba.
+ * @return Wartosc @p true, jesli argument jest dodatnia liczba
+ * mieszczaca sie w typie uint32_t.
+ */
+static bool parse_positive(const char *text, uint32_t *value) {
+    char *end;
+    unsigned long long parsed = strtoull(text, &end, 10);
+    if(*end != '\0' || text[0] == '\0' || text[0] == '-' || parsed == 0
+       || parsed > UINT32_MAX) {
+        return false;
+    }
+    *value = (uint32_t) parsed;
+    return true;
+}
+
+int main(int argc, char **argv) {
+    uint32_t width, height, players, areas, plies, time_ms;
+    if(argc != 8 || !parse_positive(argv[1], &width) || !parse_positive(argv[2], &height)
+       || !parse_positive(argv[3], &players) || !parse_positive(argv[4], &areas)
+       || !parse_positive(argv[5], &plies) || !parse_positive(argv[6], &time_ms)) {
+        fprintf(stderr, "usage: %s WIDTH HEIGHT PLAYERS AREAS PLIES TIME_MS FILE\n",
+                argv[0]);
+        return 1;
+    }
+
+    gamma_t *g = gamma_new(width, height, players, areas);
+    book_builder_t b;
+    memset(&b, 0, sizeof(b));
+    b.time_ms = time_ms;
+    b.seen_mask = (1u << 20) - 1;
+    b.seen = calloc(b.seen_mask + 1, sizeof(uint64_t));
+    bool ok = false;
+    if(g == NULL) {
+        fprintf(stderr, "%s: invalid game parameters\n", argv[0]);
+    }
+    else if((uint64_t) width * height > SOLVER_MAX_CELLS) {
+        fprintf(stderr, "%s: board has more than %u fields\n", argv[0],
+                SOLVER_MAX_CELLS);
+    }
+    else if(b.seen == NULL || !solver_init(&b.solver, BOOK_TABLE_BITS)) {
+        fprintf(stderr, "%s: out of memory\n", argv[0]);
+    }
+    else if(!build(&b, g, 1, plies)) {
+        fprintf(stderr, "%s: %s\n", argv[0], b.error);
+    }
+    else if(!opening_book_write(argv[7], g, b.entries, b.count)) {
+        perror(argv[7]);
+    }
+    else {
+        printf("%" PRIu64 " entries, %" PRIu64 " exact\n", b.count, b.exact);
+        ok = true;
+    }
+
+    delete_solver(b.solver);
+    free(b.seen);
+    free(b.entries);
+    gamma_delete(g);
+    return ok ? 0 : 1;
+}
@@ -1,8 +1,23 @@
 #include "batch_mode.h"
 #include "interactive_mode.h"
+#include "session_mode.h"
+
+#define SHARED_BOARD_ENV "GAMMA_SHM_BOARD" /**< zmienna srodowiskowa z nazwa
+                                             * segmentu pamieci wspoldzielonej
+                                             * na plansze gry **/
 
 int main() {
-    uint32_t *parsed_command = malloc(MAX_NUMBER_OF_COMMANDS * sizeof(uint32_t));
+    /* Plansza we wspoldzielonej pamieci nie jest odtwarzana z dziennika,
+     * wiec oba tryby naraz zgubilyby ruchy zapisane w dzienniku. */
+    const char *shared_name = getenv(SHARED_BOARD_ENV);
+    if(shared_name != NULL && shared_name[0] != '\0'
+       && batch_mode_log_path() != NULL) {
+        fprintf(stderr, "%s and GAMMA_LOG cannot be used together\n",
+                SHARED_BOARD_ENV);
+        return 1;
+    }
+
+    uint32_t *parsed_command = malloc(MAX_NUMBER_OF_SESSION_COMMANDS * sizeof(uint32_t));
     char *line = NULL;
     size_t size_of_line = 1;
     uint32_t line_count = 0;
@@ -10,9 +25,25 @@ int main() {
     gamma_t *board;
     while(getline(&line, &size_of_line, stdin) != EOF) {
 	line_count++;
+        char *words = strdup(line);
         process_line(line, parsed_command);
+        uint32_t *bots = NULL;
+        uint32_t bot_count = 0;
+        if(parsed_command[0] == INTERACTIVE_MODE
+           && (words == NULL || !process_bot_players(words, parsed_command[3], &bots, &bot_count))) {
+            parsed_command[0] = INCORRECT_COMMAND;
+        }
+        free(words);
         if(parsed_command[0] == BATCH_MODE || parsed_command[0] == INTERACTIVE_MODE) {
-            board = gamma_new(parsed_command[1], parsed_command[2], parsed_command[3], parsed_command[4]);
+            if(shared_name != NULL && shared_name[0] != '\0') {
+                board = gamma_new_shared(parsed_command[1], parsed_command[2],
+                                         parsed_command[3], parsed_command[4], shared_name);
+            }
+            else {
+                board = batch_mode_new_game(batch_mode_log_path(), parsed_command[1],
+                                            parsed_command[2], parsed_command[3],
+                                            parsed_command[4]);
+            }
             if(board == NULL) {
                 fprintf(stderr,"ERROR %u\n", line_count);
             }
@@ -23,16 +54,22 @@ int main() {
                     batch_mode_start(parsed_command, line_count, board);
                 }
                 else if (parsed_command[0] == INTERACTIVE_MODE) {
-                    interactive_mode_start(board, parsed_command[3]);
+                    interactive_mode_start(board, parsed_command[3], bots, bot_count);
                 }
 
+                free(bots);
                 break;
             }
         }
+        else if(parsed_command[0] == SESSION_MODE) {
+            printf("OK %u\n", line_count);
+            session_mode_start(parsed_command, line_count);
+            break;
+        }
         else if(parsed_command[0] != COMMENT && parsed_command[0] != EMPTY_LINE) {
             fprintf(stderr,"ERROR %u\n", line_count);
         }
-        
+        free(bots);
     }
 
     free(line);
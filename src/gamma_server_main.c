@@ -0,0 +1,50 @@
+/** @file
+ * Punkt wejscia serwera gry gamma
+ *
+ * Uzycie: gamma_server SCIEZKA_GNIAZDA [LICZBA_WATKOW [LIMIT_PAMIECI_GRY]]
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#include "server.h"
+#include <stdlib.h>
+#include <unistd.h>
+
+int main(int argc, char **argv) {
+    if(argc < 2 || argc > 4) {
+        fprintf(stderr, "usage: %s SOCKET_PATH [WORKERS [GAME_BUDGET_BYTES]]\n",
+                argv[0]);
+        return 1;
+    }
+
+    long workers = sysconf(_SC_NPROCESSORS_ONLN);
+    if(argc >= 3) {
+        char *end;
+        workers = strtol(argv[2], &end, 10);
+        if(*end != '\0' || workers <= 0 || workers > 1024) {
+            fprintf(stderr, "usage: %s SOCKET_PATH [WORKERS [GAME_BUDGET_BYTES]]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if(workers <= 0) workers = 1;
+
+    unsigned long long game_budget = 0;
+    if(argc == 4) {
+        char *end;
+        game_budget = strtoull(argv[3], &end, 10);
+        if(*end != '\0' || argv[3][0] == '-' || argv[3][0] == '\0') {
+            fprintf(stderr, "usage: %s SOCKET_PATH [WORKERS [GAME_BUDGET_BYTES]]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    if(!server_run(argv[1], (uint32_t) workers, (uint64_t) game_budget)) {
+        perror("gamma_server");
+        return 1;
+    }
+    return 0;
+}
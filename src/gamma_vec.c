@@ -0,0 +1,400 @@
+/** @file
+ * Implementacja interfejsu gamma_vec.h
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "gamma_vec.h"
+#include "thread_pool.h"
+
+#define VEC_PARALLEL_MIN_CELLS (1u << 16) /**< od jakiej lacznej ilosci pol
+                                            * wszystkich gier krok jest
+                                            * wykonywany rownolegle **/
+#define VEC_CHUNKS_PER_THREAD 4 ///< na ile fragmentow na watek dzielone sa gry
+
+/** @struct gamma_vec
+ * @brief Struktura przechowujaca stan wielu gier.
+ * Tablice maja po jednym fragmencie na gre, ustawionym w kolejnosci gier:
+ * plansze i drzewa maja po @p cells elementow na gre, a liczniki graczy po
+ * @p players + 1 elementow na gre, indeksowanych numerem gracza.
+ */
+struct gamma_vec {
+    uint32_t count; ///< liczba gier
+    uint32_t width; ///< szerokosc planszy
+    uint32_t height; ///< wysokosc planszy
+    uint32_t players; ///< liczba graczy
+    uint32_t areas; ///< maksymalna liczba obszarow gracza
+    uint32_t cells; ///< ilosc pol planszy
+    uint8_t *owner; ///< wlasciciele pol, 0 dla wolnego pola
+    uint16_t *parent; /**< ojcowie pol w drzewie find and union, okresleni
+                       * tylko dla zajetych pol **/
+    uint16_t *fields; ///< liczby pol graczy
+    uint16_t *player_areas; ///< liczby obszarow graczy
+    uint8_t *golden_used; ///< czy gracze wykonali juz zloty ruch
+    uint16_t *empty; ///< ilosci wolnych pol gier
+    uint8_t *to_move; ///< numery graczy wykonujacych nastepny ruch
+};
+
+/** @struct vec_game
+ * @brief Fragmenty tablic @ref gamma_vec nalezace do jednej gry.
+ */
+typedef struct vec_game {
+    gamma_vec_t *env; ///< struktura gier
+    uint8_t *owner; ///< wlasciciele pol gry
+    uint16_t *parent; ///< ojcowie pol gry
+    uint16_t *fields; ///< liczby pol graczy gry
+    uint16_t *areas; ///< liczby obszarow graczy gry
+    uint8_t *golden_used; ///< czy gracze gry wykonali juz zloty ruch
+} vec_game_t;
+
+/** @struct vec_step
+ * @brief Parametry rownoleglego wykonywania kroku.
+ */
+typedef struct vec_step {
+    gamma_vec_t *env; ///< struktura gier
+    const uint32_t *actions; ///< akcje gier
+    int32_t *rewards; ///< zmiany wynikow lub NULL
+    bool *done; ///< czy gry sie skonczyly lub NULL
+} vec_step_t;
+
+bool gamma_vec_init(gamma_vec_t **env, uint32_t count, uint32_t width,
+                    uint32_t height, uint32_t players, uint32_t areas) {
+    if(count == 0 || width == 0 || height == 0 || areas == 0 || players == 0
+       || players > GAMMA_VEC_MAX_PLAYERS
+       || (uint64_t) width * height > GAMMA_VEC_MAX_CELLS) {
+        return false;
+    }
+    *env = malloc(sizeof(gamma_vec_t));
+    if(*env == NULL) return false;
+    gamma_vec_t *e = *env;
+    e->count = count;
+    e->width = width;
+    e->height = height;
+    e->players = players;
+    e->areas = areas;
+    e->cells = width * height;
+    uint64_t board = (uint64_t) count * e->cells;
+    uint64_t counters = (uint64_t) count * (players + 1);
+    e->owner = calloc(board, sizeof(uint8_t));
+    e->parent = malloc(board * sizeof(uint16_t));
+    e->fields = calloc(counters, sizeof(uint16_t));
+    e->player_areas = calloc(counters, sizeof(uint16_t));
+    e->golden_used = calloc(counters, sizeof(uint8_t));
+    e->empty = malloc(count * sizeof(uint16_t));
+    e->to_move = malloc(count * sizeof(uint8_t));
+    if(e->owner == NULL || e->parent == NULL || e->fields == NULL
+       || e->player_areas == NULL || e->golden_used == NULL
+       || e->empty == NULL || e->to_move == NULL) {
+        delete_gamma_vec(e);
+        return false;
+    }
+    for(uint32_t i = 0; i < count; ++i) {
+        e->empty[i] = (uint16_t) e->cells;
+        e->to_move[i] = 1;
+    }
+    return true;
+}
+
+void delete_gamma_vec(gamma_vec_t *env) {
+    if(env != NULL) {
+        free(env->owner);
+        free(env->parent);
+        free(env->fields);
+        free(env->player_areas);
+        free(env->golden_used);
+        free(env->empty);
+        free(env->to_move);
+        free(env);
+    }
+}
+
+uint32_t gamma_vec_count(gamma_vec_t *env) {
+    return env->count;
+}
+
+bool gamma_vec_reset(gamma_vec_t *env, uint32_t game) {
+    if(env == NULL || game >= env->count) {
+        return false;
+    }
+    uint64_t counters = env->players + 1;
+    memset(env->owner + (uint64_t) game * env->cells, 0, env->cells);
+    memset(env->fields + game * counters, 0, counters * sizeof(uint16_t));
+    memset(env->player_areas + game * counters, 0, counters * sizeof(uint16_t));
+    memset(env->golden_used + game * counters, 0, counters);
+    env->empty[game] = (uint16_t) env->cells;
+    env->to_move[game] = 1;
+    return true;
+}
+
+/** @brief Podaje fragmenty tablic nalezace do gry.
+ * @param[in] env - wskaznik na strukture gier,
+ * @param[in] game - numer gry.
+ * @return Fragmenty tablic gry.
+ */
+static vec_game_t game_view(gamma_vec_t *env, uint32_t game) {
+    uint64_t counters = (uint64_t) game * (env->players + 1);
+    vec_game_t v = {
+        env,
+        env->owner + (uint64_t) game * env->cells,
+        env->parent + (uint64_t) game * env->cells,
+        env->fields + counters,
+        env->player_areas + counters,
+        env->golden_used + counters
+    };
+    return v;
+}
+
+/** @brief Znajduje korzen drzewa pola, skracajac sciezke o polowe.
+ * @param[in,out] parent - ojcowie pol gry,
+ * @param[in] cell - numer zajetego pola.
+ * @return Numer pola bedacego korzeniem.
+ */
+static uint16_t find_root(uint16_t *parent, uint16_t cell) {
+    while(parent[cell] != cell) {
+        parent[cell] = parent[parent[cell]];
+        cell = parent[cell];
+    }
+    return cell;
+}
+
+/** @brief Podaje sasiadow pola.
+ * @param[in] env - wskaznik na strukture gier,
+ * @param[in] cell - numer pola,
+ * @param[out] out - numery sasiadow.
+ * @return Ilosc sasiadow, od 0 do 4.
+ */
+static int neighbours(gamma_vec_t *env, uint32_t cell, uint16_t out[4]) {
+    uint32_t x = cell / env->height, y = cell % env->height;
+    int n = 0;
+    if(x > 0) out[n++] = (uint16_t) (cell - env->height);
+    if(x + 1 < env->width) out[n++] = (uint16_t) (cell + env->height);
+    if(y > 0) out[n++] = (uint16_t) (cell - 1);
+    if(y + 1 < env->height) out[n++] = (uint16_t) (cell + 1);
+    return n;
+}
+
+/** @brief Podaje korzenie roznych obszarow gracza sasiadujacych z polem.
+ * @param[in,out] v - gra,
+ * @param[in] player - numer gracza,
+ * @param[in] cell - numer pola,
+ * @param[out] roots - korzenie obszarow.
+ * @return Ilosc roznych obszarow, od 0 do 4.
+ */
+static int neighbour_roots(vec_game_t *v, uint32_t player, uint32_t cell,
+                           uint16_t roots[4]) {
+    uint16_t next[4];
+    int n = neighbours(v->env, cell, next);
+    int count = 0;
+    for(int i = 0; i < n; ++i) {
+        if(v->owner[next[i]] != player) continue;
+        uint16_t root = find_root(v->parent, next[i]);
+        bool seen = false;
+        for(int j = 0; j < count; ++j) {
+            seen |= (roots[j] == root);
+        }
+        if(!seen) roots[count++] = root;
+    }
+    return count;
+}
+
+/** @brief Buduje od nowa drzewo obszarow gracza.
+ * @param[in,out] v - gra,
+ * @param[in] player - numer gracza.
+ * @return Ilosc obszarow gracza.
+ */
+static uint16_t relabel(vec_game_t *v, uint32_t player) {
+    gamma_vec_t *env = v->env;
+    uint16_t areas = 0;
+    for(uint32_t cell = 0; cell < env->cells; ++cell) {
+        if(v->owner[cell] != player) continue;
+        v->parent[cell] = (uint16_t) cell;
+        areas++;
+        uint16_t root = (uint16_t) cell;
+        if(cell >= env->height && v->owner[cell - env->height] == player) {
+            v->parent[root] = find_root(v->parent, (uint16_t) (cell - env->height));
+            root = v->parent[root];
+            areas--;
+        }
+        if(cell % env->height > 0 && v->owner[cell - 1] == player) {
+            uint16_t other = find_root(v->parent, (uint16_t) (cell - 1));
+            if(other != root) {
+                v->parent[root] = other;
+                areas--;
+            }
+        }
+    }
+    return areas;
+}
+
+/** @brief Wykonuje ruch, jesli jest legalny.
+ * @param[in,out] v - gra,
+ * @param[in] player - numer gracza,
+ * @param[in] cell - numer pola.
+ * @return Wartosc @p true, jesli ruch zostal wykonany.
+ */
+static bool play(vec_game_t *v, uint32_t player, uint32_t cell) {
+    if(v->owner[cell] != 0) return false;
+    uint16_t roots[4];
+    int joined = neighbour_roots(v, player, cell, roots);
+    if(joined == 0 && v->areas[player] >= v->env->areas) return false;
+    v->owner[cell] = (uint8_t) player;
+    v->parent[cell] = (uint16_t) cell;
+    for(int i = 0; i < joined; ++i) {
+        v->parent[roots[i]] = (uint16_t) cell;
+    }
+    v->areas[player] = (uint16_t) (v->areas[player] + 1 - joined);
+    v->fields[player]++;
+    return true;
+}
+
+/** @brief Wykonuje zloty ruch, jesli jest legalny.
+ * Obszary poprzedniego wlasciciela pola sa wyznaczane od nowa, co przy
+ * malych planszach kosztuje mniej niz sledzenie rozpadu obszaru.
+ * @param[in,out] v - gra,
+ * @param[in] player - numer gracza,
+ * @param[in] cell - numer pola.
+ * @return Wartosc @p true, jesli ruch zostal wykonany.
+ */
+static bool play_golden(vec_game_t *v, uint32_t player, uint32_t cell) {
+    uint32_t old_owner = v->owner[cell];
+    if(old_owner == 0 || old_owner == player || v->golden_used[player]) return false;
+    uint16_t roots[4];
+    int joined = neighbour_roots(v, player, cell, roots);
+    if(joined == 0 && v->areas[player] >= v->env->areas) return false;
+    v->owner[cell] = (uint8_t) player;
+    uint16_t old_areas = relabel(v, old_owner);
+    if(old_areas > v->env->areas) {
+        v->owner[cell] = (uint8_t) old_owner;
+        relabel(v, old_owner);
+        return false;
+    }
+    v->areas[old_owner] = old_areas;
+    v->fields[old_owner]--;
+    v->parent[cell] = (uint16_t) cell;
+    for(int i = 0; i < joined; ++i) {
+        v->parent[roots[i]] = (uint16_t) cell;
+    }
+    v->areas[player] = (uint16_t) (v->areas[player] + 1 - joined);
+    v->fields[player]++;
+    v->golden_used[player] = 1;
+    return true;
+}
+
+/** @brief Podaje wynik gracza.
+ * @param[in] v - gra,
+ * @param[in] player - numer gracza.
+ * @return Liczba pol gracza pomniejszona o najwieksza liczbe pol przeciwnika.
+ */
+static int32_t score(vec_game_t *v, uint32_t player) {
+    uint16_t best = 0;
+    for(uint32_t q = 1; q <= v->env->players; ++q) {
+        if(q != player && v->fields[q] > best) best = v->fields[q];
+    }
+    return (int32_t) v->fields[player] - best;
+}
+
+/** @brief Sprawdza, czy gracz moze wykonac ruch lub zloty ruch.
+ * Zloty ruch jest uznawany za mozliwy na tej samej zasadzie co w
+ * @ref gamma_golden_possible.
+ * @param[in] v - gra,
+ * @param[in] player - numer gracza,
+ * @param[in] empty - ilosc wolnych pol.
+ * @return Wartosc @p true, jesli gracz moze wykonac jakis ruch.
+ */
+static bool can_move(vec_game_t *v, uint32_t player, uint16_t empty) {
+    gamma_vec_t *env = v->env;
+    if(!v->golden_used[player] && env->cells - empty > v->fields[player]) return true;
+    if(empty == 0) return false;
+    if(v->areas[player] < env->areas) return true;
+    for(uint32_t cell = 0; cell < env->cells; ++cell) {
+        if(v->owner[cell] != 0) continue;
+        uint16_t next[4];
+        int n = neighbours(env, cell, next);
+        for(int i = 0; i < n; ++i) {
+            if(v->owner[next[i]] == player) return true;
+        }
+    }
+    return false;
+}
+
+/** @brief Wykonuje krok jednej gry.
+ * @param[in,out] env - wskaznik na strukture gier,
+ * @param[in] game - numer gry,
+ * @param[in] action - akcja,
+ * @param[out] reward - zmiana wyniku gracza wykonujacego ruch,
+ * @param[out] done - czy gra sie skonczyla.
+ */
+static void step_game(gamma_vec_t *env, uint32_t game, uint32_t action,
+                      int32_t *reward, bool *done) {
+    vec_game_t v = game_view(env, game);
+    uint32_t player = env->to_move[game];
+    int32_t before = score(&v, player);
+    bool legal = false;
+    if(action < env->cells) {
+        legal = play(&v, player, action);
+        env->empty[game] -= legal;
+    }
+    else if(action - env->cells < env->cells) {
+        legal = play_golden(&v, player, action - env->cells);
+    }
+    *reward = legal ? score(&v, player) - before : 0;
+    *done = false;
+    if(!legal) return;
+    for(uint32_t i = 1; i <= env->players; ++i) {
+        uint32_t next = (player + i - 1) % env->players + 1;
+        if(can_move(&v, next, env->empty[game])) {
+            env->to_move[game] = (uint8_t) next;
+            return;
+        }
+    }
+    *done = true;
+    gamma_vec_reset(env, game);
+}
+
+/** @brief Wykonuje krok dla fragmentu gier.
+ * @param[in,out] ctx - wskaznik na strukture @ref vec_step,
+ * @param[in] begin - pierwsza gra fragmentu,
+ * @param[in] end - gra za ostatnia gra fragmentu,
+ * @param[in] chunk - numer fragmentu.
+ */
+static void step_games(void *ctx, uint64_t begin, uint64_t end, uint32_t chunk) {
+    (void) chunk;
+    vec_step_t *s = ctx;
+    for(uint64_t i = begin; i < end; ++i) {
+        int32_t reward;
+        bool done;
+        step_game(s->env, (uint32_t) i, s->actions[i], &reward, &done);
+        if(s->rewards != NULL) s->rewards[i] = reward;
+        if(s->done != NULL) s->done[i] = done;
+    }
+}
+
+bool gamma_vec_step(gamma_vec_t *env, const uint32_t *actions,
+                    int32_t *rewards, bool *done) {
+    if(env == NULL || actions == NULL) {
+        return false;
+    }
+    vec_step_t s = { env, actions, rewards, done };
+    uint32_t chunks = 1;
+    if((uint64_t) env->count * env->cells >= VEC_PARALLEL_MIN_CELLS) {
+        uint64_t wanted = (uint64_t) thread_pool_threads() * VEC_CHUNKS_PER_THREAD;
+        chunks = (uint32_t) (wanted < env->count ? wanted : env->count);
+    }
+    thread_pool_parallel_for(env->count, chunks, step_games, &s);
+    return true;
+}
+
+void gamma_vec_observe(gamma_vec_t *env, uint8_t *cells, uint32_t *to_move) {
+    if(cells != NULL) {
+        memcpy(cells, env->owner, (uint64_t) env->count * env->cells);
+    }
+    if(to_move != NULL) {
+        for(uint32_t i = 0; i < env->count; ++i) {
+            to_move[i] = env->to_move[i];
+        }
+    }
+}
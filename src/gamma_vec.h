@@ -0,0 +1,98 @@
+/** @file
+ * Interfejs wielu jednoczesnych gier gamma o tych samych parametrach
+ *
+ * Struktura przechowuje stan wszystkich gier w osobnych ciaglych tablicach
+ * dla kazdego rodzaju danych (plansze, drzewa find and union, liczniki
+ * graczy), wiec jeden krok wszystkich gier przechodzi po pamieci po kolei.
+ * Gry sa rozdzielane miedzy watki wspolnej puli.
+ *
+ * Gracze wykonuja ruchy po kolei, zaczynajac od gracza 1, tak jak w trybie
+ * interaktywnym: gracz, ktory nie moze zajac zadnego pola ani wykonac
+ * zlotego ruchu, jest pomijany, a gra konczy sie, gdy zaden gracz nie moze.
+ * Akcja jest numerem pola @p x * @p height + @p y dla zwyklego ruchu lub
+ * ta liczba powiekszona o ilosc pol planszy dla zlotego ruchu. Wynikiem
+ * gracza jest liczba jego pol pomniejszona o najwieksza liczbe pol
+ * przeciwnika, tak jak w solverze.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#ifndef GAMMA_VEC_H
+#define GAMMA_VEC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define GAMMA_VEC_MAX_PLAYERS 255 ///< najwieksza liczba graczy
+#define GAMMA_VEC_MAX_CELLS 65535 ///< najwieksza ilosc pol planszy
+
+/**
+ * Struktura przechowujaca stan wielu gier.
+ */
+typedef struct gamma_vec gamma_vec_t;
+
+/** @brief Tworzy gry.
+ * @param[out] env - wskaznik, pod ktorym zapisywana jest struktura gier,
+ * @param[in] count - liczba gier, liczba dodatnia,
+ * @param[in] width - szerokosc planszy, liczba dodatnia,
+ * @param[in] height - wysokosc planszy, liczba dodatnia,
+ * @param[in] players - liczba graczy, od 1 do @ref GAMMA_VEC_MAX_PLAYERS,
+ * @param[in] areas - maksymalna liczba obszarow gracza, liczba dodatnia.
+ * @return Wartosc @p true, jesli udalo sie utworzyc gry, @p false jesli
+ * plansza ma wiecej niz @ref GAMMA_VEC_MAX_CELLS pol, ktorys z parametrow
+ * jest niepoprawny lub nie udalo sie zaalokowac pamieci.
+ */
+bool gamma_vec_init(gamma_vec_t **env, uint32_t count, uint32_t width,
+                    uint32_t height, uint32_t players, uint32_t areas);
+
+/** @brief Usuwa gry.
+ * Nic nie robi, jesli @p env ma wartosc NULL.
+ * @param[in] env - wskaznik na usuwana strukture gier.
+ */
+void delete_gamma_vec(gamma_vec_t *env);
+
+/** @brief Podaje liczbe gier.
+ * @param[in] env - wskaznik na strukture gier.
+ * @return Liczba gier.
+ */
+uint32_t gamma_vec_count(gamma_vec_t *env);
+
+/** @brief Przywraca gre do stanu poczatkowego.
+ * @param[in,out] env - wskaznik na strukture gier,
+ * @param[in] game - numer gry, mniejszy od liczby gier.
+ * @return Wartosc @p true, jesli numer gry jest poprawny.
+ */
+bool gamma_vec_reset(gamma_vec_t *env, uint32_t game);
+
+/** @brief Wykonuje jeden ruch w kazdej grze.
+ * W grze o numerze @p i gracz wykonujacy ruch wykonuje akcje
+ * @p actions[i]. Niepoprawna lub nielegalna akcja nie zmienia gry i nie
+ * zmienia gracza wykonujacego ruch. Gra, ktora sie skonczyla, jest od razu
+ * przywracana do stanu poczatkowego.
+ * @param[in,out] env - wskaznik na strukture gier,
+ * @param[in] actions - tablica akcji, po jednej na gre,
+ * @param[out] rewards - tablica, pod ktora zapisywana jest zmiana wyniku
+ * gracza, ktory wykonywal ruch; moze byc NULL,
+ * @param[out] done - tablica, pod ktora zapisywane jest, czy gra sie
+ * skonczyla i zostala zaczeta od nowa; moze byc NULL.
+ * @return Wartosc @p false, jesli @p env lub @p actions ma wartosc NULL,
+ * @p true w przeciwnym przypadku.
+ */
+bool gamma_vec_step(gamma_vec_t *env, const uint32_t *actions,
+                    int32_t *rewards, bool *done);
+
+/** @brief Eksportuje stan gier.
+ * Zapisuje plansze wszystkich gier jedna za druga; plansza gry zajmuje
+ * @p width * @p height kolejnych elementow, a wlasciciel pola (@p x, @p y)
+ * lezy pod numerem @p x * @p height + @p y, tak jak w
+ * @ref gamma_from_cells, z wartoscia 0 dla wolnego pola.
+ * @param[in] env - wskaznik na strukture gier,
+ * @param[out] cells - tablica na plansze gier lub NULL,
+ * @param[out] to_move - tablica na numery graczy wykonujacych nastepny
+ * ruch, po jednym na gre, lub NULL.
+ */
+void gamma_vec_observe(gamma_vec_t *env, uint8_t *cells, uint32_t *to_move);
+
+#endif //GAMMA_VEC_H
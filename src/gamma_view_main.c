@@ -0,0 +1,58 @@
+/** @file
+ * Podglad planszy gry z pamieci wspoldzielonej
+ *
+ * Uzycie: gamma_view NAZWA_SEGMENTU [ODSTEP_MS]
+ *
+ * Bez odstepu wypisuje plansze raz. Z odstepem sprawdza co tyle milisekund,
+ * czy wykonano ruch, i wypisuje plansze po kazdej zmianie.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <time.h>
+#include "board_mirror.h"
+
+int main(int argc, char **argv) {
+    long interval_ms = 0;
+    if(argc == 3) {
+        char *end;
+        interval_ms = strtol(argv[2], &end, 10);
+        if(*end != '\0' || interval_ms <= 0) argc = 0;
+    }
+    if(argc != 2 && argc != 3) {
+        fprintf(stderr, "usage: %s SHM_NAME [INTERVAL_MS]\n", argv[0]);
+        return 1;
+    }
+
+    board_mirror_t *m;
+    if(!board_mirror_open(&m, argv[1])) {
+        perror("gamma_view");
+        return 1;
+    }
+
+    uint64_t last_seq = UINT64_MAX;
+    do {
+        if(__atomic_load_n(&board_mirror_header(m)->seq, __ATOMIC_ACQUIRE) != last_seq) {
+            char *board = board_mirror_render(m, &last_seq);
+            if(board == NULL) {
+                delete_board_mirror(m);
+                return 1;
+            }
+            fputs(board, stdout);
+            if(interval_ms > 0) putchar('\n');
+            fflush(stdout);
+            free(board);
+        }
+        if(interval_ms > 0) {
+            struct timespec ts = { interval_ms / 1000, (interval_ms % 1000) * 1000000 };
+            nanosleep(&ts, NULL);
+        }
+    } while(interval_ms > 0);
+
+    delete_board_mirror(m);
+    return 0;
+}
@@ -7,39 +7,74 @@
  */
 #include "interactive_mode.h"
 
-/** @brief Wypisuje plansze
- * @param[in] board - wskaznik na gre, ktorej plaszna jest wypisywana,
- * @param[in] posX - pierwszy koordynat pola ktore ma byc podswietlone,
- * @param[in] posY - drugi koordynat pola ktore ma byc podswietlone.
+/** @struct viewport
+ * @brief Wypisywany prostokat planszy.
  */
-static void print_board_highlighted(gamma_t *board, uint32_t posX, uint32_t posY) {
-    char *p = gamma_board(board);
+typedef struct viewport {
+    uint32_t x0; ///< pierwsza wypisywana kolumna
+    uint32_t y0; ///< najnizszy wypisywany wiersz
+    uint32_t columns; ///< ilosc wypisywanych kolumn
+    uint32_t rows; ///< ilosc wypisywanych wierszy
+} viewport_t;
 
-    uint64_t size_of_field = size_of_max_player(board);
-    uint64_t height = get_height(board);
-    uint64_t width = get_width(board);
-    posY = height - 1 - posY;
-    uint64_t iter = 0;
-    uint64_t size_of_line = width * size_of_field + 1;
-    uint64_t last_sign_index = height*size_of_line;
-
-    for(;iter < size_of_line * (posY); ++iter) {
-        printf("%c",p[iter]);
+/** @brief Dopasowuje wypisywany prostokat do terminala i kursora.
+ * Rozmiar prostokata wynika z rozmiaru terminala odczytanego przez
+ * @p TIOCGWINSZ, pomniejszonego o linie ze stanem gracza; jesli rozmiaru
+ * nie da sie odczytac, wypisywana jest cala plansza. Prostokat jest
+ * przesuwany najmniej jak sie da, tak aby zawieral kursor.
+ * @param[in] board - wskaznik na gre,
+ * @param[in] posX - numer kolumny kursora,
+ * @param[in] posY - numer wiersza kursora,
+ * @param[in,out] view - dopasowywany prostokat.
+ */
+static void update_viewport(gamma_t *board, uint32_t posX, uint32_t posY,
+                            viewport_t *view) {
+    uint32_t width = get_width(board);
+    uint32_t height = get_height(board);
+    struct winsize ws;
+    view->columns = width;
+    view->rows = height;
+    if(ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_row > STATUS_LINES && ws.ws_col > 0) {
+        uint32_t columns = ws.ws_col / size_of_max_player(board);
+        uint32_t rows = ws.ws_row - STATUS_LINES;
+        if(columns == 0) columns = 1;
+        if(columns < width) view->columns = columns;
+        if(rows < height) view->rows = rows;
     }
 
-    for(uint64_t ptr = 0; ptr < (posX*size_of_field); ++ptr) {
-        printf("%c",p[iter++]);
+    if(view->x0 > width - view->columns) view->x0 = width - view->columns;
+    if(view->y0 > height - view->rows) view->y0 = height - view->rows;
+    if(posX < view->x0) view->x0 = posX;
+    if(posX >= view->x0 + view->columns) view->x0 = posX - view->columns + 1;
+    if(posY < view->y0) view->y0 = posY;
+    if(posY >= view->y0 + view->rows) view->y0 = posY - view->rows + 1;
+}
+
+/** @brief Wypisuje widoczny prostokat planszy
+ * @param[in] board - wskaznik na gre, ktorej plaszna jest wypisywana,
+ * @param[in] posX - pierwszy koordynat pola ktore ma byc podswietlone,
+ * @param[in] posY - drugi koordynat pola ktore ma byc podswietlone,
+ * @param[in] view - wypisywany prostokat, zawierajacy podswietlane pole.
+ */
+static void print_board_highlighted(gamma_t *board, uint32_t posX, uint32_t posY,
+                                    const viewport_t *view) {
+    uint32_t x1 = view->x0 + view->columns - 1;
+    uint32_t y1 = view->y0 + view->rows - 1;
+    char *p = gamma_board_region(board, view->x0, view->y0, x1, y1);
+    if(p == NULL) {
+        return;
     }
 
+    uint64_t size_of_field = size_of_max_player(board);
+    uint64_t size_of_line = (uint64_t) view->columns * size_of_field + 1;
+    uint64_t start = (uint64_t) (y1 - posY) * size_of_line
+                     + (uint64_t) (posX - view->x0) * size_of_field;
+
+    fwrite(p, 1, start, stdout);
     START_HIGHLIGHT;
-    for(uint64_t ptr = 0; ptr < (size_of_field); ++ptr) {
-        printf("%c",p[iter++]);
-    }
+    fwrite(p + start, 1, size_of_field, stdout);
     END_HIGHLIGHT;
-
-    for(;iter <= last_sign_index; ++iter) {
-        printf("%c",p[iter]);
-    }
+    fputs(p + start + size_of_field, stdout);
 
     free(p);
 }
@@ -53,39 +88,183 @@ static void print_board(gamma_t *board) {
     free(p);
 }
 
-/** @brief Odpowiada za wczytywanie przyciskow.
- * Odpowiada za wczytywanie przyciskow i interpretacje
- * ruchu gracza.
- * @return komunikat o wczytanym przycisku.
+/** @struct input
+ * @brief Wczytane, a jeszcze nieprzetworzone znaki z wejscia.
+ */
+typedef struct input {
+    char buffer[INPUT_BUFFER_SIZE]; ///< wczytane znaki
+    size_t length; ///< ilosc wczytanych znakow
+    bool eof; ///< czy wejscie sie skonczylo
+    bool terminal; /**< czy wejscie jest terminalem, z ktorego odczyt
+                    * nie czeka na znaki **/
+} input_t;
+
+/** @brief Podaje czas zegara monotonicznego w milisekundach.
+ * @return czas w milisekundach.
  */
-static int process_move() {
-    char k = getchar();
-    if (k == '\033') {
-        k = getchar();
-        if(k == '[') {
-            k = getchar();
-            if (k == 'A') {
+static int64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/** @brief Wczytuje bez czekania wszystkie dostepne znaki wejscia.
+ * Terminal jest ustawiony tak, ze odczyt nie czeka na znaki, wiec
+ * @p getchar zwraca EOF, gdy nie ma wiecej znakow. Wejscie, ktore nie jest
+ * terminalem, jest czytane po jednym znaku z czekaniem.
+ * @param[in,out] in - bufor, do ktorego dopisywane sa znaki.
+ */
+static void read_available(input_t *in) {
+    while(in->length < INPUT_BUFFER_SIZE) {
+        int c = getchar();
+        if(c == EOF) {
+            if(!in->terminal) in->eof = true;
+            clearerr(stdin);
+            return;
+        }
+        in->buffer[in->length++] = (char) c;
+        if(!in->terminal) return;
+    }
+}
+
+/** @brief Rozpoznaje przycisk na poczatku bufora.
+ * @param[in] in - bufor wczytanych znakow,
+ * @param[in] pos - pozycja pierwszego znaku przycisku,
+ * @param[out] used - ilosc znakow zajmowanych przez przycisk.
+ * @return komunikat o wczytanym przycisku lub @ref INCOMPLETE_KEY, jesli
+ * bufor konczy sie w srodku sekwencji przycisku strzalki.
+ */
+static int decode_key(const input_t *in, size_t pos, size_t *used) {
+    const char *k = in->buffer + pos;
+    size_t left = in->length - pos;
+    *used = 1;
+    if (k[0] == '\033') {
+        if (left < 2 || (k[1] == '[' && left < 3)) {
+            return in->eof ? WRONG_CHAR : INCOMPLETE_KEY;
+        }
+        *used = 2;
+        if (k[1] == '[') {
+            *used = 3;
+            if (k[2] == 'A') {
                 return MOVE_UP;
-            } else if (k == 'B') {
+            } else if (k[2] == 'B') {
                 return MOVE_DOWN;
-            } else if (k == 'C') {
+            } else if (k[2] == 'C') {
                 return MOVE_RIGHT;
-            } else if (k == 'D') {
+            } else if (k[2] == 'D') {
                 return MOVE_LEFT;
             }
         }
-    } else if (k == '\40') {
+    } else if (k[0] == '\40') {
         return MOVE;
-    } else if (k == 'g' || k == 'G') {
+    } else if (k[0] == 'g' || k[0] == 'G') {
         return GOLDEN_MOVE;
-    } else if (k == 'c' || k == 'C') {
+    } else if (k[0] == 'c' || k[0] == 'C') {
         return CONTINUE;
-    } else if (k == '\4') {
+    } else if (k[0] == '\4') {
         return EXIT_GAME;
     }
     return WRONG_CHAR;
 }
 
+/** @brief Odpowiada za wczytywanie przyciskow.
+ * Czeka na wejscie, a potem wczytuje wszystkie oczekujace przyciski,
+ * sumujac przesuniecia kursora strzalkami, az do pierwszego przycisku
+ * innego niz strzalka. Samo przesuniecie jest zwracane dopiero po
+ * uplywie @ref FRAME_INTERVAL_MS od wypisania poprzedniej klatki,
+ * wiec przytrzymany przycisk nie powoduje wypisywania zaleglych klatek.
+ * Koniec wejscia jest traktowany jak @ref EXIT_GAME.
+ * @param[in,out] in - bufor wczytanych znakow,
+ * @param[in] last_frame - czas wypisania poprzedniej klatki w milisekundach,
+ * @param[in] deadline - czas w milisekundach, po ktorym funkcja konczy
+ * czekanie na wejscie, zwracajac @ref NO_ACTION, lub -1, jesli czeka
+ * bez ograniczenia,
+ * @param[out] dx - przesuniecie kursora w poziomie,
+ * @param[out] dy - przesuniecie kursora w pionie.
+ * @return komunikat o wczytanym przycisku innym niz strzalka lub
+ * @ref NO_ACTION, jesli wczytano tylko strzalki.
+ */
+static int process_move(input_t *in, int64_t last_frame, int64_t deadline,
+                        int64_t *dx, int64_t *dy) {
+    *dx = 0;
+    *dy = 0;
+    bool moved = false;
+    while(true) {
+        size_t pos = 0, used;
+        int instruction = NO_ACTION;
+        while(pos < in->length) {
+            int key = decode_key(in, pos, &used);
+            if(key == INCOMPLETE_KEY) {
+                break;
+            }
+            pos += used;
+            if(key == MOVE_UP) {
+                (*dy)++;
+            } else if(key == MOVE_DOWN) {
+                (*dy)--;
+            } else if(key == MOVE_RIGHT) {
+                (*dx)++;
+            } else if(key == MOVE_LEFT) {
+                (*dx)--;
+            } else if(key != WRONG_CHAR) {
+                instruction = key;
+                break;
+            }
+            if(key != WRONG_CHAR) moved = true;
+        }
+        memmove(in->buffer, in->buffer + pos, in->length - pos);
+        in->length -= pos;
+
+        if(instruction != NO_ACTION) {
+            return instruction;
+        }
+        if(in->eof) {
+            return EXIT_GAME;
+        }
+
+        if(!in->terminal) {
+            if(moved) {
+                return NO_ACTION;
+            }
+            if(deadline >= 0) {
+                int64_t left = deadline - now_ms();
+                if(left > 0) usleep((useconds_t) left * 1000);
+                return NO_ACTION;
+            }
+            read_available(in);
+            continue;
+        }
+
+        int64_t wait_until = moved ? last_frame + FRAME_INTERVAL_MS : deadline;
+        int timeout = -1;
+        if(moved || deadline >= 0) {
+            int64_t left = wait_until - now_ms();
+            timeout = (left > 0) ? (int) left : 0;
+        }
+        struct pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+        int ready = poll(&pfd, 1, timeout);
+        if((ready < 0 && errno != EINTR) || (pfd.revents & (POLLHUP | POLLERR))) {
+            return EXIT_GAME;
+        }
+        if(ready == 0) {
+            return NO_ACTION;
+        }
+        read_available(in);
+    }
+}
+
+/** @brief Przesuwa wspolrzedna kursora w granicach planszy.
+ * @param[in,out] pos - wspolrzedna kursora,
+ * @param[in] delta - przesuniecie,
+ * @param[in] size - rozmiar planszy w danym kierunku.
+ */
+static void move_cursor(uint32_t *pos, int64_t delta, uint32_t size) {
+    int64_t moved = (int64_t) *pos + delta;
+    if(moved < 0) moved = 0;
+    if(moved > (int64_t) size - 1) moved = (int64_t) size - 1;
+    *pos = (uint32_t) moved;
+}
+
 /** @brief czysci terminal.
  */
 static void clear() {
@@ -95,22 +274,74 @@ static void clear() {
     printf("\033[1;1H");
 }
 
-void interactive_mode_start(gamma_t *board, uint32_t number_of_players) {
+/** @brief Podaje czas namyslu graczy komputerowych.
+ * @return wartosc zmiennej srodowiskowej @ref BOT_TIME_ENV w milisekundach
+ * lub @ref BOT_DEFAULT_TIME_MS, jesli nie jest ustawiona.
+ */
+static int64_t bot_time_budget(void) {
+    const char *value = getenv(BOT_TIME_ENV);
+    if(value == NULL || value[0] == '\0') return BOT_DEFAULT_TIME_MS;
+    return (int64_t) strtoul(value, NULL, 10);
+}
+
+/** @brief Znajduje gracza komputerowego zajmujacego miejsce gracza.
+ * @param[in] bots - gracze komputerowi,
+ * @param[in] bot_players - numery graczy, ktorymi graja kolejni
+ * gracze komputerowi,
+ * @param[in] bot_count - ilosc graczy komputerowych,
+ * @param[in] player - numer gracza.
+ * @return wskaznik na gracza komputerowego lub NULL, jesli gracz jest
+ * czlowiekiem.
+ */
+static bot_t *seat_bot(bot_t **bots, const uint32_t *bot_players,
+                       uint32_t bot_count, uint32_t player) {
+    for(uint32_t i = 0; i < bot_count; ++i) {
+        if(bot_players[i] == player) return bots[i];
+    }
+    return NULL;
+}
+
+void interactive_mode_start(gamma_t *board, uint32_t number_of_players,
+                            const uint32_t *bot_players, uint32_t bot_count) {
 
     struct termios oldt, newt;
-    tcgetattr(STDIN_FILENO, &oldt);
+    input_t in;
+    in.length = 0;
+    in.eof = false;
+    in.terminal = (tcgetattr(STDIN_FILENO, &oldt) == 0);
     newt = oldt;
     newt.c_lflag &= ~(ICANON | ECHO);
-    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
+    newt.c_cc[VMIN] = 0;
+    newt.c_cc[VTIME] = 0;
+    in.terminal &= (tcsetattr(STDIN_FILENO, TCSANOW, &newt) == 0);
+
+    bot_t **bots = calloc(bot_count + 1, sizeof(bot_t *));
+    if(bots == NULL) bot_count = 0;
+    for(uint32_t i = 0; i < bot_count; ++i) {
+        if(seat_bot(bots, bot_players, i, bot_players[i]) == NULL) {
+            bot_init(&bots[i], board, bot_players[i]);
+        }
+    }
+    int64_t bot_budget = bot_time_budget();
+    opening_book_t *book = NULL;
+    const char *book_path = getenv(BOOK_PATH_ENV);
+    if(book_path != NULL && book_path[0] != '\0' && opening_book_open(&book, book_path)) {
+        for(uint32_t i = 0; i < bot_count; ++i) {
+            if(bots[i] != NULL) bot_set_book(bots[i], book);
+        }
+    }
 
     bool can_anybody_make_a_move = true;
     bool game_running = true;
     uint32_t posX = (get_width(board) - 1)/2;
     uint32_t posY = (get_height(board) - 1)/2;
+    viewport_t view = { 0, 0, 0, 0 };
 
     while(can_anybody_make_a_move && game_running)
     {
         can_anybody_make_a_move = false;
+        bool human_turn = false;
+        bool bot_moved = false;
 
         for(uint32_t player = 1; player <= number_of_players && game_running; ++player) {
 
@@ -118,11 +349,20 @@ void interactive_mode_start(gamma_t *board, uint32_t number_of_players) {
                && gamma_golden_possible(board, player) == false)) {
 
                 can_anybody_make_a_move = true;
+                bot_t *bot = seat_bot(bots, bot_players, bot_count, player);
+                human_turn |= (bot == NULL);
+                int64_t deadline = (bot == NULL) ? -1 : now_ms() + bot_budget;
+                uint32_t book_x, book_y;
+                bool book_golden;
+                if(bot != NULL && bot_book_move(bot, &book_x, &book_y, &book_golden)) {
+                    deadline = now_ms();
+                }
 
                 while(true) {
 
                     clear();
-                    print_board_highlighted(board, posX, posY);
+                    update_viewport(board, posX, posY, &view);
+                    print_board_highlighted(board, posX, posY, &view);
                     printf("PLAYER %u %lu %lu ",
                             player,
                             gamma_busy_fields(board, player),
@@ -130,26 +370,25 @@ void interactive_mode_start(gamma_t *board, uint32_t number_of_players) {
 
                     printf(gamma_golden_possible(board, player) ? "G\n" : "\n");
 
-                    int instruction = process_move();
+                    fflush(stdout);
+                    int64_t last_frame = now_ms();
+                    int64_t dx, dy;
+                    int instruction = process_move(&in, last_frame, deadline, &dx, &dy);
+                    move_cursor(&posX, dx, get_width(board));
+                    move_cursor(&posY, dy, get_height(board));
 
-                    if (instruction == CONTINUE) {
-                        break;
-                    }
-                    else if (instruction == EXIT_GAME) {
+                    if (instruction == EXIT_GAME) {
                         game_running = false;
                         break;
                     }
-                    else if (instruction == MOVE_UP) {
-                        if(posY < get_height(board) - 1) posY++;
-                    }
-                    else if (instruction == MOVE_LEFT) {
-                        if(posX > 0) posX--;
-                    }
-                    else if (instruction == MOVE_DOWN) {
-                        if(posY > 0) posY--;
+                    else if (bot != NULL) {
+                        if (now_ms() >= deadline) {
+                            bot_moved |= bot_play(bot);
+                            break;
+                        }
                     }
-                    else if (instruction == MOVE_RIGHT) {
-                        if(posX < get_width(board) - 1) posX++;
+                    else if (instruction == CONTINUE) {
+                        break;
                     }
                     else if (instruction == MOVE) {
                         if(gamma_move(board, player, posX, posY)) {
@@ -164,7 +403,19 @@ void interactive_mode_start(gamma_t *board, uint32_t number_of_players) {
                 }
             }
         }
+
+        /* Gracze komputerowi nie pasuja, jesli maja ruch, wiec kolejka
+         * bez ludzi i bez ruchow konczy gre. */
+        if(!human_turn && !bot_moved) {
+            can_anybody_make_a_move = false;
+        }
+    }
+
+    for(uint32_t i = 0; i < bot_count; ++i) {
+        delete_bot(bots[i]);
     }
+    free(bots);
+    delete_opening_book(book);
 
     clear();
 
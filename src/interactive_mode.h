@@ -8,17 +8,30 @@
 
 #ifndef INTERACTIVE_MODE_H
 #define INTERACTIVE_MODE_H
+#define _GNU_SOURCE
+#include <errno.h>
+#include <poll.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "bot.h"
 #include "gamma.h"
 #include <termio.h>
+#include <sys/ioctl.h>
 #include <unistd.h>
 #include "interactive_mode_constants.h"
 
 /** @brief Uruchamia tryb interaktywny.
- * Uruchamia tryb interaktywny.
+ * Uruchamia tryb interaktywny. Za graczy @p bot_players ruchy wykonuje
+ * komputer, namyslajac sie w tle przez cala gre i wykonujac ruch po
+ * czasie podanym w zmiennej srodowiskowej @ref BOT_TIME_ENV, albo od razu,
+ * jesli ruch jest w ksiazce otwarc z pliku @ref BOOK_PATH_ENV.
  * @param[in,out] board   – wskaznik na gre, dla ktorej uruchamiany jest tryb,
- * @param[in] number_of_players  - ilosc graczy, liczba dodatnia.
+ * @param[in] number_of_players  - ilosc graczy, liczba dodatnia,
+ * @param[in] bot_players - numery graczy, za ktorych gra komputer,
+ * @param[in] bot_count - ilosc elementow tablicy @p bot_players.
  */
-void interactive_mode_start(gamma_t *board, uint32_t number_of_players);
+void interactive_mode_start(gamma_t *board, uint32_t number_of_players,
+                            const uint32_t *bot_players, uint32_t bot_count);
 #endif //INTERACTIVE_MODE_H
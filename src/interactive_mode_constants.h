@@ -23,5 +23,20 @@
 #define CONTINUE 6 ///< makro odpowiadajace za pominiecie tury
 #define EXIT_GAME 7 ///< makro odpowiadajace za konca gry
 #define WRONG_CHAR 8 ///< makro odpowiadajace za wcisniecie zlego znaku
+#define NO_ACTION 9 /**< makro mowiace o tym, ze wczytano tylko
+                     * przesuniecia kursora **/
+#define INCOMPLETE_KEY 10 /**< makro mowiace o tym, ze wczytano tylko
+                           * poczatek sekwencji przycisku **/
+#define INPUT_BUFFER_SIZE 256 ///< rozmiar bufora wczytanych znakow
+#define FRAME_INTERVAL_MS 16 /**< najkrotszy odstep pomiedzy klatkami
+                              * wypisywanymi po przesunieciu kursora **/
+#define BOT_TIME_ENV "GAMMA_BOT_MS" /**< zmienna srodowiskowa z czasem namyslu
+                                     * gracza komputerowego w milisekundach **/
+#define BOT_DEFAULT_TIME_MS 1000 /**< domyslny czas namyslu gracza
+                                   * komputerowego w milisekundach **/
+#define BOOK_PATH_ENV "GAMMA_BOOK" /**< zmienna srodowiskowa ze sciezka
+                                    * ksiazki otwarc graczy komputerowych **/
+#define STATUS_LINES 2 /**< ilosc linii terminala zajmowanych pod plansza
+                        * przez stan gracza i kursor terminala **/
 
 #endif //INTERACTIVE_MODE_CONSTANTS_H
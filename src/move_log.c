@@ -0,0 +1,451 @@
+/** @file
+ * Implementacja interfejsu move_log.h
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "move_log.h"
+
+#define MOVE_LOG_MAGIC "GAMMALOG" ///< poczatek naglowka pliku dziennika
+#define MOVE_LOG_MAGIC_SIZE 8 ///< dlugosc napisu @ref MOVE_LOG_MAGIC
+#define MOVE_LOG_HEADER_SIZE 24 ///< rozmiar naglowka w bajtach
+#define MOVE_LOG_RECORD_SIZE 14 ///< rozmiar jednego wpisu w bajtach
+#define MOVE_LOG_BUFFER_RECORDS 4096 /**< ile wpisow miesci sie w buforze,
+                                       * zanim zostanie wymuszony zapis **/
+#define MOVE_LOG_READ_RECORDS 8192 /**< ile wpisow jest czytanych naraz
+                                     * przy odtwarzaniu dziennika **/
+
+/** @struct move_log
+ * @brief Struktura przechowujaca otwarty dziennik ruchow.
+ * Pamieta deskryptor pliku, bufor wpisow czekajacych na zapis,
+ * limity zapisu grupowego oraz czas ostatniego zapisu. Wpisy opuszczaja
+ * bufor dopiero po udanym fdatasync. Jesli limit czasu jest ustawiony,
+ * osobny watek utrwala bufor takze wtedy, gdy nie przychodza nowe ruchy.
+ */
+struct move_log {
+    int fd; ///< deskryptor pliku dziennika
+    uint8_t *buffer; ///< bufor wpisow czekajacych na zapis
+    uint32_t pending; ///< liczba wpisow w buforze
+    size_t written; ///< ile bajtow bufora jest juz w pliku, ale bez fdatasync
+    off_t synced_size; ///< rozmiar utrwalonej czesci pliku
+    uint32_t sync_every_moves; ///< limit zbuforowanych wpisow
+    uint64_t sync_every_ns; ///< limit czasu od ostatniego zapisu
+    uint64_t last_sync_ns; ///< czas ostatniego zapisu
+    bool failed; ///< czy ktorys zapis na dysk sie nie powiodl
+    pthread_mutex_t lock; ///< blokada pol dziennika
+    pthread_cond_t wake; ///< budzi watek zapisujacy przy zamykaniu
+    pthread_t flusher; ///< watek utrwalajacy bufor po uplywie czasu
+    bool has_flusher; ///< czy watek zapisujacy zostal uruchomiony
+    bool stopping; ///< czy dziennik jest zamykany
+};
+
+/** @brief Podaje czas zegara monotonicznego w nanosekundach.
+ * @return czas w nanosekundach.
+ */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+/** @brief Zapisuje liczbe w kolejnosci little-endian.
+ * @param[out] dst - bufor docelowy,
+ * @param[in] value - zapisywana liczba.
+ */
+static void put_u32(uint8_t *dst, uint32_t value) {
+    dst[0] = (uint8_t) value;
+    dst[1] = (uint8_t) (value >> 8);
+    dst[2] = (uint8_t) (value >> 16);
+    dst[3] = (uint8_t) (value >> 24);
+}
+
+/** @brief Odczytuje liczbe zapisana w kolejnosci little-endian.
+ * @param[in] src - bufor zrodlowy.
+ * @return odczytana liczba.
+ */
+static uint32_t get_u32(const uint8_t *src) {
+    return (uint32_t) src[0] | (uint32_t) src[1] << 8
+           | (uint32_t) src[2] << 16 | (uint32_t) src[3] << 24;
+}
+
+/** @brief Liczy sume kontrolna wpisu.
+ * @param[in] record - wpis, ktorego suma jest liczona.
+ * @return suma kontrolna pierwszych @ref MOVE_LOG_RECORD_SIZE - 1 bajtow.
+ */
+static uint8_t record_checksum(const uint8_t *record) {
+    uint8_t a = 0x5a, b = 0;
+    for(int i = 0; i < MOVE_LOG_RECORD_SIZE - 1; ++i) {
+        a += record[i];
+        b += a;
+    }
+    return a ^ b;
+}
+
+/** @brief Zapisuje caly bufor, ponawiajac przerwane wywolania write.
+ * @param[in] fd - deskryptor pliku,
+ * @param[in] data - zapisywane dane,
+ * @param[in] size - liczba bajtow.
+ * @return @p true, jesli zapisano wszystkie bajty, @p false w przeciwnym przypadku.
+ */
+static bool write_all(int fd, const uint8_t *data, size_t size) {
+    while(size > 0) {
+        ssize_t written = write(fd, data, size);
+        if(written < 0) {
+            if(errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= (size_t) written;
+    }
+    return true;
+}
+
+/** @brief Wypelnia naglowek dziennika.
+ * @param[out] header - bufor o rozmiarze @ref MOVE_LOG_HEADER_SIZE,
+ * @param[in] width - szerokosc planszy,
+ * @param[in] height - wysokosc planszy,
+ * @param[in] players - liczba graczy,
+ * @param[in] areas - maksymalna liczba obszarow.
+ */
+static void fill_header(uint8_t *header, uint32_t width, uint32_t height,
+                        uint32_t players, uint32_t areas) {
+    memcpy(header, MOVE_LOG_MAGIC, MOVE_LOG_MAGIC_SIZE);
+    put_u32(header + 8, width);
+    put_u32(header + 12, height);
+    put_u32(header + 16, players);
+    put_u32(header + 20, areas);
+}
+
+/** @brief Czyta naglowek z otwartego pliku.
+ * @param[in] fd - deskryptor pliku ustawiony na jego poczatku,
+ * @param[out] header - bufor o rozmiarze @ref MOVE_LOG_HEADER_SIZE.
+ * @return @p true, jesli udalo sie przeczytac poprawny naglowek,
+ * @p false w przeciwnym przypadku.
+ */
+static bool read_header(int fd, uint8_t *header) {
+    size_t done = 0;
+    while(done < MOVE_LOG_HEADER_SIZE) {
+        ssize_t r = read(fd, header + done, MOVE_LOG_HEADER_SIZE - done);
+        if(r < 0 && errno == EINTR) continue;
+        if(r <= 0) return false;
+        done += (size_t) r;
+    }
+    return memcmp(header, MOVE_LOG_MAGIC, MOVE_LOG_MAGIC_SIZE) == 0;
+}
+
+/** @brief Przeglada wpisy pliku i wywoluje dla nich funkcje.
+ * @param[in] fd - deskryptor pliku ustawiony za naglowkiem,
+ * @param[in] fn - funkcja wywolywana dla kazdego wpisu lub NULL,
+ * @param[in,out] ctx - wskaznik przekazywany do @p fn.
+ * @return liczba poprawnych wpisow lub -1 przy bledzie odczytu.
+ */
+static int64_t scan_records(int fd, move_log_replay_fn fn, void *ctx) {
+    uint8_t *chunk = malloc(MOVE_LOG_READ_RECORDS * MOVE_LOG_RECORD_SIZE);
+    if(chunk == NULL) return -1;
+
+    int64_t count = 0;
+    size_t filled = 0;
+    bool stop = false;
+    while(!stop) {
+        ssize_t r = read(fd, chunk + filled,
+                         MOVE_LOG_READ_RECORDS * MOVE_LOG_RECORD_SIZE - filled);
+        if(r < 0 && errno == EINTR) continue;
+        if(r < 0) {
+            free(chunk);
+            return -1;
+        }
+        if(r == 0) break;
+        filled += (size_t) r;
+
+        size_t offset = 0;
+        for(; offset + MOVE_LOG_RECORD_SIZE <= filled;
+              offset += MOVE_LOG_RECORD_SIZE) {
+            const uint8_t *record = chunk + offset;
+            if(record_checksum(record) != record[MOVE_LOG_RECORD_SIZE - 1]
+               || (record[0] != MOVE_LOG_MOVE
+                   && record[0] != MOVE_LOG_GOLDEN_MOVE)) {
+                stop = true;
+                break;
+            }
+            if(fn != NULL && !fn(ctx, record[0], get_u32(record + 1),
+                                 get_u32(record + 5), get_u32(record + 9))) {
+                stop = true;
+                break;
+            }
+            ++count;
+        }
+        memmove(chunk, chunk + offset, filled - offset);
+        filled -= offset;
+    }
+
+    free(chunk);
+    return count;
+}
+
+/** @brief Utrwala zbuforowane wpisy; wymaga trzymania blokady dziennika.
+ * Dopisuje do pliku czesc bufora, ktora jeszcze sie w nim nie znalazla,
+ * i wywoluje fdatasync. Wpisy sa usuwane z bufora dopiero po udanym
+ * fdatasync, wiec nieudany zapis mozna ponowic bez utraty ruchow.
+ * Kazdy blad ustawia na stale flage @p failed.
+ * @param[in,out] log - wskaznik na dziennik.
+ * @return @p true, jesli wszystkie wpisy zostaly utrwalone,
+ * @p false w przeciwnym przypadku.
+ */
+static bool flush_locked(move_log_t *log) {
+    size_t size = (size_t) log->pending * MOVE_LOG_RECORD_SIZE;
+    while(log->written < size) {
+        ssize_t written = write(log->fd, log->buffer + log->written,
+                                size - log->written);
+        if(written < 0) {
+            if(errno == EINTR) continue;
+            log->failed = true;
+            return false;
+        }
+        log->written += (size_t) written;
+    }
+    if(size > 0 && fdatasync(log->fd) != 0) {
+        log->failed = true;
+        return false;
+    }
+    log->synced_size += (off_t) size;
+    log->pending = 0;
+    log->written = 0;
+    log->last_sync_ns = now_ns();
+    return true;
+}
+
+/** @brief Wycofuje ostatni wpis bufora po nieudanym zapisie.
+ * Jesli wpis zdazyl trafic do pliku, obcina plik tak, aby przy
+ * odtwarzaniu nie pojawil sie ruch, ktory zostal odrzucony.
+ * @param[in,out] log - wskaznik na dziennik, z trzymana blokada.
+ */
+static void drop_last_record(move_log_t *log) {
+    log->pending--;
+    size_t kept = (size_t) log->pending * MOVE_LOG_RECORD_SIZE;
+    if(log->written > kept) {
+        off_t end = log->synced_size + (off_t) kept;
+        if(ftruncate(log->fd, end) == 0 && lseek(log->fd, end, SEEK_SET) == end)
+            log->written = kept;
+    }
+}
+
+/** @brief Funkcja watku utrwalajacego bufor po uplywie limitu czasu.
+ * Po nieudanym zapisie watek konczy prace, bo blad dziennika jest trwaly,
+ * a ponawianie zapisu trzymaloby blokade bez przerwy.
+ * @param[in,out] arg - wskaznik na dziennik.
+ * @return NULL.
+ */
+static void* flusher_main(void *arg) {
+    move_log_t *log = arg;
+    pthread_mutex_lock(&log->lock);
+    while(!log->stopping && !log->failed) {
+        uint64_t deadline = log->last_sync_ns + log->sync_every_ns;
+        uint64_t now = now_ns();
+        if(now >= deadline) {
+            if(log->pending > 0) flush_locked(log);
+            else log->last_sync_ns = now;
+            continue;
+        }
+        struct timespec ts;
+        ts.tv_sec = (time_t) (deadline / 1000000000u);
+        ts.tv_nsec = (long) (deadline % 1000000000u);
+        pthread_cond_timedwait(&log->wake, &log->lock, &ts);
+    }
+    pthread_mutex_unlock(&log->lock);
+    return NULL;
+}
+
+/** @brief Przygotowuje blokade dziennika i watek zapisujacy.
+ * Watek jest uruchamiany tylko wtedy, gdy ustawiony jest limit czasu.
+ * @param[in,out] log - wskaznik na dziennik.
+ * @return @p true, jesli sie udalo, @p false w przeciwnym przypadku.
+ */
+static bool init_sync(move_log_t *log) {
+    pthread_condattr_t attr;
+    if(pthread_condattr_init(&attr) != 0) return false;
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    bool cond_ready = pthread_cond_init(&log->wake, &attr) == 0;
+    pthread_condattr_destroy(&attr);
+    if(!cond_ready) return false;
+    if(pthread_mutex_init(&log->lock, NULL) != 0) {
+        pthread_cond_destroy(&log->wake);
+        return false;
+    }
+    if(log->sync_every_ns != 0) {
+        if(pthread_create(&log->flusher, NULL, flusher_main, log) != 0) {
+            pthread_mutex_destroy(&log->lock);
+            pthread_cond_destroy(&log->wake);
+            return false;
+        }
+        log->has_flusher = true;
+    }
+    return true;
+}
+
+bool move_log_open(move_log_t **log, const char *path,
+                   uint32_t width, uint32_t height,
+                   uint32_t players, uint32_t areas,
+                   uint32_t sync_every_moves, uint32_t sync_every_ms) {
+    *log = NULL;
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if(fd < 0) return false;
+    if(flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        close(fd);
+        return false;
+    }
+
+    uint8_t expected[MOVE_LOG_HEADER_SIZE];
+    fill_header(expected, width, height, players, areas);
+
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+
+    off_t end = MOVE_LOG_HEADER_SIZE;
+    if(st.st_size < MOVE_LOG_HEADER_SIZE) {
+        if(ftruncate(fd, 0) != 0 || !write_all(fd, expected, sizeof(expected))
+           || fdatasync(fd) != 0) {
+            close(fd);
+            return false;
+        }
+    }
+    else {
+        uint8_t header[MOVE_LOG_HEADER_SIZE];
+        if(!read_header(fd, header)
+           || memcmp(header, expected, MOVE_LOG_HEADER_SIZE) != 0) {
+            close(fd);
+            return false;
+        }
+        int64_t records = scan_records(fd, NULL, NULL);
+        end = MOVE_LOG_HEADER_SIZE + (off_t) records * MOVE_LOG_RECORD_SIZE;
+        if(records < 0 || (end != st.st_size && ftruncate(fd, end) != 0)
+           || lseek(fd, end, SEEK_SET) != end) {
+            close(fd);
+            return false;
+        }
+    }
+
+    move_log_t *new_log = malloc(sizeof(move_log_t));
+    if(new_log == NULL) {
+        close(fd);
+        return false;
+    }
+    new_log->buffer = malloc(MOVE_LOG_BUFFER_RECORDS * MOVE_LOG_RECORD_SIZE);
+    if(new_log->buffer == NULL) {
+        free(new_log);
+        close(fd);
+        return false;
+    }
+    new_log->fd = fd;
+    new_log->pending = 0;
+    new_log->written = 0;
+    new_log->synced_size = end;
+    new_log->sync_every_moves = sync_every_moves;
+    new_log->sync_every_ns = (uint64_t) sync_every_ms * 1000000u;
+    new_log->last_sync_ns = now_ns();
+    new_log->failed = false;
+    new_log->has_flusher = false;
+    new_log->stopping = false;
+    if(!init_sync(new_log)) {
+        free(new_log->buffer);
+        free(new_log);
+        close(fd);
+        return false;
+    }
+    *log = new_log;
+    return true;
+}
+
+bool move_log_sync(move_log_t *log) {
+    pthread_mutex_lock(&log->lock);
+    bool synced = flush_locked(log);
+    pthread_mutex_unlock(&log->lock);
+    return synced;
+}
+
+bool move_log_append(move_log_t *log, uint8_t kind,
+                     uint32_t player, uint32_t x, uint32_t y) {
+    pthread_mutex_lock(&log->lock);
+    if(log->failed) {
+        pthread_mutex_unlock(&log->lock);
+        return false;
+    }
+
+    uint8_t *record = log->buffer + (size_t) log->pending * MOVE_LOG_RECORD_SIZE;
+    record[0] = kind;
+    put_u32(record + 1, player);
+    put_u32(record + 5, x);
+    put_u32(record + 9, y);
+    record[MOVE_LOG_RECORD_SIZE - 1] = record_checksum(record);
+    log->pending++;
+
+    bool appended = true;
+    if(log->pending == MOVE_LOG_BUFFER_RECORDS
+       || (log->sync_every_moves != 0
+           && log->pending >= log->sync_every_moves)) {
+        appended = flush_locked(log);
+        if(!appended) drop_last_record(log);
+    }
+    pthread_mutex_unlock(&log->lock);
+    return appended;
+}
+
+void move_log_close(move_log_t *log) {
+    if(log != NULL) {
+        if(log->has_flusher) {
+            pthread_mutex_lock(&log->lock);
+            log->stopping = true;
+            pthread_cond_signal(&log->wake);
+            pthread_mutex_unlock(&log->lock);
+            pthread_join(log->flusher, NULL);
+        }
+        move_log_sync(log);
+        pthread_cond_destroy(&log->wake);
+        pthread_mutex_destroy(&log->lock);
+        close(log->fd);
+        free(log->buffer);
+        free(log);
+    }
+}
+
+bool move_log_read_header(const char *path, uint32_t *width, uint32_t *height,
+                          uint32_t *players, uint32_t *areas) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if(fd < 0) return false;
+    uint8_t header[MOVE_LOG_HEADER_SIZE];
+    bool valid = read_header(fd, header);
+    close(fd);
+    if(valid) {
+        *width = get_u32(header + 8);
+        *height = get_u32(header + 12);
+        *players = get_u32(header + 16);
+        *areas = get_u32(header + 20);
+    }
+    return valid;
+}
+
+int64_t move_log_replay(const char *path, move_log_replay_fn fn, void *ctx) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if(fd < 0) return -1;
+    uint8_t header[MOVE_LOG_HEADER_SIZE];
+    int64_t count = -1;
+    if(read_header(fd, header)) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        count = scan_records(fd, fn, ctx);
+    }
+    close(fd);
+    return count;
+}
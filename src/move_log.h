@@ -0,0 +1,118 @@
+/** @file
+ * Interfejs dziennika ruchow (write-ahead log) gry gamma
+ *
+ * Dziennik zapisuje w zwartej postaci binarnej kazdy udany ruch
+ * i zloty ruch. Zapisy sa buforowane w pamieci i utrwalane na dysku
+ * grupowo (group commit) - po zadanej liczbie ruchow lub po uplywie
+ * zadanego czasu - tak, aby pojedynczy ruch nie czekal na dysk.
+ * Po pierwszym nieudanym zapisie dziennik nie przyjmuje nowych wpisow,
+ * a wpisy z bufora sa zachowywane do skutecznego zapisu.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#ifndef MOVE_LOG_H
+#define MOVE_LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MOVE_LOG_MOVE 1 ///< rodzaj wpisu odpowiadajacy zwyklemu ruchowi
+#define MOVE_LOG_GOLDEN_MOVE 2 ///< rodzaj wpisu odpowiadajacy zlotemu ruchowi
+
+/**
+ * Struktura przechowujaca otwarty dziennik ruchow.
+ */
+typedef struct move_log move_log_t;
+
+/** @brief Otwiera dziennik ruchow do dopisywania.
+ * Otwiera (lub tworzy) plik @p path. Jesli plik jest pusty, zapisuje
+ * naglowek z parametrami gry. Jesli plik zawiera juz naglowek, sprawdza
+ * czy parametry sie zgadzaja i obcina ewentualny niepelny ostatni wpis,
+ * ktory mogl powstac przy awarii procesu. Plik jest blokowany (flock),
+ * wiec do jednego dziennika pisze naraz tylko jeden proces.
+ * @param[out] log - wskaznik, pod ktory zostanie zapisany otwarty dziennik,
+ * @param[in] path - sciezka do pliku dziennika,
+ * @param[in] width - szerokosc planszy,
+ * @param[in] height - wysokosc planszy,
+ * @param[in] players - liczba graczy,
+ * @param[in] areas - maksymalna liczba obszarow jednego gracza,
+ * @param[in] sync_every_moves - po ilu zbuforowanych ruchach wykonywany jest
+ * zapis grupowy, 0 oznacza brak limitu,
+ * @param[in] sync_every_ms - po ilu milisekundach od ostatniego zapisu
+ * wykonywany jest zapis grupowy, 0 oznacza brak limitu; zapis wykonuje
+ * osobny watek, wiec nastepuje rowniez wtedy, gdy nie ma nowych ruchow.
+ * @return Wartosc @p true, jesli udalo sie otworzyc dziennik,
+ * @p false w przeciwnym przypadku.
+ */
+bool move_log_open(move_log_t **log, const char *path,
+                   uint32_t width, uint32_t height,
+                   uint32_t players, uint32_t areas,
+                   uint32_t sync_every_moves, uint32_t sync_every_ms);
+
+/** @brief Dopisuje ruch do dziennika.
+ * Dopisuje wpis do bufora dziennika i, jesli przekroczony zostal limit
+ * ruchow, utrwala caly bufor jednym zapisem i jednym wywolaniem fdatasync.
+ * Ruch nalezy wykonac dopiero po udanym dopisaniu wpisu.
+ * @param[in,out] log - wskaznik na dziennik,
+ * @param[in] kind - rodzaj ruchu, @ref MOVE_LOG_MOVE lub
+ * @ref MOVE_LOG_GOLDEN_MOVE,
+ * @param[in] player - numer gracza,
+ * @param[in] x - numer kolumny,
+ * @param[in] y - numer wiersza.
+ * @return Wartosc @p true, jesli wpis zostal przyjety. Wartosc @p false,
+ * jesli ten lub ktorys wczesniejszy zapis na dysk sie nie powiodl;
+ * wpis nie jest wtedy dopisywany.
+ */
+bool move_log_append(move_log_t *log, uint8_t kind,
+                     uint32_t player, uint32_t x, uint32_t y);
+
+/** @brief Utrwala zbuforowane wpisy.
+ * Zapisuje wszystkie zbuforowane wpisy i wywoluje fdatasync. Po bledzie
+ * wpisy zostaja w buforze, a kolejne wywolanie ponawia zapis.
+ * @param[in,out] log - wskaznik na dziennik.
+ * @return Wartosc @p true, jesli wszystkie wpisy zostaly utrwalone,
+ * @p false w przeciwnym przypadku.
+ */
+bool move_log_sync(move_log_t *log);
+
+/** @brief Zamyka dziennik.
+ * Utrwala zbuforowane wpisy, zamyka plik i zwalnia pamiec.
+ * Nic nie robi, jesli wskaznik ma wartosc NULL.
+ * @param[in] log - wskaznik na zamykany dziennik.
+ */
+void move_log_close(move_log_t *log);
+
+/** @brief Odczytuje parametry gry z naglowka dziennika.
+ * @param[in] path - sciezka do pliku dziennika,
+ * @param[out] width - szerokosc planszy,
+ * @param[out] height - wysokosc planszy,
+ * @param[out] players - liczba graczy,
+ * @param[out] areas - maksymalna liczba obszarow jednego gracza.
+ * @return Wartosc @p true, jesli plik istnieje i zawiera poprawny naglowek,
+ * @p false w przeciwnym przypadku.
+ */
+bool move_log_read_header(const char *path, uint32_t *width, uint32_t *height,
+                          uint32_t *players, uint32_t *areas);
+
+/** @brief Funkcja wywolywana dla kazdego odtwarzanego wpisu.
+ * Zwraca @p false, jesli odtwarzanie ma zostac przerwane.
+ */
+typedef bool (*move_log_replay_fn)(void *ctx, uint8_t kind,
+                                   uint32_t player, uint32_t x, uint32_t y);
+
+/** @brief Odtwarza wpisy dziennika.
+ * Czyta plik duzymi blokami i wywoluje @p fn dla kazdego poprawnego wpisu.
+ * Niepelny lub uszkodzony ostatni wpis jest pomijany.
+ * @param[in] path - sciezka do pliku dziennika,
+ * @param[in] fn - funkcja wywolywana dla kazdego wpisu,
+ * @param[in,out] ctx - wskaznik przekazywany do @p fn.
+ * @return Liczba odtworzonych wpisow lub -1, jesli pliku nie udalo sie
+ * odczytac lub ma niepoprawny naglowek.
+ */
+int64_t move_log_replay(const char *path, move_log_replay_fn fn, void *ctx);
+
+#endif //MOVE_LOG_H
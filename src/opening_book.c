@@ -0,0 +1,148 @@
+/** @file
+ * Implementacja interfejsu opening_book.h
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "opening_book.h"
+
+/** @struct opening_book
+ * @brief Struktura przechowujaca zmapowany plik ksiazki otwarc.
+ */
+struct opening_book {
+    void *map; ///< poczatek mapowania
+    size_t size; ///< rozmiar mapowania
+    const opening_book_header_t *header; ///< naglowek pliku
+    const opening_book_entry_t *entries; ///< posortowane wpisy
+};
+
+bool opening_book_open(opening_book_t **b, const char *path) {
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) return false;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || (uint64_t) st.st_size < sizeof(opening_book_header_t)) {
+        close(fd);
+        return false;
+    }
+    void *map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED) return false;
+
+    const opening_book_header_t *header = map;
+    if(memcmp(header->magic, OPENING_BOOK_MAGIC, sizeof(header->magic)) != 0
+       || header->version != OPENING_BOOK_VERSION
+       || header->entries_offset < sizeof(opening_book_header_t)
+       || header->entries_offset % sizeof(uint64_t) != 0
+       || header->entries_offset > (uint64_t) st.st_size
+       || header->entry_count > ((uint64_t) st.st_size - header->entries_offset)
+                                / sizeof(opening_book_entry_t)) {
+        munmap(map, (size_t) st.st_size);
+        return false;
+    }
+
+    *b = malloc(sizeof(opening_book_t));
+    if(*b == NULL) {
+        munmap(map, (size_t) st.st_size);
+        return false;
+    }
+    (*b)->map = map;
+    (*b)->size = (size_t) st.st_size;
+    (*b)->header = header;
+    (*b)->entries = (const opening_book_entry_t *)
+                    ((const char *) map + header->entries_offset);
+    return true;
+}
+
+void delete_opening_book(opening_book_t *b) {
+    if(b != NULL) {
+        munmap(b->map, b->size);
+        free(b);
+    }
+}
+
+const opening_book_header_t *opening_book_header(opening_book_t *b) {
+    return b->header;
+}
+
+const opening_book_entry_t *opening_book_find(opening_book_t *b, uint64_t key) {
+    uint64_t low = 0, high = b->header->entry_count;
+    while(low < high) {
+        uint64_t middle = low + (high - low) / 2;
+        if(b->entries[middle].key < key) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    if(low < b->header->entry_count && b->entries[low].key == key) {
+        return &b->entries[low];
+    }
+    return NULL;
+}
+
+bool opening_book_move(opening_book_t *b, gamma_t *g, uint32_t to_move,
+                       uint32_t *x, uint32_t *y, bool *golden) {
+    if(b == NULL || g == NULL || b->header->width != get_width(g)
+       || b->header->height != get_height(g) || b->header->players != get_players(g)
+       || b->header->areas != get_areas(g)) {
+        return false;
+    }
+    uint32_t transform;
+    uint64_t key = gamma_canonical_hash(g, to_move, &transform);
+    const opening_book_entry_t *e = opening_book_find(b, key);
+    if(e == NULL || e->x >= get_width(g) || e->y >= get_height(g)) {
+        return false;
+    }
+    *golden = (e->flags & OPENING_BOOK_GOLDEN) != 0;
+    return gamma_transform_field(g, gamma_inverse_transform(transform), e->x, e->y, x, y);
+}
+
+/** @brief Porownuje wpisy wedlug klucza.
+ * @param[in] a - wskaznik na pierwszy wpis,
+ * @param[in] b - wskaznik na drugi wpis.
+ * @return liczba ujemna, zero lub dodatnia, jesli klucz pierwszego wpisu
+ * jest odpowiednio mniejszy, rowny lub wiekszy.
+ */
+static int compare_entries(const void *a, const void *b) {
+    uint64_t ka = ((const opening_book_entry_t *) a)->key;
+    uint64_t kb = ((const opening_book_entry_t *) b)->key;
+    return (ka > kb) - (ka < kb);
+}
+
+bool opening_book_write(const char *path, gamma_t *g,
+                        opening_book_entry_t *entries, uint64_t count) {
+    qsort(entries, count, sizeof(opening_book_entry_t), compare_entries);
+    uint64_t unique = 0;
+    for(uint64_t i = 0; i < count; ++i) {
+        if(unique == 0 || entries[unique - 1].key != entries[i].key) {
+            entries[unique++] = entries[i];
+        }
+    }
+
+    opening_book_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, OPENING_BOOK_MAGIC, sizeof(header.magic));
+    header.version = OPENING_BOOK_VERSION;
+    header.width = get_width(g);
+    header.height = get_height(g);
+    header.players = get_players(g);
+    header.areas = get_areas(g);
+    header.entry_count = unique;
+    header.entries_offset = sizeof(header);
+
+    FILE *file = fopen(path, "wb");
+    if(file == NULL) return false;
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1
+                   && fwrite(entries, sizeof(opening_book_entry_t), unique, file) == unique;
+    return (fclose(file) == 0) && written;
+}
@@ -0,0 +1,118 @@
+/** @file
+ * Interfejs ksiazki otwarc gry gamma
+ *
+ * Ksiazka otwarc jest plikiem zaczynajacym sie naglowkiem
+ * @ref opening_book_header, za ktorym od pozycji @p entries_offset lezy
+ * tablica wpisow @ref opening_book_entry posortowana rosnaco wedlug klucza.
+ * Kluczem jest kanoniczny skrot pozycji z graczem wykonujacym ruch
+ * (@ref gamma_canonical_hash), a ruch jest zapisany we wspolrzednych
+ * pozycji kanonicznej. Plik jest mapowany do pamieci tylko do odczytu
+ * i przeszukiwany binarnie, bez wczytywania, wiec czas otwarcia nie zalezy
+ * od rozmiaru ksiazki.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#ifndef OPENING_BOOK_H
+#define OPENING_BOOK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "gamma.h"
+
+#define OPENING_BOOK_MAGIC "GAMMABK1" ///< znacznik poczatku pliku
+#define OPENING_BOOK_VERSION 1 ///< wersja formatu pliku
+#define OPENING_BOOK_GOLDEN 1 ///< flaga wpisu: ruch jest zlotym ruchem
+#define OPENING_BOOK_EXACT 2 ///< flaga wpisu: wynik jest dokladny
+
+/** @struct opening_book_header
+ * @brief Naglowek pliku ksiazki otwarc.
+ */
+typedef struct opening_book_header {
+    char magic[8]; ///< @ref OPENING_BOOK_MAGIC bez konczacego zera
+    uint32_t version; ///< @ref OPENING_BOOK_VERSION
+    uint32_t width; ///< szerokosc planszy
+    uint32_t height; ///< wysokosc planszy
+    uint32_t players; ///< liczba graczy
+    uint32_t areas; ///< maksymalna liczba obszarow gracza
+    uint32_t reserved; ///< zero
+    uint64_t entry_count; ///< ilosc wpisow
+    uint64_t entries_offset; ///< pozycja pierwszego wpisu od poczatku pliku
+} opening_book_header_t;
+
+/** @struct opening_book_entry
+ * @brief Wpis ksiazki otwarc.
+ */
+typedef struct opening_book_entry {
+    uint64_t key; ///< kanoniczny skrot pozycji z graczem wykonujacym ruch
+    uint32_t x; ///< numer kolumny najlepszego ruchu w pozycji kanonicznej
+    uint32_t y; ///< numer wiersza najlepszego ruchu w pozycji kanonicznej
+    uint32_t flags; ///< @ref OPENING_BOOK_GOLDEN, @ref OPENING_BOOK_EXACT
+    uint32_t depth; ///< glebokosc przeszukiwania, ktore wybralo ruch
+    int64_t value; ///< wynik gracza wykonujacego ruch
+    uint64_t nodes; ///< ilosc pozycji odwiedzonych przy wyborze ruchu
+} opening_book_entry_t;
+
+/**
+ * Struktura przechowujaca zmapowany plik ksiazki otwarc.
+ */
+typedef struct opening_book opening_book_t;
+
+/** @brief Mapuje ksiazke otwarc tylko do odczytu.
+ * @param[out] b - wskaznik, pod ktory zostanie zapisana ksiazka,
+ * @param[in] path - sciezka pliku ksiazki.
+ * @return Wartosc @p true, jesli plik istnieje i ma poprawny naglowek,
+ * @p false w przeciwnym przypadku.
+ */
+bool opening_book_open(opening_book_t **b, const char *path);
+
+/** @brief Odmapowuje ksiazke otwarc.
+ * Nic nie robi, jesli wskaznik ma wartosc NULL.
+ * @param[in] b - wskaznik na ksiazke.
+ */
+void delete_opening_book(opening_book_t *b);
+
+/** @brief Podaje naglowek ksiazki.
+ * @param[in] b - wskaznik na ksiazke.
+ * @return Wskaznik na naglowek.
+ */
+const opening_book_header_t *opening_book_header(opening_book_t *b);
+
+/** @brief Szuka wpisu o danym kluczu.
+ * @param[in] b - wskaznik na ksiazke,
+ * @param[in] key - klucz pozycji.
+ * @return Wskaznik na wpis lub NULL, jesli ksiazka nie zawiera klucza.
+ */
+const opening_book_entry_t *opening_book_find(opening_book_t *b, uint64_t key);
+
+/** @brief Podaje ruch z ksiazki dla pozycji gry.
+ * Nie sprawdza, czy ruch jest legalny.
+ * @param[in] b - wskaznik na ksiazke,
+ * @param[in] g - wskaznik na gre,
+ * @param[in] to_move - numer gracza wykonujacego ruch,
+ * @param[out] x - numer kolumny ruchu,
+ * @param[out] y - numer wiersza ruchu,
+ * @param[out] golden - czy ruch jest zlotym ruchem.
+ * @return Wartosc @p true, jesli ksiazka zawiera pozycje, @p false jesli
+ * jej nie zawiera lub ma inne parametry gry niz @p g.
+ */
+bool opening_book_move(opening_book_t *b, gamma_t *g, uint32_t to_move,
+                       uint32_t *x, uint32_t *y, bool *golden);
+
+/** @brief Zapisuje ksiazke otwarc.
+ * Sortuje wpisy wedlug klucza i zapisuje je do pliku razem z naglowkiem
+ * opisujacym parametry gry @p g. Z wpisow o tym samym kluczu zapisywany
+ * jest tylko jeden.
+ * @param[in] path - sciezka tworzonego pliku,
+ * @param[in] g - gra o parametrach ksiazki,
+ * @param[in,out] entries - wpisy, sortowane w miejscu,
+ * @param[in] count - ilosc wpisow.
+ * @return Wartosc @p true, jesli udalo sie zapisac plik,
+ * @p false w przeciwnym przypadku.
+ */
+bool opening_book_write(const char *path, gamma_t *g,
+                        opening_book_entry_t *entries, uint64_t count);
+
+#endif //OPENING_BOOK_H
@@ -116,7 +116,8 @@ void process_line(char *line, uint32_t *parsed_command) {
     else {
 
         char delimit[] = " \t\r\n\v\f";
-        char *token = strtok(line, delimit);
+        char *save_ptr;
+        char *token = strtok_r(line, delimit, &save_ptr);
         unsigned int wordCount = 0;
 
         while (token) {
@@ -127,13 +128,22 @@ void process_line(char *line, uint32_t *parsed_command) {
 
             parsedLine[wordCount++] = token;
 
-            token = strtok(NULL, delimit);
+            token = strtok_r(NULL, delimit, &save_ptr);
         }
 
-        if (wordCount != MAX_NUMBER_OF_COMMANDS) {
+        if (wordCount == 1 && strcmp(parsedLine[0], "S") == 0) {
+            parsed_command[0] = SESSION_MODE;
+        }
+        else if (wordCount > MAX_NUMBER_OF_COMMANDS && strcmp(parsedLine[0], "I") != 0) {
+            parsed_command[0] = INCORRECT_COMMAND;
+        }
+        else if (wordCount < MAX_NUMBER_OF_COMMANDS) {
             parsed_command[0] = INCORRECT_COMMAND;
         }
         else {
+            /* Dalsze slowa komendy I sa numerami graczy komputerowych,
+             * interpretowanymi przez process_bot_players. */
+            wordCount = MAX_NUMBER_OF_COMMANDS;
             check_first_word(parsedLine[0],parsed_command);
             for(unsigned int i = 1; i < wordCount; ++i) {
                 if (!contains_only_digits(parsedLine[i], strlen(parsedLine[i]))) {
@@ -156,6 +166,34 @@ void process_line(char *line, uint32_t *parsed_command) {
     }
 }
 
+bool process_bot_players(char *line, uint32_t players,
+                         uint32_t **bots, uint32_t *bot_count) {
+    char delimit[] = " \t\r\n\v\f";
+    char *save_ptr;
+    size_t length = strlen(line);
+    char *token = strtok_r(line, delimit, &save_ptr);
+    *bots = malloc(sizeof(uint32_t) * (length / 2 + 1));
+    *bot_count = 0;
+    if (*bots == NULL) {
+        return false;
+    }
+
+    for (unsigned int word = 0; token != NULL; ++word) {
+        if (word >= MAX_NUMBER_OF_COMMANDS) {
+            if (!contains_only_digits(token, strlen(token)) || !in_uint32_t_range(token)) {
+                return false;
+            }
+            uint32_t player = strtoul(token, NULL, 10);
+            if (player == 0 || player > players) {
+                return false;
+            }
+            (*bots)[(*bot_count)++] = player;
+        }
+        token = strtok_r(NULL, delimit, &save_ptr);
+    }
+    return true;
+}
+
 /** @brief interpretuje pierwsze slowo w linii podawanej w trybie wsadowym.
  * interpretuje pierwsze slowo w linii podawanej w trybie wsadowym.
  * odpowiednio modyfikuje tablice odpowiedzialna za przekazywanie wiadomosci.
@@ -181,6 +219,9 @@ static void check_first_word_batch_mode(const char *word, uint32_t *parsed_comma
     else if(strcmp(word, "p") == 0) {
         parsed_command[0] = GAMMA_BOARD;
     }
+    else if(strcmp(word, "d") == 0) {
+        parsed_command[0] = GAMMA_BOARD_DIFF;
+    }
     else {
         parsed_command[0] = INCORRECT_COMMAND;
     }
@@ -204,7 +245,8 @@ void process_line_batch_mode(char *line, uint32_t *parsed_command) {
     else {
 
         char delimit[] = " \t\r\n\v\f";
-        char *token = strtok(line, delimit);
+        char *save_ptr;
+        char *token = strtok_r(line, delimit, &save_ptr);
         unsigned int wordCount = 0;
 
         while (token) {
@@ -215,7 +257,7 @@ void process_line_batch_mode(char *line, uint32_t *parsed_command) {
 
             parsedLine[wordCount++] = token;
 
-            token = strtok(NULL, delimit);
+            token = strtok_r(NULL, delimit, &save_ptr);
         }
 
         if (wordCount > MAX_NUMBER_OF_COMMANDS) {
@@ -240,11 +282,17 @@ void process_line_batch_mode(char *line, uint32_t *parsed_command) {
                 (parsed_command[0] == GAMMA_BUSY_FIELDS && wordCount != 2) ||
                 (parsed_command[0] == GAMMA_FREE_FIELDS && wordCount != 2) ||
                 (parsed_command[0] == GAMMA_GOLDEN_POSSIBLE && wordCount != 2) ||
-                (parsed_command[0] == GAMMA_BOARD && wordCount != 1)) {
+                (parsed_command[0] == GAMMA_BOARD && wordCount != 1
+                 && wordCount != MAX_NUMBER_OF_COMMANDS) ||
+                (parsed_command[0] == GAMMA_BOARD_DIFF && wordCount != 1)) {
                 parsed_command[0] = INCORRECT_COMMAND;
                 return;
             }
 
+            if (parsed_command[0] == GAMMA_BOARD && wordCount != 1) {
+                parsed_command[0] = GAMMA_BOARD_REGION;
+            }
+
             for (unsigned int i = 1; i < wordCount; ++i) {
                 parsed_command[i] = strtoul(parsedLine[i], NULL, 10);
             }
@@ -253,3 +301,96 @@ void process_line_batch_mode(char *line, uint32_t *parsed_command) {
 
     }
 }
+
+/** @brief interpretuje pierwsze slowo w linii podawanej w trybie wielu gier.
+ * odpowiednio modyfikuje tablice odpowiedzialna za przekazywanie wiadomosci.
+ * @param[in] word - slowo do interpretacji
+ * @param[in,out] parsed_command - tablica zawierajaca parsowana wiadomosc.
+ */
+static void check_first_word_session_mode(const char *word,
+                                          uint32_t *parsed_command) {
+    if(strcmp(word, "n") == 0) {
+        parsed_command[0] = GAMMA_NEW;
+    }
+    else if(strcmp(word, "r") == 0) {
+        parsed_command[0] = GAMMA_DELETE;
+    }
+    else {
+        check_first_word_batch_mode(word, parsed_command);
+    }
+}
+
+void process_line_session_mode(char *line, uint32_t *parsed_command) {
+    char *parsedLine[MAX_NUMBER_OF_SESSION_COMMANDS];
+
+    if (line[0] == '#' || line[0] == '\n') {
+        parsed_command[0] = COMMENT;
+    }
+    else if (is_all_white(line, strlen(line))) {
+        parsed_command[0] = INCORRECT_COMMAND;
+    }
+    else if (!ends_with_endl(line)) {
+        parsed_command[0] = INCORRECT_COMMAND;
+    }
+    else if(!doesnt_begin_with_white_character(line)) {
+        parsed_command[0] = INCORRECT_COMMAND;
+    }
+    else {
+
+        char delimit[] = " \t\r\n\v\f";
+        char *save_ptr;
+        char *token = strtok_r(line, delimit, &save_ptr);
+        unsigned int wordCount = 0;
+
+        while (token) {
+            if (wordCount == MAX_NUMBER_OF_SESSION_COMMANDS) {
+                wordCount = MAX_NUMBER_OF_SESSION_COMMANDS + 1;
+                break;
+            }
+
+            parsedLine[wordCount++] = token;
+
+            token = strtok_r(NULL, delimit, &save_ptr);
+        }
+
+        if (wordCount > MAX_NUMBER_OF_SESSION_COMMANDS || wordCount < 2) {
+            parsed_command[0] = INCORRECT_COMMAND;
+            return;
+        }
+
+        check_first_word_session_mode(parsedLine[0], parsed_command);
+
+        for (unsigned int i = 1; i < wordCount; ++i) {
+            if (!contains_only_digits(parsedLine[i], strlen(parsedLine[i]))) {
+                parsed_command[0] = INCORRECT_COMMAND;
+                return;
+            }
+            else if(!in_uint32_t_range(parsedLine[i])) {
+                parsed_command[0] = INCORRECT_COMMAND;
+                return;
+            }
+        }
+
+        if ((parsed_command[0] == GAMMA_NEW && wordCount != 6) ||
+            (parsed_command[0] == GAMMA_DELETE && wordCount != 2) ||
+            (parsed_command[0] == GAMMA_MOVE && wordCount != 5) ||
+            (parsed_command[0] == GAMMA_GOLDEN_MOVE && wordCount != 5) ||
+            (parsed_command[0] == GAMMA_BUSY_FIELDS && wordCount != 3) ||
+            (parsed_command[0] == GAMMA_FREE_FIELDS && wordCount != 3) ||
+            (parsed_command[0] == GAMMA_GOLDEN_POSSIBLE && wordCount != 3) ||
+            (parsed_command[0] == GAMMA_BOARD && wordCount != 2
+             && wordCount != MAX_NUMBER_OF_SESSION_COMMANDS) ||
+            (parsed_command[0] == GAMMA_BOARD_DIFF && wordCount != 2)) {
+            parsed_command[0] = INCORRECT_COMMAND;
+            return;
+        }
+
+        if (parsed_command[0] == GAMMA_BOARD && wordCount != 2) {
+            parsed_command[0] = GAMMA_BOARD_REGION;
+        }
+
+        for (unsigned int i = 1; i < wordCount; ++i) {
+            parsed_command[i] = strtoul(parsedLine[i], NULL, 10);
+        }
+    }
+}
@@ -9,6 +9,7 @@
 
 #ifndef PARSER_H
 #define PARSER_H
+#define _GNU_SOURCE
 #include <stdbool.h>
 #include <glob.h>
 #include <stddef.h>
@@ -24,6 +25,21 @@
  */
 void process_line(char *line, uint32_t *parsed_command);
 
+/** @brief interpretuje numery graczy komputerowych z linii komendy I.
+ * Slowa po piatym slowie linii sa numerami graczy, ktorymi gra komputer.
+ * @param[in] line   – tekst do interpretacji, niezmieniony przez
+ * @ref process_line,
+ * @param[in] players - ilosc graczy,
+ * @param[out] bots - wskaznik, pod ktorym zapisywana jest zaalokowana
+ * tablica numerow graczy; wywolujacy musi ja zwolnic rowniez po bledzie,
+ * @param[out] bot_count - ilosc numerow graczy.
+ * @return Wartosc @p true, jesli kazde slowo jest numerem gracza od 1
+ * do @p players, @p false w przeciwnym przypadku lub gdy nie udalo sie
+ * zaalokowac pamieci.
+ */
+bool process_bot_players(char *line, uint32_t players,
+                         uint32_t **bots, uint32_t *bot_count);
+
 /** @brief interpretuje znaczenie linii w trybie wsadowym.
  * @param[in] line   – tekst do interpretacji
  * @param[in,out] parsed_command - tablica,
@@ -31,4 +47,13 @@ void process_line(char *line, uint32_t *parsed_command);
  */
 void process_line_batch_mode(char *line, uint32_t *parsed_command);
 
+/** @brief interpretuje znaczenie linii w trybie wielu gier.
+ * Drugie slowo kazdej komendy jest numerem gry, ktorej dotyczy komenda.
+ * @param[in] line   – tekst do interpretacji
+ * @param[in,out] parsed_command - tablica o rozmiarze co najmniej
+ * @ref MAX_NUMBER_OF_SESSION_COMMANDS, w ktorej znajduje sie
+ * zinterpretowana wiadomosc.
+ */
+void process_line_session_mode(char *line, uint32_t *parsed_command);
+
 #endif //PARSER_H
@@ -0,0 +1,119 @@
+/** @file
+ * Implementacja interfejsu perf_counters.h
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "perf_counters.h"
+
+/** @struct perf_counters
+ * @brief Struktura przechowujaca deskryptory licznikow.
+ */
+struct perf_counters {
+    int fd[PERF_NUMBER_OF_COUNTERS]; ///< deskryptory licznikow lub -1
+};
+
+/** Nazwy licznikow w kolejnosci indeksow. */
+static const char *counter_names[PERF_NUMBER_OF_COUNTERS] = {
+    "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"
+};
+
+/** @brief Otwiera jeden licznik biezacego watku.
+ * @param[in] type - rodzaj zdarzenia,
+ * @param[in] config - konfiguracja zdarzenia.
+ * @return deskryptor licznika lub -1.
+ */
+static int open_counter(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED
+                       | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+}
+
+bool perf_counters_open(perf_counters_t **pc) {
+    *pc = malloc(sizeof(perf_counters_t));
+    if(*pc == NULL) return false;
+
+    (*pc)->fd[PERF_CYCLES] =
+        open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    (*pc)->fd[PERF_INSTRUCTIONS] =
+        open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    (*pc)->fd[PERF_L1D_MISSES] =
+        open_counter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D
+                     | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                     | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    (*pc)->fd[PERF_LLC_MISSES] =
+        open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    (*pc)->fd[PERF_BRANCH_MISSES] =
+        open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+
+    for(int i = 0; i < PERF_NUMBER_OF_COUNTERS; ++i) {
+        if((*pc)->fd[i] >= 0) return true;
+    }
+    free(*pc);
+    *pc = NULL;
+    return false;
+}
+
+void perf_counters_close(perf_counters_t *pc) {
+    if(pc != NULL) {
+        for(int i = 0; i < PERF_NUMBER_OF_COUNTERS; ++i) {
+            if(pc->fd[i] >= 0) close(pc->fd[i]);
+        }
+        free(pc);
+    }
+}
+
+void perf_counters_start(perf_counters_t *pc) {
+    for(int i = 0; i < PERF_NUMBER_OF_COUNTERS; ++i) {
+        if(pc->fd[i] >= 0) {
+            ioctl(pc->fd[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(pc->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+void perf_counters_stop(perf_counters_t *pc, uint64_t *values) {
+    for(int i = 0; i < PERF_NUMBER_OF_COUNTERS; ++i) {
+        if(pc->fd[i] >= 0) {
+            ioctl(pc->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for(int i = 0; i < PERF_NUMBER_OF_COUNTERS; ++i) {
+        /* Odczyt zawiera wartosc, czas wlaczenia i czas faktycznego
+         * liczenia zdarzenia. */
+        uint64_t data[3];
+        values[i] = PERF_UNAVAILABLE;
+        if(pc->fd[i] >= 0 && read(pc->fd[i], data, sizeof(data)) == sizeof(data)) {
+            if(data[2] == 0) {
+                values[i] = (data[1] == 0) ? 0 : PERF_UNAVAILABLE;
+            }
+            else if(data[2] < data[1]) {
+                values[i] = (uint64_t) ((double) data[0] * (double) data[1]
+                                        / (double) data[2]);
+            }
+            else {
+                values[i] = data[0];
+            }
+        }
+    }
+}
+
+const char *perf_counter_name(int counter) {
+    return counter_names[counter];
+}
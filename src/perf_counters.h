@@ -0,0 +1,67 @@
+/** @file
+ * Interfejs odczytu sprzetowych licznikow wydajnosci (perf_event_open)
+ *
+ * Liczniki mierza tylko kod uzytkownika biezacego watku, wiec dzialaja
+ * przy domyslnym ustawieniu kernel.perf_event_paranoid rownym 2.
+ * Liczniki, ktorych nie udalo sie otworzyc (brak uprawnien, maszyna
+ * wirtualna bez PMU), sa zglaszane jako niedostepne.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define PERF_CYCLES 0 ///< indeks licznika cykli procesora
+#define PERF_INSTRUCTIONS 1 ///< indeks licznika wykonanych instrukcji
+#define PERF_L1D_MISSES 2 ///< indeks licznika chybien pamieci L1 danych
+#define PERF_LLC_MISSES 3 ///< indeks licznika chybien pamieci ostatniego poziomu
+#define PERF_BRANCH_MISSES 4 ///< indeks licznika blednie przewidzianych skokow
+#define PERF_NUMBER_OF_COUNTERS 5 ///< liczba licznikow
+#define PERF_UNAVAILABLE UINT64_MAX ///< wartosc niedostepnego licznika
+
+/**
+ * Struktura przechowujaca otwarte liczniki.
+ */
+typedef struct perf_counters perf_counters_t;
+
+/** @brief Otwiera liczniki.
+ * @param[out] pc - wskaznik, pod ktory zostana zapisane liczniki.
+ * @return Wartosc @p true, jesli udalo sie otworzyc przynajmniej jeden
+ * licznik, @p false w przeciwnym przypadku.
+ */
+bool perf_counters_open(perf_counters_t **pc);
+
+/** @brief Zamyka liczniki.
+ * Nic nie robi, jesli wskaznik ma wartosc NULL.
+ * @param[in] pc - wskaznik na liczniki.
+ */
+void perf_counters_close(perf_counters_t *pc);
+
+/** @brief Zeruje i uruchamia liczniki.
+ * @param[in,out] pc - wskaznik na liczniki.
+ */
+void perf_counters_start(perf_counters_t *pc);
+
+/** @brief Zatrzymuje liczniki i odczytuje ich wartosci.
+ * Wartosci sa skalowane, jesli jadro musialo wspoldzielic liczniki
+ * sprzetowe miedzy zdarzeniami.
+ * @param[in,out] pc - wskaznik na liczniki,
+ * @param[out] values - tablica o rozmiarze @ref PERF_NUMBER_OF_COUNTERS,
+ * niedostepne liczniki maja wartosc @ref PERF_UNAVAILABLE.
+ */
+void perf_counters_stop(perf_counters_t *pc, uint64_t *values);
+
+/** @brief Podaje krotka nazwe licznika.
+ * @param[in] counter - indeks licznika.
+ * @return nazwa licznika.
+ */
+const char *perf_counter_name(int counter);
+
+#endif //PERF_COUNTERS_H
@@ -0,0 +1,200 @@
+/** @file
+ * Implementacja interfejsu player_table.h
+ *
+ * Indeks odwzorowujacy numer gracza na pozycje wpisu jest tablica
+ * haszujaca z liniowym probkowaniem, ktora przechowuje pozycje powiekszone
+ * o jeden, a zero oznacza brak wpisu. Wpisy nigdy nie sa usuwane, wiec tablica nie potrzebuje znacznikow
+ * usuniecia.
+ *
+ * Wpisy i indeks haszujacy leza w jednym bloku, ktory przy powiekszaniu
+ * jest kopiowany do nowego bloku publikowanego atomowo. Stare bloki nie sa
+ * zwalniane az do usuniecia tablicy, wiec watek czytajacy nigdy nie siega
+ * do zwolnionej pamieci; bloki rosna geometrycznie, wiec stare bloki
+ * zajmuja razem nie wiecej niz biezacy.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#include <string.h>
+#include "player_table.h"
+
+#define PLAYER_TABLE_INITIAL_CAPACITY 16 ///< poczatkowa liczba wpisow
+
+/** Odczytuje wartosc, ktora moze byc rownoczesnie zmieniana przez pisarza. */
+#define RELAXED_LOAD(lvalue) __atomic_load_n(&(lvalue), __ATOMIC_RELAXED)
+
+/** @struct player_block
+ * @brief Blok z wpisami graczy i indeksem haszujacym.
+ */
+typedef struct player_block {
+    uint32_t capacity; ///< liczba miejsc na wpisy
+    uint64_t index_capacity; ///< rozmiar indeksu
+    uint32_t *index; ///< pozycje wpisow powiekszone o jeden
+    struct player_block *retired; ///< poprzedni, wycofany blok lub NULL
+    player_entry_t entries[]; ///< gesta tablica wpisow, za nia indeks haszujacy
+} player_block_t;
+
+/** @struct player_table
+ * @brief Struktura przechowujaca stan aktywnych graczy.
+ */
+struct player_table {
+    player_block_t *block; ///< biezacy blok, publikowany atomowo
+    uint32_t size; ///< liczba wpisow
+    uint64_t retired_bytes; ///< laczny rozmiar wycofanych blokow
+};
+
+/** @brief Haszuje numer gracza.
+ * @param[in] id - numer gracza,
+ * @param[in] capacity - liczba kubelkow, potega dwojki.
+ * @return numer kubelka.
+ */
+static uint64_t slot_of(uint32_t id, uint64_t capacity) {
+    return ((uint64_t) id * 0x9E3779B97F4A7C15u >> 32) & (capacity - 1);
+}
+
+/** @brief Podaje rozmiar bloku.
+ * @param[in] capacity - liczba miejsc na wpisy.
+ * @return liczba bajtow bloku.
+ */
+static uint64_t block_size(uint32_t capacity) {
+    return sizeof(player_block_t) + sizeof(player_entry_t) * (uint64_t) capacity
+           + sizeof(uint32_t) * 2 * (uint64_t) capacity;
+}
+
+/** @brief Tworzy pusty blok.
+ * @param[in] capacity - liczba miejsc na wpisy.
+ * @return Wskaznik na blok lub NULL, jesli nie udalo sie zaalokowac pamieci.
+ */
+static player_block_t *block_new(uint32_t capacity) {
+    player_block_t *b = calloc(1, block_size(capacity));
+    if(b == NULL) return NULL;
+    b->capacity = capacity;
+    b->index = (uint32_t *) (b->entries + capacity);
+    b->index_capacity = 2 * (uint64_t) capacity;
+    return b;
+}
+
+bool player_table_init(player_table_t **t) {
+    *t = calloc(1, sizeof(player_table_t));
+    if(*t == NULL) return false;
+    (*t)->block = block_new(PLAYER_TABLE_INITIAL_CAPACITY);
+    if((*t)->block == NULL) {
+        delete_player_table(*t);
+        *t = NULL;
+        return false;
+    }
+    return true;
+}
+
+void delete_player_table(player_table_t *t) {
+    if(t != NULL) {
+        player_block_t *b = t->block;
+        while(b != NULL) {
+            player_block_t *retired = b->retired;
+            free(b);
+            b = retired;
+        }
+        free(t);
+    }
+}
+
+/** @brief Znajduje pozycje indeksu gracza lub pierwsza pusta pozycje.
+ * Wolana tylko przez pisarza.
+ * @param[in] b - blok, w ktorym szukany jest gracz,
+ * @param[in] id - numer gracza.
+ * @return pozycja w indeksie bloku.
+ */
+static uint64_t probe(player_block_t *b, uint32_t id) {
+    uint64_t i = slot_of(id, b->index_capacity);
+    while(b->index[i] != 0 && b->entries[b->index[i] - 1].id != id) {
+        i = (i + 1) & (b->index_capacity - 1);
+    }
+    return i;
+}
+
+player_entry_t *player_table_find(player_table_t *t, uint32_t id) {
+    player_block_t *b = __atomic_load_n(&t->block, __ATOMIC_ACQUIRE);
+    uint64_t i = slot_of(id, b->index_capacity);
+    while(true) {
+        uint32_t position = RELAXED_LOAD(b->index[i]);
+        if(position == 0) return NULL;
+        player_entry_t *e = &b->entries[position - 1];
+        if(RELAXED_LOAD(e->id) == id) return e;
+        i = (i + 1) & (b->index_capacity - 1);
+    }
+}
+
+/** @brief Przenosi wpisy do dwa razy wiekszego bloku i publikuje go.
+ * @param[in,out] t - wskaznik na tablice graczy.
+ * @return Wartosc @p true, jesli udalo sie zaalokowac pamiec,
+ * @p false w przeciwnym przypadku.
+ */
+static bool grow(player_table_t *t) {
+    player_block_t *old = t->block;
+    player_block_t *b = block_new(old->capacity * 2);
+    if(b == NULL) return false;
+    memcpy(b->entries, old->entries, sizeof(player_entry_t) * t->size);
+    for(uint32_t i = 0; i < t->size; ++i) {
+        b->index[probe(b, b->entries[i].id)] = i + 1;
+    }
+    b->retired = old;
+    t->retired_bytes += block_size(old->capacity);
+    __atomic_store_n(&t->block, b, __ATOMIC_RELEASE);
+    return true;
+}
+
+player_entry_t *player_table_get(player_table_t *t, uint32_t id) {
+    player_block_t *b = t->block;
+    uint64_t slot = probe(b, id);
+    if(b->index[slot] != 0) return &b->entries[b->index[slot] - 1];
+
+    if(t->size == b->capacity) {
+        if(!grow(t)) return NULL;
+        b = t->block;
+        slot = probe(b, id);
+    }
+
+    player_entry_t *e = &b->entries[t->size];
+    e->id = id;
+    e->golden_move_used = false;
+    e->areas = 0;
+    e->field_count = 0;
+    /* Pozycja jest publikowana po wypelnieniu wpisu. */
+    __atomic_store_n(&b->index[slot], ++t->size, __ATOMIC_RELEASE);
+    return e;
+}
+
+uint32_t player_table_size(player_table_t *t) {
+    return t->size;
+}
+
+player_entry_t *player_table_entries(player_table_t *t) {
+    return t->block->entries;
+}
+
+uint64_t player_table_memory_usage(player_table_t *t) {
+    return sizeof(player_table_t) + block_size(t->block->capacity)
+           + t->retired_bytes;
+}
+
+uint64_t player_table_memory_estimate(void) {
+    return sizeof(player_table_t) + block_size(PLAYER_TABLE_INITIAL_CAPACITY);
+}
+
+bool player_table_copy(player_table_t *dst, player_table_t *src) {
+    for(uint32_t i = 0; i < dst->size; ++i) {
+        player_entry_t *e = &dst->block->entries[i];
+        e->golden_move_used = false;
+        e->areas = 0;
+        e->field_count = 0;
+    }
+    for(uint32_t i = 0; i < src->size; ++i) {
+        player_entry_t *from = &src->block->entries[i];
+        player_entry_t *e = player_table_get(dst, from->id);
+        if(e == NULL) return false;
+        *e = *from;
+    }
+    return true;
+}
@@ -0,0 +1,108 @@
+/** @file
+ * Interfejs tablicy stanu graczy
+ *
+ * Stan gracza (liczba obszarow, liczba pol i wykorzystanie zlotego ruchu)
+ * jest przechowywany w gestej tablicy wpisow tylko dla graczy, ktorzy
+ * kiedykolwiek postawili pionek lub wykonali zloty ruch. Gracz bez wpisu
+ * ma stan domyslny. Numer gracza jest odwzorowywany na indeks wpisu tablica
+ * haszujaca, wiec pamiec jest proporcjonalna do liczby aktywnych graczy,
+ * a nie do najwiekszego numeru gracza.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#ifndef PLAYER_TABLE_H
+#define PLAYER_TABLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/** @struct player_entry
+ * @brief Stan jednego aktywnego gracza.
+ */
+typedef struct player_entry {
+    uint32_t id; ///< numer gracza
+    bool golden_move_used; ///< czy gracz wykonal juz zloty ruch
+    uint64_t areas; ///< liczba rozlacznych obszarow gracza
+    uint64_t field_count; ///< liczba pol zajmowanych przez gracza
+} player_entry_t;
+
+/**
+ * Struktura przechowujaca stan aktywnych graczy.
+ */
+typedef struct player_table player_table_t;
+
+/** @brief Tworzy pusta tablice graczy.
+ * @param[out] t - wskaznik, pod ktory zostanie zapisana nowa tablica.
+ * @return Wartosc @p true, jesli udalo sie zaalokowac pamiec,
+ * @p false w przeciwnym przypadku.
+ */
+bool player_table_init(player_table_t **t);
+
+/** @brief Usuwa tablice graczy.
+ * Nic nie robi, jesli wskaznik ma wartosc NULL.
+ * @param[in] t - wskaznik na usuwana tablice.
+ */
+void delete_player_table(player_table_t *t);
+
+/** @brief Wyszukuje wpis gracza.
+ * @param[in] t - wskaznik na tablice graczy,
+ * @param[in] id - numer gracza.
+ * @return Wskaznik na wpis gracza lub NULL, jesli gracz nie ma wpisu.
+ * Wskaznik wskazuje na pamiec wazna az do usuniecia tablicy, ale po
+ * najblizszym wywolaniu @ref player_table_get moze opisywac nieaktualny stan.
+ * Funkcja moze byc wolana rownolegle z funkcja @ref player_table_get;
+ * wynik jest wtedy poprawny tylko wtedy, gdy w miedzyczasie nie zmieniono
+ * tablicy, co wywolujacy musi sprawdzic sam.
+ */
+player_entry_t *player_table_find(player_table_t *t, uint32_t id);
+
+/** @brief Wyszukuje wpis gracza, tworzac go w razie potrzeby.
+ * Nowy wpis ma stan domyslny: zero obszarow, zero pol
+ * i niewykorzystany zloty ruch.
+ * @param[in,out] t - wskaznik na tablice graczy,
+ * @param[in] id - numer gracza.
+ * @return Wskaznik na wpis gracza lub NULL, jesli nie udalo sie zaalokowac
+ * pamieci. Wskaznik jest wazny do nastepnego wywolania tej funkcji.
+ */
+player_entry_t *player_table_get(player_table_t *t, uint32_t id);
+
+/** @brief Podaje liczbe wpisow w tablicy.
+ * @param[in] t - wskaznik na tablice graczy.
+ * @return liczba graczy, ktorzy maja wpis.
+ */
+uint32_t player_table_size(player_table_t *t);
+
+/** @brief Podaje gesta tablice wpisow.
+ * @param[in] t - wskaznik na tablice graczy.
+ * @return Wskaznik na pierwszy z @ref player_table_size wpisow,
+ * wazny do najblizszego wywolania @ref player_table_get.
+ */
+player_entry_t *player_table_entries(player_table_t *t);
+
+/** @brief Podaje pamiec zajmowana przez tablice graczy.
+ * @param[in] t - wskaznik na tablice graczy.
+ * @return liczba zaalokowanych bajtow, bez narzutu alokatora.
+ */
+uint64_t player_table_memory_usage(player_table_t *t);
+
+/** @brief Podaje pamiec zajmowana przez pusta tablice graczy.
+ * @return liczba bajtow, ktore zaalokowalaby funkcja @ref player_table_init.
+ */
+uint64_t player_table_memory_estimate(void);
+
+/** @brief Kopiuje stan graczy.
+ * Ustawia wpisy tablicy @p dst tak, aby opisywaly tych samych graczy co
+ * tablica @p src. Wpisy graczy nieobecnych w @p src sa zerowane, co jest
+ * rownowazne ich braku. Wolana tylko przez pisarza tablicy @p dst.
+ * @param[in,out] dst - wskaznik na tablice, do ktorej kopiujemy,
+ * @param[in] src - wskaznik na kopiowana tablice.
+ * @return Wartosc @p true, jesli udalo sie skopiowac wszystkie wpisy,
+ * @p false jesli nie udalo sie zaalokowac pamieci.
+ */
+bool player_table_copy(player_table_t *dst, player_table_t *src);
+
+#endif //PLAYER_TABLE_H
@@ -0,0 +1,496 @@
+/** @file
+ * Implementacja interfejsu server.h
+ *
+ * Watek glowny przyjmuje polaczenia i przekazuje je po kolei watkom
+ * obslugujacym przez ich kolejki. Od tej chwili polaczenie i jego gra
+ * naleza wylacznie do jednego watku obslugujacego.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#include "server.h"
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "batch_mode.h"
+#include "parser.h"
+
+#define SERVER_BACKLOG 128 ///< dlugosc kolejki oczekujacych polaczen
+#define SERVER_MAX_EVENTS 64 ///< ile zdarzen odbiera jedno wywolanie epoll_wait
+#define SERVER_READ_CHUNK 65536 ///< ile bajtow czytane jest naraz z polaczenia
+#define SERVER_MAX_LINE (1u << 20) /**< maksymalna dlugosc linii, dluzsza
+                                     * linia powoduje zamkniecie polaczenia **/
+#define SERVER_MAX_PENDING_OUTPUT (8u << 20) /**< ile bajtow odpowiedzi moze
+                                               * czekac na wyslanie, zanim
+                                               * serwer przestanie czytac
+                                               * kolejne komendy **/
+
+/** @struct connection
+ * @brief Struktura przechowujaca stan jednego polaczenia.
+ */
+typedef struct connection {
+    int fd; ///< deskryptor gniazda polaczenia
+    gamma_t *game; ///< gra polaczenia lub NULL, jesli jeszcze jej nie utworzono
+    uint32_t line_count; ///< liczba odczytanych linii
+    char *in; ///< bufor danych odczytanych, ale jeszcze nie zinterpretowanych
+    size_t in_len; ///< liczba bajtow w buforze @p in
+    size_t in_cap; ///< rozmiar bufora @p in
+    char *out; ///< bufor odpowiedzi czekajacych na wyslanie
+    size_t out_len; ///< liczba bajtow w buforze @p out
+    size_t out_off; ///< liczba juz wyslanych bajtow z bufora @p out
+    uint32_t events; ///< zdarzenia, na ktore polaczenie jest zarejestrowane
+    bool closing; ///< czy klient zakonczyl wysylanie danych
+    struct connection *prev; ///< poprzednie polaczenie watku
+    struct connection *next; ///< nastepne polaczenie watku
+} connection_t;
+
+/** @struct worker
+ * @brief Struktura przechowujaca stan watku obslugujacego polaczenia.
+ */
+typedef struct worker {
+    pthread_t thread; ///< watek
+    int epfd; ///< deskryptor petli epoll watku
+    int wake_fd; ///< eventfd budzacy watek
+    pthread_mutex_t lock; ///< blokada chroniaca kolejke @p incoming
+    connection_t *incoming; ///< polaczenia przekazane, ale nie zarejestrowane
+    connection_t *connections; ///< polaczenia obslugiwane przez watek
+    atomic_bool stop; ///< czy watek ma sie zakonczyc
+} worker_t;
+
+/** Limit pamieci jednej gry w bajtach, ustawiany przed uruchomieniem
+ * watkow i pozniej tylko czytany. */
+static uint64_t server_game_budget = UINT64_MAX;
+
+/** Czy serwer otrzymal sygnal zakonczenia. */
+static volatile sig_atomic_t server_stopping = 0;
+
+/** @brief Obsluga sygnalow SIGINT i SIGTERM.
+ * @param[in] sig - numer sygnalu.
+ */
+static void handle_stop_signal(int sig) {
+    (void) sig;
+    server_stopping = 1;
+}
+
+/** @brief Zwalnia polaczenie razem z jego gra i zamyka gniazdo.
+ * @param[in,out] w - watek, do ktorego nalezy polaczenie,
+ * @param[in] c - zwalniane polaczenie.
+ */
+static void connection_close(worker_t *w, connection_t *c) {
+    if(c->prev != NULL) c->prev->next = c->next;
+    else w->connections = c->next;
+    if(c->next != NULL) c->next->prev = c->prev;
+    gamma_delete(c->game);
+    close(c->fd);
+    free(c->in);
+    free(c->out);
+    free(c);
+}
+
+/** @brief Dopisuje dane do bufora odpowiedzi polaczenia.
+ * @param[in,out] c - polaczenie,
+ * @param[in] data - dopisywane dane,
+ * @param[in] size - liczba bajtow.
+ * @return @p true, jesli udalo sie zaalokowac pamiec, @p false w przeciwnym
+ * przypadku.
+ */
+static bool connection_queue_output(connection_t *c, const char *data,
+                                    size_t size) {
+    if(c->out_off > 0 && c->out_off == c->out_len) {
+        c->out_off = c->out_len = 0;
+    }
+    if(size == 0) return true;
+    char *out = realloc(c->out, c->out_len + size);
+    if(out == NULL) return false;
+    c->out = out;
+    memcpy(c->out + c->out_len, data, size);
+    c->out_len += size;
+    return true;
+}
+
+/** @brief Tworzy lub wznawia gre o numerze zapisywana w dzienniku.
+ * Dziennik gry lezy w katalogu ze zmiennej srodowiskowej GAMMA_LOG_DIR,
+ * wiec gra przetrwa zamkniecie polaczenia i ponowne uruchomienie serwera.
+ * Dziennik jest blokowany, wiec z jedna gra laczy sie naraz jedno
+ * polaczenie.
+ * @param[in] id - numer gry,
+ * @param[in] params - szerokosc, wysokosc, liczba graczy i limit obszarow.
+ * @return Wskaznik na gre lub NULL, jesli zmienna nie jest ustawiona,
+ * gra przekroczylaby limit pamieci lub nie udalo sie jej utworzyc.
+ */
+static gamma_t* server_resume_game(uint32_t id, const uint32_t *params) {
+    gamma_memory_stats_t stats;
+    gamma_memory_estimate(params[0], params[1], params[2], &stats);
+    char *log_path;
+    if(stats.total > server_game_budget || !batch_mode_game_log_path(id, &log_path)
+       || log_path == NULL) {
+        return NULL;
+    }
+    gamma_t *g = batch_mode_new_game(log_path, params[0], params[1],
+                                     params[2], params[3]);
+    free(log_path);
+    return g;
+}
+
+/** @brief Interpretuje jedna linie polaczenia.
+ * @param[in,out] c - polaczenie,
+ * @param[in,out] line - linia zakonczona znakiem nowej linii i znakiem '\0',
+ * @param[in,out] parsed_command - tablica na zinterpretowana komende,
+ * @param[in,out] out - strumien, do ktorego wypisywana jest odpowiedz.
+ */
+static void connection_handle_line(connection_t *c, char *line,
+                                   uint32_t *parsed_command, FILE *out) {
+    c->line_count++;
+    if(c->game == NULL) {
+        if(line[0] == 'n') {
+            process_line_session_mode(line, parsed_command);
+        }
+        else {
+            process_line(line, parsed_command);
+        }
+        if(parsed_command[0] == BATCH_MODE) {
+            c->game = gamma_new_with_budget(parsed_command[1], parsed_command[2],
+                                            parsed_command[3], parsed_command[4],
+                                            server_game_budget);
+            fprintf(out, c->game == NULL ? "ERROR %u\n" : "OK %u\n",
+                    c->line_count);
+        }
+        else if(parsed_command[0] == GAMMA_NEW) {
+            c->game = server_resume_game(parsed_command[1], parsed_command + 2);
+            fprintf(out, c->game == NULL ? "ERROR %u\n" : "OK %u\n",
+                    c->line_count);
+        }
+        else if(parsed_command[0] != COMMENT && parsed_command[0] != EMPTY_LINE) {
+            fprintf(out, "ERROR %u\n", c->line_count);
+        }
+    }
+    else {
+        process_line_batch_mode(line, parsed_command);
+        batch_mode_execute(c->game, parsed_command[0], parsed_command + 1,
+                           c->line_count, out, out, NULL);
+    }
+}
+
+/** @brief Interpretuje wszystkie pelne linie z bufora wejsciowego.
+ * Jesli klient zakonczyl wysylanie, interpretuje rowniez niepelna
+ * ostatnia linie, tak jak robi to tryb wsadowy.
+ * @param[in,out] c - polaczenie.
+ * @return @p true, jesli udalo sie zapisac odpowiedzi, @p false w przeciwnym
+ * przypadku.
+ */
+static bool connection_process_input(connection_t *c) {
+    uint32_t parsed_command[MAX_NUMBER_OF_SESSION_COMMANDS];
+    char *response = NULL;
+    size_t response_len = 0;
+    FILE *out = open_memstream(&response, &response_len);
+    if(out == NULL) return false;
+
+    size_t start = 0;
+    while(start < c->in_len
+          && c->out_len - c->out_off + response_len < SERVER_MAX_PENDING_OUTPUT) {
+        char *newline = memchr(c->in + start, '\n', c->in_len - start);
+        if(newline == NULL && !c->closing) break;
+        size_t end = (newline == NULL) ? c->in_len
+                                       : (size_t) (newline - c->in) + 1;
+        char saved = c->in[end];
+        c->in[end] = '\0';
+        connection_handle_line(c, c->in + start, parsed_command, out);
+        c->in[end] = saved;
+        start = end;
+        fflush(out);
+    }
+    memmove(c->in, c->in + start, c->in_len - start);
+    c->in_len -= start;
+
+    fclose(out);
+    bool queued = connection_queue_output(c, response, response_len);
+    free(response);
+    return queued;
+}
+
+/** @brief Wysyla tyle odpowiedzi, ile przyjmie gniazdo.
+ * @param[in,out] c - polaczenie.
+ * @return @p false, jesli polaczenie zostalo zerwane, @p true w przeciwnym
+ * przypadku.
+ */
+static bool connection_flush(connection_t *c) {
+    while(c->out_off < c->out_len) {
+        ssize_t sent = send(c->fd, c->out + c->out_off, c->out_len - c->out_off,
+                            MSG_NOSIGNAL);
+        if(sent < 0) {
+            if(errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        c->out_off += (size_t) sent;
+    }
+    return true;
+}
+
+/** @brief Czyta dostepne dane z gniazda polaczenia.
+ * @param[in,out] c - polaczenie.
+ * @return @p false, jesli polaczenie zostalo zerwane lub linia jest za dluga,
+ * @p true w przeciwnym przypadku.
+ */
+static bool connection_read(connection_t *c) {
+    while(!c->closing) {
+        if(c->in_cap - c->in_len < SERVER_READ_CHUNK + 1) {
+            if(c->in_len > SERVER_MAX_LINE) return false;
+            char *in = realloc(c->in, c->in_len + SERVER_READ_CHUNK + 1);
+            if(in == NULL) return false;
+            c->in = in;
+            c->in_cap = c->in_len + SERVER_READ_CHUNK + 1;
+        }
+        ssize_t r = read(c->fd, c->in + c->in_len, SERVER_READ_CHUNK);
+        if(r < 0) {
+            if(errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        if(r == 0) {
+            c->closing = true;
+        }
+        c->in_len += (size_t) r;
+        /* Odpowiedzi przestaja byc generowane, gdy klient ich nie odbiera. */
+        if(c->out_len - c->out_off >= SERVER_MAX_PENDING_OUTPUT) break;
+        if(!connection_process_input(c)) return false;
+    }
+    return true;
+}
+
+/** @brief Obsluguje zdarzenie na polaczeniu.
+ * @param[in,out] w - watek, do ktorego nalezy polaczenie,
+ * @param[in,out] c - polaczenie,
+ * @param[in] events - zdarzenia zgloszone przez epoll.
+ */
+static void connection_on_event(worker_t *w, connection_t *c, uint32_t events) {
+    bool alive = true;
+    if(events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+        alive = connection_read(c);
+    }
+    if(alive) {
+        alive = connection_flush(c);
+    }
+    if(alive && c->out_off == c->out_len && c->in_len > 0) {
+        /* Bufor odpowiedzi sie oproznil, wiec mozna dokonczyc
+         * wstrzymana interpretacje komend. */
+        alive = connection_process_input(c) && connection_flush(c);
+    }
+    bool pending = c->out_off < c->out_len;
+    if(!alive || (c->closing && !pending && c->in_len == 0)) {
+        connection_close(w, c);
+        return;
+    }
+
+    uint32_t wanted = (pending ? EPOLLOUT : 0)
+                      | (c->closing || c->out_len - c->out_off
+                                       >= SERVER_MAX_PENDING_OUTPUT ? 0 : EPOLLIN);
+    if(wanted != c->events) {
+        struct epoll_event ev = { .events = wanted, .data.ptr = c };
+        epoll_ctl(w->epfd, EPOLL_CTL_MOD, c->fd, &ev);
+        c->events = wanted;
+    }
+}
+
+/** @brief Rejestruje polaczenia przekazane watkowi przez watek glowny.
+ * @param[in,out] w - watek.
+ */
+static void worker_adopt_connections(worker_t *w) {
+    uint64_t counter;
+    if(read(w->wake_fd, &counter, sizeof(counter)) < 0) {
+        /* Licznik byl juz wyzerowany, kolejka i tak zostanie sprawdzona. */
+    }
+    pthread_mutex_lock(&w->lock);
+    connection_t *c = w->incoming;
+    w->incoming = NULL;
+    pthread_mutex_unlock(&w->lock);
+
+    while(c != NULL) {
+        connection_t *next = c->next;
+        c->prev = NULL;
+        c->next = w->connections;
+        if(w->connections != NULL) w->connections->prev = c;
+        w->connections = c;
+        c->events = EPOLLIN;
+        struct epoll_event ev = { .events = EPOLLIN, .data.ptr = c };
+        if(epoll_ctl(w->epfd, EPOLL_CTL_ADD, c->fd, &ev) != 0) {
+            connection_close(w, c);
+        }
+        c = next;
+    }
+}
+
+/** @brief Petla zdarzen watku obslugujacego polaczenia.
+ * @param[in,out] arg - wskaznik na strukture watku.
+ * @return NULL.
+ */
+static void *worker_loop(void *arg) {
+    worker_t *w = arg;
+    struct epoll_event events[SERVER_MAX_EVENTS];
+
+    while(!atomic_load(&w->stop)) {
+        int n = epoll_wait(w->epfd, events, SERVER_MAX_EVENTS, -1);
+        if(n < 0 && errno != EINTR) break;
+        for(int i = 0; i < n; ++i) {
+            if(events[i].data.ptr == w) {
+                worker_adopt_connections(w);
+            }
+            else {
+                connection_on_event(w, events[i].data.ptr, events[i].events);
+            }
+        }
+    }
+
+    worker_adopt_connections(w);
+    while(w->connections != NULL) {
+        connection_close(w, w->connections);
+    }
+    return NULL;
+}
+
+/** @brief Przygotowuje watek obslugujacy polaczenia.
+ * @param[out] w - inicjowana struktura watku.
+ * @return @p true, jesli udalo sie utworzyc deskryptory, @p false w przeciwnym
+ * przypadku.
+ */
+static bool worker_init(worker_t *w) {
+    w->incoming = NULL;
+    w->connections = NULL;
+    atomic_init(&w->stop, false);
+    pthread_mutex_init(&w->lock, NULL);
+    w->epfd = epoll_create1(EPOLL_CLOEXEC);
+    w->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(w->epfd < 0 || w->wake_fd < 0) {
+        return false;
+    }
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = w };
+    return epoll_ctl(w->epfd, EPOLL_CTL_ADD, w->wake_fd, &ev) == 0;
+}
+
+/** @brief Zwalnia zasoby watku obslugujacego polaczenia.
+ * @param[in,out] w - struktura watku.
+ */
+static void worker_destroy(worker_t *w) {
+    if(w->epfd >= 0) close(w->epfd);
+    if(w->wake_fd >= 0) close(w->wake_fd);
+    pthread_mutex_destroy(&w->lock);
+}
+
+/** @brief Budzi watek obslugujacy polaczenia.
+ * @param[in,out] w - struktura watku.
+ */
+static void worker_wake(worker_t *w) {
+    uint64_t one = 1;
+    if(write(w->wake_fd, &one, sizeof(one)) < 0) {
+        /* Licznik eventfd jest juz niezerowy, watek i tak sie obudzi. */
+    }
+}
+
+/** @brief Przekazuje nowe polaczenie watkowi obslugujacemu.
+ * @param[in,out] w - struktura watku,
+ * @param[in] fd - deskryptor gniazda polaczenia.
+ */
+static void worker_hand_off(worker_t *w, int fd) {
+    connection_t *c = calloc(1, sizeof(connection_t));
+    if(c == NULL) {
+        close(fd);
+        return;
+    }
+    c->fd = fd;
+    pthread_mutex_lock(&w->lock);
+    c->next = w->incoming;
+    w->incoming = c;
+    pthread_mutex_unlock(&w->lock);
+    worker_wake(w);
+}
+
+/** @brief Tworzy gniazdo nasluchujace.
+ * @param[in] path - sciezka gniazda.
+ * @return deskryptor gniazda lub -1 w razie bledu.
+ */
+static int listen_on(const char *path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if(strlen(path) >= sizeof(addr.sun_path)) return -1;
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(fd < 0) return -1;
+    unlink(path);
+    if(bind(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0
+       || listen(fd, SERVER_BACKLOG) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool server_run(const char *path, uint32_t workers, uint64_t game_budget) {
+    if(workers == 0) return false;
+    server_game_budget = (game_budget == 0) ? UINT64_MAX : game_budget;
+    int listen_fd = listen_on(path);
+    if(listen_fd < 0) return false;
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_stop_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    /* Sygnaly zakonczenia sa obslugiwane tylko przez watek glowny,
+     * watki obslugujace dziedzicza zablokowana maske. */
+    sigset_t stop_signals, old_mask;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, &old_mask);
+
+    worker_t *pool = calloc(workers, sizeof(worker_t));
+    uint32_t started = 0;
+    bool ok = (pool != NULL);
+    for(; ok && started < workers; ++started) {
+        if(!worker_init(&pool[started])
+           || pthread_create(&pool[started].thread, NULL, worker_loop,
+                             &pool[started]) != 0) {
+            worker_destroy(&pool[started]);
+            ok = false;
+            break;
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+
+    uint32_t next_worker = 0;
+    while(ok && !server_stopping) {
+        int fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if(fd < 0) {
+            if(errno == EINTR || errno == ECONNABORTED || errno == EMFILE
+               || errno == ENFILE) continue;
+            ok = false;
+            break;
+        }
+        worker_hand_off(&pool[next_worker], fd);
+        next_worker = (next_worker + 1) % workers;
+    }
+
+    for(uint32_t i = 0; i < started; ++i) {
+        atomic_store(&pool[i].stop, true);
+        worker_wake(&pool[i]);
+    }
+    for(uint32_t i = 0; i < started; ++i) {
+        pthread_join(pool[i].thread, NULL);
+        worker_destroy(&pool[i]);
+    }
+    free(pool);
+    close(listen_fd);
+    unlink(path);
+    return ok || server_stopping;
+}
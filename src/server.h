@@ -0,0 +1,40 @@
+/** @file
+ * Interfejs serwera gry gamma dzialajacego na gniezdzie uniksowym
+ *
+ * Kazde polaczenie obsluguje jedna gre. Pierwsza niepusta linia polaczenia
+ * musi byc komenda @p B tworzaca gre albo, jesli ustawiona jest zmienna
+ * srodowiskowa GAMMA_LOG_DIR, komenda @p n @p id @p w @p h @p p @p a
+ * tworzaca lub wznawiajaca gre zapisywana w dzienniku @p id.log w tym
+ * katalogu. Kolejne linie sa komendami
+ * trybu wsadowego (@p m, @p g, @p b, @p f, @p q, @p p, @p d). Odpowiedzi,
+ * rowniez komunikaty ERROR, sa odsylane tym samym polaczeniem.
+ * Polaczenia sa rozdzielane pomiedzy stala pule watkow, z ktorych kazdy
+ * ma wlasna petle epoll, wiec gra jest zawsze obslugiwana przez jeden
+ * watek i nie wymaga blokad.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#ifndef SERVER_H
+#define SERVER_H
+#define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/** @brief Uruchamia serwer.
+ * Nasluchuje na gniezdzie uniksowym @p path az do otrzymania sygnalu
+ * SIGINT lub SIGTERM, po czym zamyka wszystkie polaczenia, usuwa ich gry
+ * i usuwa plik gniazda.
+ * @param[in] path - sciezka gniazda,
+ * @param[in] workers - liczba watkow obslugujacych polaczenia, liczba dodatnia,
+ * @param[in] game_budget - maksymalna liczba bajtow jednej gry, komenda
+ * @p B tworzaca wieksza gre konczy sie bledem; 0 oznacza brak limitu.
+ * @return Wartosc @p true, jesli serwer zakonczyl sie poprawnie,
+ * @p false jesli nie udalo sie go uruchomic.
+ */
+bool server_run(const char *path, uint32_t workers, uint64_t game_budget);
+
+#endif //SERVER_H
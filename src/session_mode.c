@@ -0,0 +1,83 @@
+/** @file
+ * Implementacja interfejsu session_mode.h
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#include "session_mode.h"
+#include <unistd.h>
+
+/** @brief Wykonuje jedna komende trybu wielu gier.
+ * @param[in,out] games - tablica gier,
+ * @param[in] parsed_command - zinterpretowana komenda,
+ * @param[in] line_count - numer linii, z ktorej pochodzi komenda.
+ */
+static void session_mode_execute(game_table_t *games, uint32_t *parsed_command,
+                                 uint32_t line_count) {
+    uint32_t command = parsed_command[0];
+    uint32_t id = parsed_command[1];
+
+    if(command == GAMMA_NEW) {
+        bool created = false;
+        char *log_path;
+        if(game_table_find(games, id) == NULL
+           && batch_mode_game_log_path(id, &log_path)) {
+            gamma_t *g = batch_mode_new_game(log_path, parsed_command[2],
+                                             parsed_command[3], parsed_command[4],
+                                             parsed_command[5]);
+            created = (g != NULL && game_table_insert(games, id, g));
+            if(g != NULL && !created) {
+                gamma_delete(g);
+            }
+            free(log_path);
+        }
+        printf("%d\n", created);
+    }
+    else if(command == GAMMA_DELETE) {
+        bool removed = game_table_remove(games, id);
+        char *log_path;
+        if(removed && batch_mode_game_log_path(id, &log_path) && log_path != NULL) {
+            unlink(log_path);
+            free(log_path);
+        }
+        printf("%d\n", removed);
+    }
+    else if(command == COMMENT || command == EMPTY_LINE) {
+        return;
+    }
+    else if(command == INCORRECT_COMMAND) {
+        fprintf(stderr,"ERROR %u\n", line_count);
+    }
+    else {
+        gamma_t *board = game_table_find(games, id);
+        if(board == NULL) {
+            fprintf(stderr,"ERROR %u\n", line_count);
+        }
+        else {
+            batch_mode_execute(board, command, parsed_command + 2, line_count,
+                               stdout, stderr, NULL);
+        }
+    }
+}
+
+void session_mode_start(uint32_t *parsed_command, uint32_t line_count) {
+    char *line = NULL;
+    size_t sizeOfLine = 1;
+    game_table_t *games;
+
+    if(!game_table_init(&games)) {
+        fprintf(stderr,"ERROR %u\n", line_count);
+        return;
+    }
+
+    while(getline(&line, &sizeOfLine, stdin) != EOF) {
+        line_count++;
+        process_line_session_mode(line, parsed_command);
+        session_mode_execute(games, parsed_command, line_count);
+    }
+
+    free(line);
+    delete_game_table(games);
+}
@@ -0,0 +1,32 @@
+/** @file
+ * Interfejs klasy odpowiedzialnej za tryb wielu gier
+ *
+ * W trybie wielu gier jeden proces obsluguje dowolnie wiele gier naraz.
+ * Kazda komenda trybu wsadowego zawiera jako drugie slowo numer gry
+ * (np. @p d @p id wypisuje zmienione pola, a @p p @p id @p x0 @p y0
+ * @p x1 @p y1 fragment planszy), a komendy @p n i @p r tworza i usuwaja gry. Jesli ustawiona jest zmienna
+ * srodowiskowa GAMMA_LOG_DIR, ruchy kazdej gry sa zapisywane w dzienniku
+ * w tym katalogu; komenda @p n wznawia gre z jej dziennika, a usuniecie
+ * gry usuwa rowniez dziennik.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#ifndef SESSION_MODE_H
+#define SESSION_MODE_H
+#include "batch_mode.h"
+#include <stdint.h>
+#include <stdio.h>
+#include "game_table.h"
+
+/** @brief Uruchamia tryb wielu gier.
+ * Uruchamia tryb wielu gier. Po zakonczeniu wejscia usuwa wszystkie
+ * pozostale gry.
+ * @param[in,out] parsed_command - tablica o rozmiarze co najmniej
+ * @ref MAX_NUMBER_OF_SESSION_COMMANDS uzywana do zczytywania linii,
+ * @param[in] line_count - wartosc mowiaca ile linii tekstu zostalo zczytane.
+ */
+void session_mode_start(uint32_t *parsed_command, uint32_t line_count);
+#endif //SESSION_MODE_H
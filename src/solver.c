@@ -0,0 +1,490 @@
+/** @file
+ * Implementacja interfejsu solver.h
+ *
+ * Kluczem pozycji jest kanoniczny skrot gry, wiec pozycje symetryczne
+ * dziela wpis tablicy transpozycji; najlepszy ruch jest zapisywany we
+ * wspolrzednych pozycji kanonicznej.
+ *
+ * Wpis tablicy transpozycji sklada sie z dwoch slow: danych i klucza
+ * xor danych. Slowa sa zapisywane i czytane niezaleznie, bez blokad;
+ * wpis, ktorego slowa pochodza z dwoch roznych zapisow, nie zgadza sie
+ * z kluczem i jest traktowany jak brak wpisu.
+ *
+ * Kopie pozycji na kolejnych poziomach przeszukiwania sa przechowywane
+ * w stosie gier, wiec ruch nie wymaga cofania.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "solver.h"
+
+#define SOLVER_INFINITY ((int64_t) 1 << 40) ///< wartosc wieksza od kazdego wyniku
+#define SOLVER_MAX_DEPTH 8191 ///< najwieksza glebokosc zapisywana w tablicy
+#define SOLVER_TIME_CHECK_NODES 1024 /**< co ile pozycji sprawdzany jest
+                                       * limit czasu **/
+
+#define BOUND_EXACT 1 ///< wynik wpisu jest dokladny
+#define BOUND_LOWER 2 ///< wynik wpisu jest ograniczeniem dolnym
+#define BOUND_UPPER 3 ///< wynik wpisu jest ograniczeniem gornym
+
+#define ENTRY_BOUND(data) ((uint32_t) ((data) & 3)) ///< rodzaj ograniczenia wpisu
+#define ENTRY_COMPLETE(data) ((bool) (((data) >> 2) & 1)) /**< czy wynik wpisu
+                                                 * nie zalezy od glebokosci **/
+#define ENTRY_DEPTH(data) ((uint32_t) (((data) >> 3) & 0x1FFF)) ///< glebokosc wpisu
+#define ENTRY_MOVE(data) ((uint32_t) (((data) >> 16) & 0xFFFFFF)) ///< ruch wpisu
+#define ENTRY_VALUE(data) ((int64_t) ((data) >> 40) - ((int64_t) 1 << 23)) ///< wynik wpisu
+
+/** @struct tt_entry
+ * @brief Wpis tablicy transpozycji.
+ */
+typedef struct tt_entry {
+    uint64_t check; ///< klucz pozycji xor @p data
+    uint64_t data; ///< spakowany wynik, glebokosc i najlepszy ruch
+} tt_entry_t;
+
+/** @struct solver
+ * @brief Struktura przechowujaca stan solvera.
+ */
+struct solver {
+    tt_entry_t *table; ///< tablica transpozycji
+    uint64_t mask; ///< ilosc wpisow tablicy pomniejszona o jeden
+    gamma_t **stack; ///< kopie pozycji na kolejnych poziomach przeszukiwania
+    uint32_t stack_size; ///< ilosc utworzonych kopii
+    uint32_t width; ///< szerokosc planszy
+    uint32_t height; ///< wysokosc planszy
+    uint32_t players; ///< ilosc graczy
+    uint32_t player; ///< gracz, dla ktorego liczony jest wynik
+    uint64_t seed; ///< ziarno skrotow zalezne od parametrow gry
+    uint64_t nodes; ///< ilosc odwiedzonych pozycji
+    int64_t deadline; ///< czas konca przeszukiwania w milisekundach lub -1
+    bool aborted; ///< czy przeszukiwanie przerwano z powodu limitu czasu
+};
+
+/** @brief Miesza liczbe 64-bitowa (splitmix64).
+ * @param[in] x - mieszana liczba.
+ * @return skrot liczby.
+ */
+static uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15u;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9u;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBu;
+    return x ^ (x >> 31);
+}
+
+/** @brief Podaje czas zegara monotonicznego w milisekundach.
+ * @return czas w milisekundach.
+ */
+static int64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+bool solver_init(solver_t **s, uint32_t table_bits) {
+    if(table_bits == 0 || table_bits > 40) return false;
+    *s = calloc(1, sizeof(solver_t));
+    if(*s == NULL) return false;
+    (*s)->mask = ((uint64_t) 1 << table_bits) - 1;
+    (*s)->table = calloc((*s)->mask + 1, sizeof(tt_entry_t));
+    if((*s)->table == NULL) {
+        free(*s);
+        *s = NULL;
+        return false;
+    }
+    return true;
+}
+
+/** @brief Usuwa kopie pozycji.
+ * @param[in,out] s - wskaznik na solver.
+ */
+static void clear_stack(solver_t *s) {
+    for(uint32_t i = 0; i < s->stack_size; ++i) {
+        gamma_delete(s->stack[i]);
+    }
+    free(s->stack);
+    s->stack = NULL;
+    s->stack_size = 0;
+}
+
+void delete_solver(solver_t *s) {
+    if(s != NULL) {
+        clear_stack(s);
+        free(s->table);
+        free(s);
+    }
+}
+
+/** @brief Zapewnia istnienie kopii pozycji na poziomie @p ply.
+ * @param[in,out] s - wskaznik na solver,
+ * @param[in] root - gra, ktorej parametry maja kopie,
+ * @param[in] ply - poziom przeszukiwania.
+ * @return Wartosc @p true, jesli kopia istnieje, @p false jesli nie udalo
+ * sie zaalokowac pamieci.
+ */
+static bool ensure_ply(solver_t *s, gamma_t *root, uint32_t ply) {
+    while(s->stack_size <= ply) {
+        gamma_t **stack = realloc(s->stack, sizeof(gamma_t *) * (s->stack_size + 1));
+        if(stack == NULL) return false;
+        s->stack = stack;
+        s->stack[s->stack_size] = gamma_clone(root);
+        if(s->stack[s->stack_size] == NULL) return false;
+        s->stack_size++;
+    }
+    return true;
+}
+
+/** @brief Czyta wpis tablicy transpozycji.
+ * @param[in] s - wskaznik na solver,
+ * @param[in] key - klucz pozycji,
+ * @param[out] data - dane wpisu.
+ * @return Wartosc @p true, jesli tablica zawiera wpis pozycji.
+ */
+static bool tt_probe(solver_t *s, uint64_t key, uint64_t *data) {
+    tt_entry_t *e = &s->table[key & s->mask];
+    uint64_t check = __atomic_load_n(&e->check, __ATOMIC_RELAXED);
+    *data = __atomic_load_n(&e->data, __ATOMIC_RELAXED);
+    return (check ^ *data) == key && *data != 0;
+}
+
+/** @brief Zapisuje wpis tablicy transpozycji, zastepujac poprzedni.
+ * @param[in,out] s - wskaznik na solver,
+ * @param[in] key - klucz pozycji,
+ * @param[in] bound - rodzaj ograniczenia,
+ * @param[in] complete - czy wynik nie zalezy od glebokosci,
+ * @param[in] depth - glebokosc przeszukiwania,
+ * @param[in] move - zakodowany najlepszy ruch lub 0,
+ * @param[in] value - wynik.
+ */
+static void tt_store(solver_t *s, uint64_t key, uint32_t bound, bool complete,
+                     uint32_t depth, uint32_t move, int64_t value) {
+    if(depth > SOLVER_MAX_DEPTH) depth = SOLVER_MAX_DEPTH;
+    uint64_t data = (uint64_t) bound | ((uint64_t) complete << 2)
+                    | ((uint64_t) depth << 3) | ((uint64_t) move << 16)
+                    | ((uint64_t) (value + ((int64_t) 1 << 23)) << 40);
+    tt_entry_t *e = &s->table[key & s->mask];
+    __atomic_store_n(&e->check, key ^ data, __ATOMIC_RELAXED);
+    __atomic_store_n(&e->data, data, __ATOMIC_RELAXED);
+}
+
+/** @brief Ocenia pozycje z punktu widzenia gracza solvera.
+ * @param[in] s - wskaznik na solver,
+ * @param[in] g - oceniana pozycja.
+ * @return liczba pol gracza pomniejszona o najwieksza liczbe pol przeciwnika.
+ */
+static int64_t evaluate(solver_t *s, gamma_t *g) {
+    int64_t best_other = 0;
+    for(uint32_t p = 1; p <= s->players; ++p) {
+        int64_t fields = (int64_t) gamma_busy_fields(g, p);
+        if(p != s->player && fields > best_other) best_other = fields;
+    }
+    return (int64_t) gamma_busy_fields(g, s->player) - best_other;
+}
+
+/** @brief Sprawdza, czy gracz ma jakis legalny ruch lub zloty ruch.
+ * @param[in,out] s - wskaznik na solver,
+ * @param[in] g - pozycja,
+ * @param[in,out] scratch - gra pomocnicza, w ktorej probowane sa zlote ruchy,
+ * @param[in] player - numer gracza.
+ * @return Wartosc @p true, jesli gracz ma ruch.
+ */
+static bool has_move(solver_t *s, gamma_t *g, gamma_t *scratch, uint32_t player) {
+    if(gamma_free_fields(g, player) > 0) return true;
+    if(!gamma_golden_possible(g, player)) return false;
+    gamma_copy(scratch, g);
+    for(uint32_t x = 0; x < s->width; ++x) {
+        for(uint32_t y = 0; y < s->height; ++y) {
+            uint32_t owner = gamma_field_owner(g, x, y);
+            if(owner != 0 && owner != player && gamma_golden_move(scratch, player, x, y)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/** @brief Sprawdza, czy pole sasiaduje z polem gracza.
+ * @param[in] s - wskaznik na solver,
+ * @param[in] g - pozycja,
+ * @param[in] player - numer gracza,
+ * @param[in] x - numer kolumny,
+ * @param[in] y - numer wiersza.
+ * @return Wartosc @p true, jesli ktores z sasiednich pol nalezy do gracza.
+ */
+static bool touches_player(solver_t *s, gamma_t *g, uint32_t player,
+                           uint32_t x, uint32_t y) {
+    return (x > 0 && gamma_field_owner(g, x - 1, y) == player)
+           || (x + 1 < s->width && gamma_field_owner(g, x + 1, y) == player)
+           || (y > 0 && gamma_field_owner(g, x, y - 1) == player)
+           || (y + 1 < s->height && gamma_field_owner(g, x, y + 1) == player);
+}
+
+/** @brief Przeksztalca zakodowany ruch.
+ * @param[in] s - wskaznik na solver,
+ * @param[in] g - pozycja,
+ * @param[in] transform - numer przeksztalcenia planszy,
+ * @param[in] move - zakodowany ruch lub 0.
+ * @return zakodowany obraz ruchu lub 0, jesli @p move jest rowny 0.
+ */
+static uint32_t move_transform(solver_t *s, gamma_t *g, uint32_t transform,
+                               uint32_t move) {
+    if(move == 0) return 0;
+    uint64_t cell = (move - 1) / 2;
+    uint32_t x, y;
+    gamma_transform_field(g, transform, (uint32_t) (cell / s->height),
+                          (uint32_t) (cell % s->height), &x, &y);
+    return (uint32_t) (((uint64_t) x * s->height + y) * 2 + (move - 1) % 2 + 1);
+}
+
+/** @brief Przeszukuje pozycje algorytmem alfa-beta.
+ * Ruchy sa sprawdzane w kolejnosci: najlepszy ruch z tablicy transpozycji,
+ * ruchy na pola sasiadujace z polami gracza, pozostale ruchy, zlote ruchy.
+ * @param[in,out] s - wskaznik na solver,
+ * @param[in] ply - poziom przeszukiwania, pozycja lezy w @p stack[ply],
+ * @param[in] to_move - gracz, ktorego kolej, przed pominieciem graczy
+ * bez ruchu,
+ * @param[in] depth - pozostala glebokosc,
+ * @param[in] alpha - dolna granica okna,
+ * @param[in] beta - gorna granica okna,
+ * @param[out] complete - czy wynik nie zalezy od glebokosci,
+ * @param[out] best_move - zakodowany najlepszy ruch lub 0, jesli gra sie
+ * skonczyla,
+ * @param[out] mover - gracz wykonujacy ruch lub 0, jesli gra sie skonczyla.
+ * @return wynik pozycji lub ograniczenie wyniku, jesli wypada poza okno;
+ * 0, jesli przeszukiwanie przerwano.
+ */
+static int64_t search(solver_t *s, uint32_t ply, uint32_t to_move,
+                      uint32_t depth, int64_t alpha, int64_t beta,
+                      bool *complete, uint32_t *best_move, uint32_t *mover) {
+    gamma_t *g = s->stack[ply];
+    *best_move = 0;
+    *mover = 0;
+    if(++s->nodes % SOLVER_TIME_CHECK_NODES == 0 && s->deadline >= 0
+       && now_ms() >= s->deadline) {
+        s->aborted = true;
+    }
+    if(s->aborted || !ensure_ply(s, g, ply + 1)) {
+        s->aborted = true;
+        return 0;
+    }
+    gamma_t *child = s->stack[ply + 1];
+
+    uint32_t m = 0;
+    for(uint32_t i = 0; i < s->players && m == 0; ++i) {
+        uint32_t p = (to_move - 1 + i) % s->players + 1;
+        if(has_move(s, g, child, p)) m = p;
+    }
+    *complete = true;
+    if(m == 0) {
+        return evaluate(s, g);
+    }
+    *mover = m;
+    if(depth == 0) {
+        *complete = false;
+        return evaluate(s, g);
+    }
+
+    uint32_t transform;
+    uint64_t key = gamma_canonical_hash(g, m, &transform) ^ s->seed;
+    uint64_t data;
+    uint32_t tt_move = 0;
+    if(tt_probe(s, key, &data)) {
+        tt_move = move_transform(s, g, gamma_inverse_transform(transform),
+                                 ENTRY_MOVE(data));
+        if(ENTRY_COMPLETE(data) || ENTRY_DEPTH(data) >= depth) {
+            int64_t value = ENTRY_VALUE(data);
+            uint32_t bound = ENTRY_BOUND(data);
+            if(bound == BOUND_EXACT || (bound == BOUND_LOWER && value >= beta)
+               || (bound == BOUND_UPPER && value <= alpha)) {
+                *complete = ENTRY_COMPLETE(data);
+                *best_move = tt_move;
+                return value;
+            }
+        }
+    }
+
+    bool maximizing = (m == s->player);
+    int64_t alpha_start = alpha, beta_start = beta;
+    int64_t best = maximizing ? -SOLVER_INFINITY : SOLVER_INFINITY;
+    bool golden_possible = gamma_golden_possible(g, m);
+    bool fresh = false;
+    uint64_t cells = (uint64_t) s->width * s->height;
+    uint32_t next = m % s->players + 1;
+
+    for(uint32_t phase = 0; phase < 4 && alpha < beta; ++phase) {
+        uint64_t begin = 0, end = cells;
+        if(phase == 0) {
+            if(tt_move == 0) continue;
+            begin = (tt_move - 1) / 2;
+            end = begin + 1;
+        }
+        for(uint64_t cell = begin; cell < end && alpha < beta; ++cell) {
+            uint32_t x = (uint32_t) (cell / s->height);
+            uint32_t y = (uint32_t) (cell % s->height);
+            uint32_t owner = gamma_field_owner(g, x, y);
+            bool golden;
+            if(phase == 0) {
+                golden = ((tt_move - 1) % 2 == 1);
+            }
+            else if(phase == 3) {
+                if(!golden_possible || owner == 0 || owner == m) continue;
+                golden = true;
+            }
+            else {
+                if(owner != 0 || touches_player(s, g, m, x, y) != (phase == 1)) continue;
+                golden = false;
+            }
+            uint32_t move = (uint32_t) (cell * 2 + golden + 1);
+            if(phase != 0 && move == tt_move) continue;
+
+            if(!fresh) gamma_copy(child, g);
+            fresh = true;
+            bool moved = golden ? gamma_golden_move(child, m, x, y)
+                                : gamma_move(child, m, x, y);
+            if(!moved) continue;
+            fresh = false;
+
+            bool child_complete;
+            uint32_t child_move, child_mover;
+            int64_t value = search(s, ply + 1, next, depth - 1, alpha, beta,
+                                   &child_complete, &child_move, &child_mover);
+            if(s->aborted) return 0;
+            *complete &= child_complete;
+            if(maximizing ? value > best : value < best) {
+                best = value;
+                *best_move = move;
+            }
+            if(maximizing && value > alpha) alpha = value;
+            if(!maximizing && value < beta) beta = value;
+        }
+    }
+
+    uint32_t bound = BOUND_EXACT;
+    if(best <= alpha_start) bound = BOUND_UPPER;
+    else if(best >= beta_start) bound = BOUND_LOWER;
+    tt_store(s, key, bound, *complete, depth,
+             move_transform(s, g, transform, *best_move), best);
+    return best;
+}
+
+/** @brief Przygotowuje solver do przeszukiwania gry @p g.
+ * Kopie pozycji sa tworzone od nowa, jesli parametry gry sie zmienily.
+ * Ziarno skrotow zalezy od parametrow gry i od gracza, dla ktorego
+ * liczony jest wynik, wiec wpisy innych przeszukiwan nie sa uzywane.
+ * @param[in,out] s - wskaznik na solver,
+ * @param[in] g - przeszukiwana gra,
+ * @param[in] player - numer gracza, dla ktorego liczony jest wynik.
+ * @return Wartosc @p true, jesli udalo sie zaalokowac pamiec.
+ */
+static bool prepare(solver_t *s, gamma_t *g, uint32_t player) {
+    if(s->stack_size > 0 && (s->width != get_width(g) || s->height != get_height(g)
+                             || s->players != get_players(g)
+                             || get_areas(s->stack[0]) != get_areas(g))) {
+        clear_stack(s);
+    }
+    s->width = get_width(g);
+    s->height = get_height(g);
+    s->players = get_players(g);
+    s->player = player;
+    s->seed = mix(mix(mix(mix(s->width) ^ s->height) ^ s->players)
+                  ^ get_areas(g)) ^ player;
+    if(!ensure_ply(s, g, 0)) return false;
+    return gamma_copy(s->stack[0], g);
+}
+
+/** @brief Odtwarza optymalny przebieg gry i zapisuje koncowe liczby pol.
+ * Kazda kolejna pozycja jest przeszukiwana z pelnym oknem, wiec
+ * najlepszy ruch prowadzi do wyniku rownego dokladnemu wynikowi gry.
+ * @param[in,out] s - wskaznik na solver,
+ * @param[in] g - pozycja poczatkowa,
+ * @param[in] to_move - gracz, ktorego kolej,
+ * @param[out] fields - tablica liczb pol graczy.
+ * @return Wartosc @p true, jesli udalo sie zaalokowac pamiec.
+ */
+static bool replay_fields(solver_t *s, gamma_t *g, uint32_t to_move,
+                          uint64_t *fields) {
+    gamma_t *line = gamma_clone(g);
+    if(line == NULL) return false;
+    s->deadline = -1;
+    for(;;) {
+        gamma_copy(s->stack[0], line);
+        bool complete;
+        uint32_t move, mover;
+        search(s, 0, to_move, SOLVER_MAX_DEPTH, -SOLVER_INFINITY,
+               SOLVER_INFINITY, &complete, &move, &mover);
+        if(s->aborted) {
+            gamma_delete(line);
+            return false;
+        }
+        if(move == 0) break;
+        uint64_t cell = (move - 1) / 2;
+        uint32_t x = (uint32_t) (cell / s->height);
+        uint32_t y = (uint32_t) (cell % s->height);
+        if((move - 1) % 2 == 1) {
+            gamma_golden_move(line, mover, x, y);
+        }
+        else {
+            gamma_move(line, mover, x, y);
+        }
+        to_move = mover % s->players + 1;
+    }
+    for(uint32_t p = 1; p <= s->players; ++p) {
+        fields[p] = gamma_busy_fields(line, p);
+    }
+    gamma_delete(line);
+    return true;
+}
+
+bool solver_solve(solver_t *s, gamma_t *g, uint32_t to_move, uint32_t player,
+                  uint64_t time_limit_ms, solver_result_t *result,
+                  uint64_t *fields) {
+    if(s == NULL || g == NULL || result == NULL) return false;
+    uint32_t players = get_players(g);
+    if(to_move == 0 || to_move > players || player == 0 || player > players
+       || (uint64_t) get_width(g) * get_height(g) > SOLVER_MAX_CELLS) {
+        return false;
+    }
+    if(!prepare(s, g, player)) return false;
+
+    memset(result, 0, sizeof(solver_result_t));
+    int64_t start = now_ms();
+    s->nodes = 0;
+    s->aborted = false;
+    for(uint32_t depth = 1; depth <= SOLVER_MAX_DEPTH; ++depth) {
+        s->deadline = (depth == 1 || time_limit_ms == 0)
+                      ? -1 : start + (int64_t) time_limit_ms;
+        bool complete;
+        uint32_t move, mover;
+        int64_t value = search(s, 0, to_move, depth, -SOLVER_INFINITY,
+                               SOLVER_INFINITY, &complete, &move, &mover);
+        if(s->aborted) {
+            if(depth == 1) return false;
+            break;
+        }
+        result->value = value;
+        result->depth = depth;
+        result->exact = complete;
+        result->has_move = (mover != 0);
+        result->to_move = mover;
+        if(move != 0) {
+            uint64_t cell = (move - 1) / 2;
+            result->x = (uint32_t) (cell / s->height);
+            result->y = (uint32_t) (cell % s->height);
+            result->golden = ((move - 1) % 2 == 1);
+        }
+        if(complete) break;
+        if(s->deadline >= 0 && now_ms() >= s->deadline) break;
+    }
+    result->nodes = s->nodes;
+    s->aborted = false;
+
+    if(result->exact && fields != NULL) {
+        return replay_fields(s, g, to_move, fields);
+    }
+    return true;
+}
@@ -0,0 +1,92 @@
+/** @file
+ * Interfejs dokladnego rozwiazywania koncowek gry gamma
+ *
+ * Solver przeszukuje drzewo gry algorytmem alfa-beta z iteracyjnym
+ * poglebianiem, az do poznania dokladnego wyniku lub uplywu limitu czasu.
+ * Gracze wykonuja ruchy po kolei; gracz, ktory nie ma zadnego legalnego
+ * ruchu ani zlotego ruchu, jest pomijany, a gra konczy sie, gdy zaden
+ * gracz nie ma ruchu. Gracze nie pasuja dobrowolnie. Dla wiecej niz dwoch
+ * graczy przyjmowane jest zalozenie, ze wszyscy przeciwnicy wspolpracuja
+ * przeciwko graczowi, dla ktorego liczony jest wynik.
+ *
+ * Wynikiem pozycji jest liczba pol gracza pomniejszona o najwieksza
+ * liczbe pol przeciwnika. Pozycje sa zapamietywane w tablicy transpozycji
+ * o stalym rozmiarze, ktora moze byc czytana i zapisywana bez blokad.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "gamma.h"
+
+#define SOLVER_MAX_CELLS (1u << 20) ///< najwieksza ilosc pol rozwiazywanej planszy
+
+/**
+ * Struktura przechowujaca stan solvera i jego tablice transpozycji.
+ */
+typedef struct solver solver_t;
+
+/**
+ * Wynik przeszukiwania.
+ */
+typedef struct solver_result {
+    bool exact; /**< czy @p value jest dokladnym wynikiem gry przy
+                 * optymalnej grze wszystkich graczy **/
+    int64_t value; /**< wynik gracza z ostatniej ukonczonej iteracji,
+                    * dokladny, jesli @p exact **/
+    uint32_t depth; ///< glebokosc ostatniej ukonczonej iteracji
+    uint64_t nodes; ///< ilosc odwiedzonych pozycji
+    bool has_move; ///< czy gracz wykonujacy ruch ma jakis ruch
+    uint32_t to_move; /**< gracz, ktory faktycznie wykonuje ruch, po
+                       * pominieciu graczy bez ruchu **/
+    uint32_t x; ///< numer kolumny najlepszego ruchu
+    uint32_t y; ///< numer wiersza najlepszego ruchu
+    bool golden; ///< czy najlepszy ruch jest zlotym ruchem
+} solver_result_t;
+
+/** @brief Tworzy solver.
+ * @param[out] s - wskaznik, pod ktorym zapisywany jest solver,
+ * @param[in] table_bits - logarytm dwojkowy ilosci wpisow tablicy
+ * transpozycji, od 1 do 40; kazdy wpis zajmuje 16 bajtow.
+ * @return Wartosc @p true, jesli udalo sie utworzyc solver,
+ * @p false w przeciwnym przypadku.
+ */
+bool solver_init(solver_t **s, uint32_t table_bits);
+
+/** @brief Usuwa solver.
+ * Nic nie robi, jesli @p s ma wartosc NULL.
+ * @param[in] s - wskaznik na usuwany solver.
+ */
+void delete_solver(solver_t *s);
+
+/** @brief Rozwiazuje pozycje.
+ * Przeszukuje pozycje gry @p g z ruchem gracza @p to_move, z punktu
+ * widzenia gracza @p player, poglebiajac przeszukiwanie az do poznania
+ * dokladnego wyniku lub uplywu @p time_limit_ms milisekund. Pierwsza
+ * iteracja jest zawsze konczona. Gra @p g nie jest zmieniana.
+ * @param[in,out] s - wskaznik na solver,
+ * @param[in] g - wskaznik na gre, o nie wiecej niz @ref SOLVER_MAX_CELLS
+ * polach,
+ * @param[in] to_move - numer gracza, ktory wykonuje nastepny ruch,
+ * @param[in] player - numer gracza, dla ktorego liczony jest wynik,
+ * @param[in] time_limit_ms - limit czasu w milisekundach, 0 oznacza brak
+ * limitu,
+ * @param[out] result - wynik przeszukiwania,
+ * @param[out] fields - tablica o @p players + 1 elementach, w ktorej pod
+ * numerem gracza zapisywana jest liczba jego pol na koniec gry przy
+ * optymalnej grze, jesli wynik jest dokladny; moze byc NULL.
+ * @return Wartosc @p true, jesli udalo sie przeszukac pozycje,
+ * @p false jesli ktorys z parametrow jest niepoprawny lub nie udalo sie
+ * zaalokowac pamieci.
+ */
+bool solver_solve(solver_t *s, gamma_t *g, uint32_t to_move, uint32_t player,
+                  uint64_t time_limit_ms, solver_result_t *result,
+                  uint64_t *fields);
+
+#endif //SOLVER_H
@@ -0,0 +1,165 @@
+/** @file
+ * Implementacja interfejsu thread_pool.h
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "thread_pool.h"
+
+#define THREAD_POOL_MAX_THREADS 256 ///< gorne ograniczenie liczby watkow
+#define THREAD_POOL_ENV "GAMMA_THREADS" ///< zmienna ustalajaca liczbe watkow
+
+/** @struct thread_pool
+ * @brief Struktura przechowujaca pule watkow i biezace zadanie.
+ */
+typedef struct thread_pool {
+    pthread_t *workers; ///< watki puli
+    uint32_t worker_count; ///< liczba watkow puli, bez watku wywolujacego
+    pthread_mutex_t job_lock; ///< blokada trzymana przez zlecajacego zadanie
+    pthread_mutex_t lock; ///< blokada chroniaca pola ponizej
+    pthread_cond_t work_ready; ///< sygnalizuje nowe zadanie lub zakonczenie
+    pthread_cond_t work_done; ///< sygnalizuje powrot wszystkich watkow
+    uint64_t generation; ///< numer biezacego zadania
+    uint32_t busy_workers; ///< ile watkow nie skonczylo biezacego zadania
+    bool stop; ///< czy watki maja sie zakonczyc
+    thread_pool_task_fn fn; ///< funkcja biezacego zadania
+    void *ctx; ///< kontekst biezacego zadania
+    uint64_t count; ///< liczba elementow biezacego zadania
+    uint32_t chunks; ///< liczba fragmentow biezacego zadania
+    atomic_uint next_chunk; ///< numer kolejnego nieprzydzielonego fragmentu
+} thread_pool_t;
+
+/** Pula wspolna dla calego procesu. */
+static thread_pool_t pool = {
+    .job_lock = PTHREAD_MUTEX_INITIALIZER,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .work_ready = PTHREAD_COND_INITIALIZER,
+    .work_done = PTHREAD_COND_INITIALIZER,
+};
+
+/** Zapewnia jednokrotne utworzenie puli. */
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+
+/** @brief Wykonuje kolejne nieprzydzielone fragmenty biezacego zadania. */
+static void run_chunks(void) {
+    while(true) {
+        uint32_t chunk = atomic_fetch_add(&pool.next_chunk, 1);
+        if(chunk >= pool.chunks) break;
+        uint64_t begin = pool.count * chunk / pool.chunks;
+        uint64_t end = pool.count * (chunk + 1) / pool.chunks;
+        pool.fn(pool.ctx, begin, end, chunk);
+    }
+}
+
+/** @brief Petla watku puli.
+ * @param[in] arg - nieuzywany.
+ * @return NULL.
+ */
+static void *worker_loop(void *arg) {
+    (void) arg;
+    uint64_t seen = 0;
+    pthread_mutex_lock(&pool.lock);
+    while(true) {
+        while(!pool.stop && pool.generation == seen) {
+            pthread_cond_wait(&pool.work_ready, &pool.lock);
+        }
+        if(pool.stop) break;
+        seen = pool.generation;
+        pthread_mutex_unlock(&pool.lock);
+
+        run_chunks();
+
+        pthread_mutex_lock(&pool.lock);
+        if(--pool.busy_workers == 0) {
+            pthread_cond_signal(&pool.work_done);
+        }
+    }
+    pthread_mutex_unlock(&pool.lock);
+    return NULL;
+}
+
+/** @brief Zatrzymuje watki puli przy zakonczeniu procesu. */
+static void pool_shutdown(void) {
+    pthread_mutex_lock(&pool.lock);
+    pool.stop = true;
+    pthread_cond_broadcast(&pool.work_ready);
+    pthread_mutex_unlock(&pool.lock);
+    for(uint32_t i = 0; i < pool.worker_count; ++i) {
+        pthread_join(pool.workers[i], NULL);
+    }
+    free(pool.workers);
+    pool.workers = NULL;
+    pool.worker_count = 0;
+}
+
+/** @brief Tworzy watki puli. */
+static void pool_init(void) {
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    const char *env = getenv(THREAD_POOL_ENV);
+    if(env != NULL && env[0] != '\0') {
+        char *end;
+        long value = strtol(env, &end, 10);
+        if(*end == '\0' && value > 0) threads = value;
+    }
+    if(threads < 1) threads = 1;
+    if(threads > THREAD_POOL_MAX_THREADS) threads = THREAD_POOL_MAX_THREADS;
+
+    pool.worker_count = 0;
+    if(threads == 1) return;
+    pool.workers = malloc(sizeof(pthread_t) * (size_t) (threads - 1));
+    if(pool.workers == NULL) return;
+    for(long i = 0; i < threads - 1; ++i) {
+        if(pthread_create(&pool.workers[pool.worker_count], NULL,
+                          worker_loop, NULL) != 0) {
+            break;
+        }
+        pool.worker_count++;
+    }
+    atexit(pool_shutdown);
+}
+
+uint32_t thread_pool_threads(void) {
+    pthread_once(&pool_once, pool_init);
+    return pool.worker_count + 1;
+}
+
+void thread_pool_parallel_for(uint64_t count, uint32_t chunks,
+                              thread_pool_task_fn fn, void *ctx) {
+    if(chunks == 0) return;
+    if(thread_pool_threads() == 1 || chunks == 1
+       || pthread_mutex_trylock(&pool.job_lock) != 0) {
+        for(uint32_t chunk = 0; chunk < chunks; ++chunk) {
+            fn(ctx, count * chunk / chunks, count * (chunk + 1) / chunks, chunk);
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.fn = fn;
+    pool.ctx = ctx;
+    pool.count = count;
+    pool.chunks = chunks;
+    atomic_store(&pool.next_chunk, 0);
+    pool.busy_workers = pool.worker_count;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.work_ready);
+    pthread_mutex_unlock(&pool.lock);
+
+    run_chunks();
+
+    /* Kolejne zadanie moze nadpisac pola puli dopiero wtedy, gdy zaden
+     * watek nie siega juz do biezacego. */
+    pthread_mutex_lock(&pool.lock);
+    while(pool.busy_workers != 0) {
+        pthread_cond_wait(&pool.work_done, &pool.lock);
+    }
+    pthread_mutex_unlock(&pool.lock);
+    pthread_mutex_unlock(&pool.job_lock);
+}
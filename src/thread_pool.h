@@ -0,0 +1,50 @@
+/** @file
+ * Interfejs wspolnej puli watkow silnika
+ *
+ * Pula jest tworzona leniwie przy pierwszym uzyciu i liczy tyle watkow,
+ * ile procesorow jest dostepnych (lub ile podano w zmiennej srodowiskowej
+ * GAMMA_THREADS), wliczajac watek wywolujacy. Naraz wykonywane jest jedno
+ * zadanie; jesli pula jest zajeta przez inny watek, zadanie wykonuje sie
+ * sekwencyjnie w watku wywolujacym, wiec wywolania z wielu watkow nigdy
+ * na siebie nie czekaja.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Funkcja wykonujaca fragment zadania.
+ * @param[in,out] ctx - kontekst zadania,
+ * @param[in] begin - pierwszy element fragmentu,
+ * @param[in] end - element za ostatnim elementem fragmentu,
+ * @param[in] chunk - numer fragmentu, od 0 do liczby fragmentow minus 1.
+ */
+typedef void (*thread_pool_task_fn)(void *ctx, uint64_t begin, uint64_t end,
+                                    uint32_t chunk);
+
+/** @brief Podaje liczbe watkow wykonujacych zadania.
+ * Tworzy pule, jesli jeszcze nie istnieje.
+ * @return liczba watkow wliczajac watek wywolujacy, co najmniej 1.
+ */
+uint32_t thread_pool_threads(void);
+
+/** @brief Wykonuje zadanie rownolegle.
+ * Dzieli elementy od 0 do @p count - 1 na @p chunks ciaglych fragmentow
+ * i wywoluje @p fn dla kazdego z nich; fragment o numerze @p i obejmuje
+ * elementy od count * i / chunks do count * (i + 1) / chunks - 1.
+ * Funkcja wraca po wykonaniu wszystkich fragmentow.
+ * @param[in] count - liczba elementow,
+ * @param[in] chunks - liczba fragmentow, liczba dodatnia,
+ * @param[in] fn - funkcja wykonujaca fragment,
+ * @param[in,out] ctx - kontekst przekazywany do @p fn.
+ */
+void thread_pool_parallel_for(uint64_t count, uint32_t chunks,
+                              thread_pool_task_fn fn, void *ctx);
+
+#endif //THREAD_POOL_H
@@ -0,0 +1,136 @@
+/** @file
+ * Testy kanonicznego skrotu pozycji i przeksztalcen planszy
+ *
+ * Kazda pozycja jest odtwarzana na nowej grze po kazdej symetrii planszy,
+ * a skroty i pozycje kanoniczne obu gier sa porownywane.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include <string.h>
+#include "test_utils.h"
+
+#define MAX_MOVES 200 ///< najwieksza liczba prob ruchu w losowanej pozycji
+
+/** @brief Podaje liczbe symetrii planszy.
+ * @param[in] g - gra.
+ * @return 8 dla planszy kwadratowej, 4 w przeciwnym przypadku.
+ */
+static uint32_t symmetries(gamma_t *g) {
+    return get_width(g) == get_height(g) ? GAMMA_SYMMETRIES : GAMMA_SYMMETRIES / 2;
+}
+
+/** @brief Zapisuje plansze po przeksztalceniu.
+ * @param[in] g - gra,
+ * @param[in] transform - numer przeksztalcenia,
+ * @param[out] cells - tablica wlascicieli pol obrazu planszy, zapisanych
+ * kolumnami.
+ */
+static void transformed_cells(gamma_t *g, uint32_t transform, uint32_t *cells) {
+    uint32_t height = get_height(g);
+    for(uint32_t x = 0; x < get_width(g); ++x) {
+        for(uint32_t y = 0; y < height; ++y) {
+            uint32_t tx, ty;
+            CHECK(gamma_transform_field(g, transform, x, y, &tx, &ty));
+            cells[tx * height + ty] = gamma_field_owner(g, x, y);
+        }
+    }
+}
+
+/** Obrazy pozycji przez symetrie planszy maja ten sam skrot i te sama
+ * pozycje kanoniczna. */
+static void test_symmetric_positions(void) {
+    static played_move_t moves[MAX_MOVES];
+    unsigned seed = 1;
+    for(int position = 0; position < 300; ++position) {
+        game_params_t params;
+        random_params(&params, 7, 4, 5, &seed);
+        if(position % 2 == 0) params.height = params.width;
+        gamma_t *g = new_game(&params);
+        uint32_t count = play_recorded(g, moves, rand_r(&seed) % MAX_MOVES, 6, &seed);
+        uint32_t to_move = rand_r(&seed) % (params.players + 1);
+        uint32_t cells = params.width * params.height;
+        uint32_t *canonical = malloc(cells * sizeof(uint32_t));
+        uint32_t *image_canonical = malloc(cells * sizeof(uint32_t));
+        CHECK(canonical != NULL && image_canonical != NULL);
+
+        uint32_t transform;
+        uint64_t hash = gamma_canonical_hash(g, to_move, &transform);
+        transformed_cells(g, transform, canonical);
+
+        for(uint32_t t = 0; t < symmetries(g); ++t) {
+            gamma_t *image = replay_transformed(g, t, moves, count);
+            uint32_t image_transform;
+            CHECK(gamma_canonical_hash(image, to_move, &image_transform) == hash);
+            transformed_cells(image, image_transform, image_canonical);
+            CHECK(memcmp(canonical, image_canonical, cells * sizeof(uint32_t)) == 0);
+            gamma_delete(image);
+        }
+        free(canonical);
+        free(image_canonical);
+        gamma_delete(g);
+    }
+}
+
+/** Przeksztalcenie odwrotne przeprowadza kazde pole z powrotem, a
+ * przeksztalcenia zamieniajace kolumny z wierszami nie sa symetriami
+ * planszy prostokatnej. */
+static void test_inverse_transform(void) {
+    gamma_t *square = gamma_new(5, 5, 2, 2);
+    gamma_t *wide = gamma_new(5, 3, 2, 2);
+    CHECK(square != NULL && wide != NULL);
+    gamma_t *games[] = {square, wide};
+    for(int i = 0; i < 2; ++i) {
+        gamma_t *g = games[i];
+        for(uint32_t t = 0; t < GAMMA_SYMMETRIES; ++t) {
+            uint32_t inverse = gamma_inverse_transform(t);
+            uint32_t tx, ty, bx, by;
+            if(t >= symmetries(g)) {
+                CHECK(!gamma_transform_field(g, t, 0, 0, &tx, &ty));
+                continue;
+            }
+            for(uint32_t x = 0; x < get_width(g); ++x) {
+                for(uint32_t y = 0; y < get_height(g); ++y) {
+                    CHECK(gamma_transform_field(g, t, x, y, &tx, &ty));
+                    CHECK(tx < get_width(g) && ty < get_height(g));
+                    CHECK(gamma_transform_field(g, inverse, tx, ty, &bx, &by));
+                    CHECK(bx == x && by == y);
+                }
+            }
+        }
+    }
+    gamma_delete(square);
+    gamma_delete(wide);
+}
+
+/** Skrot rozroznia wykorzystanie zlotego ruchu i gracza wykonujacego ruch. */
+static void test_hash_parts(void) {
+    gamma_t *golden = gamma_new(3, 3, 3, 2);
+    gamma_t *plain = gamma_new(3, 3, 3, 2);
+    CHECK(golden != NULL && plain != NULL);
+    CHECK(gamma_move(golden, 1, 0, 0) && gamma_golden_move(golden, 2, 0, 0));
+    CHECK(gamma_move(plain, 2, 0, 0));
+    CHECK(same_game(golden, plain));
+    for(uint32_t to_move = 0; to_move <= 3; ++to_move) {
+        CHECK(gamma_canonical_hash(golden, to_move, NULL)
+              != gamma_canonical_hash(plain, to_move, NULL));
+        for(uint32_t other = to_move + 1; other <= 3; ++other) {
+            CHECK(gamma_canonical_hash(plain, to_move, NULL)
+                  != gamma_canonical_hash(plain, other, NULL));
+        }
+    }
+    CHECK(gamma_canonical_hash(plain, 4, NULL) == 0);
+    CHECK(gamma_canonical_hash(NULL, 1, NULL) == 0);
+    gamma_delete(golden);
+    gamma_delete(plain);
+}
+
+int main() {
+    test_symmetric_positions();
+    test_inverse_transform();
+    test_hash_parts();
+    return 0;
+}
@@ -0,0 +1,82 @@
+/** @file
+ * Testy tworzenia gry z planszy
+ *
+ * Gra utworzona przez @ref gamma_from_cells z planszy rozegranej gry jest
+ * porownywana z ta gra, rowniez po dalszych ruchach.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include "test_utils.h"
+
+/** @brief Zapisuje plansze gry kolumnami.
+ * @param[in] g - gra.
+ * @return Tablica wlascicieli pol do zwolnienia.
+ */
+static uint32_t* cells_of(gamma_t *g) {
+    uint32_t width = get_width(g), height = get_height(g);
+    uint32_t *cells = malloc((size_t) width * height * sizeof(uint32_t));
+    CHECK(cells != NULL);
+    for(uint32_t x = 0; x < width; ++x) {
+        for(uint32_t y = 0; y < height; ++y) {
+            cells[(size_t) x * height + y] = gamma_field_owner(g, x, y);
+        }
+    }
+    return cells;
+}
+
+/** Gra z planszy rozegranej gry zachowuje sie tak jak ta gra. */
+static void test_random_games(void) {
+    unsigned seed = 1;
+    for(int game = 0; game < 1000; ++game) {
+        game_params_t params;
+        random_params(&params, 9, 5, 6, &seed);
+        gamma_t *played = new_game(&params);
+        play_random(played, rand_r(&seed) % 120, 8, &seed);
+
+        uint32_t *cells = cells_of(played);
+        gamma_t *built = gamma_from_cells(params.width, params.height,
+                                          params.players, params.areas, cells);
+        CHECK(built != NULL && same_game(played, built));
+        for(uint32_t p = 1; p <= params.players; ++p) {
+            CHECK(!gamma_golden_move_used(built, p));
+        }
+
+        /* Zlote ruchy nie sa porownywane, bo w odtworzonej grze zaden
+         * gracz nie wykorzystal zlotego ruchu. */
+        for(int i = 0; i < 80; ++i) {
+            uint32_t player = 1 + rand_r(&seed) % params.players;
+            uint32_t x = rand_r(&seed) % params.width;
+            uint32_t y = rand_r(&seed) % params.height;
+            CHECK(gamma_move(played, player, x, y) == gamma_move(built, player, x, y));
+        }
+        CHECK(same_game(played, built));
+        free(cells);
+        gamma_delete(played);
+        gamma_delete(built);
+    }
+}
+
+/** Plansza, ktorej nie mozna uzyskac w grze o podanych parametrach. */
+static void test_rejected(void) {
+    uint32_t two_areas[] = {1, 2, 2, 1};
+    CHECK(gamma_from_cells(2, 2, 2, 1, two_areas) == NULL);
+    gamma_t *g = gamma_from_cells(2, 2, 2, 2, two_areas);
+    CHECK(g != NULL);
+    CHECK(gamma_busy_fields(g, 1) == 2 && gamma_free_fields(g, 1) == 0);
+    gamma_delete(g);
+
+    uint32_t bad_player[] = {1, 3, 0, 0};
+    CHECK(gamma_from_cells(2, 2, 2, 2, bad_player) == NULL);
+    CHECK(gamma_from_cells(0, 2, 2, 2, bad_player) == NULL);
+    CHECK(gamma_from_cells(2, 2, 2, 2, NULL) == NULL);
+}
+
+int main() {
+    test_random_games();
+    test_rejected();
+    return 0;
+}
@@ -0,0 +1,126 @@
+/** @file
+ * Testy tablicy haszujacej gier
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include "game_table.h"
+#include "test_utils.h"
+
+#define INITIAL_CAPACITY 64 ///< poczatkowa liczba kubelkow tablicy
+#define CHAIN 6 ///< dlugosc budowanego lancucha probkowania
+#define IDS 3000 ///< zakres numerow gier w tescie losowym
+
+/** @brief Podaje kubelek docelowy numeru gry, tak jak game_table.c.
+ * @param[in] id - numer gry,
+ * @param[in] capacity - liczba kubelkow.
+ * @return Numer kubelka.
+ */
+static uint64_t home_slot(uint32_t id, uint64_t capacity) {
+    return ((uint64_t) id * 0x9E3779B97F4A7C15u >> 32) & (capacity - 1);
+}
+
+/** @brief Tworzy mala gre do przechowania w tablicy.
+ * @return Wskaznik na gre.
+ */
+static gamma_t* small_game(void) {
+    gamma_t *g = gamma_new(1, 1, 1, 1);
+    CHECK(g != NULL);
+    return g;
+}
+
+/** @brief Wyszukuje numery gier o tym samym kubelku docelowym.
+ * @param[in] slot - kubelek docelowy,
+ * @param[out] ids - tablica @ref CHAIN numerow.
+ */
+static void colliding_ids(uint64_t slot, uint32_t *ids) {
+    uint32_t found = 0;
+    for(uint32_t id = 0; found < CHAIN; ++id) {
+        if(home_slot(id, INITIAL_CAPACITY) == slot) ids[found++] = id;
+    }
+}
+
+/** Usuniecie gry ze srodka lancucha probkowania, rowniez zawinietego
+ * przez koniec tablicy, nie gubi pozostalych gier lancucha. */
+static void test_remove_inside_chain(void) {
+    uint64_t slots[] = {5, INITIAL_CAPACITY - 2};
+    for(int s = 0; s < 2; ++s) {
+        for(uint32_t removed = 0; removed < CHAIN; ++removed) {
+            uint32_t ids[CHAIN], other[CHAIN];
+            gamma_t *games[CHAIN];
+            colliding_ids(slots[s], ids);
+            colliding_ids(slots[s] + 1, other);
+            game_table_t *t;
+            CHECK(game_table_init(&t));
+            for(uint32_t i = 0; i < CHAIN; ++i) {
+                games[i] = small_game();
+                CHECK(game_table_insert(t, ids[i], games[i]));
+            }
+            /* Gra z sasiedniego kubelka lezy za lancuchem. */
+            gamma_t *neighbour = small_game();
+            CHECK(game_table_insert(t, other[0], neighbour));
+
+            CHECK(game_table_remove(t, ids[removed]));
+            CHECK(!game_table_remove(t, ids[removed]));
+            CHECK(game_table_find(t, ids[removed]) == NULL);
+            for(uint32_t i = 0; i < CHAIN; ++i) {
+                if(i != removed) CHECK(game_table_find(t, ids[i]) == games[i]);
+            }
+            CHECK(game_table_find(t, other[0]) == neighbour);
+            CHECK(game_table_size(t) == CHAIN);
+            delete_game_table(t);
+        }
+    }
+}
+
+/** Tablica zachowuje sie jak zwykla tablica numerow gier przy wstawianiu
+ * ponad poczatkowa pojemnosc i usuwaniu. */
+static void test_random_operations(void) {
+    static gamma_t *expected[IDS];
+    game_table_t *t;
+    CHECK(game_table_init(&t));
+    unsigned seed = 1;
+    uint64_t size = 0;
+    for(int i = 0; i < 40000; ++i) {
+        uint32_t id = rand_r(&seed) % IDS;
+        /* Najpierw przewazaja wstawienia, a potem usuniecia. */
+        bool insert = (int) (rand_r(&seed) % 40000) >= i;
+        if(insert) {
+            gamma_t *g = small_game();
+            bool inserted = game_table_insert(t, id, g);
+            CHECK(inserted == (expected[id] == NULL));
+            if(inserted) {
+                expected[id] = g;
+                size++;
+            }
+            else {
+                gamma_delete(g);
+            }
+        }
+        else {
+            CHECK(game_table_remove(t, id) == (expected[id] != NULL));
+            if(expected[id] != NULL) size--;
+            expected[id] = NULL;
+        }
+        CHECK(game_table_size(t) == size);
+        if(i % 1000 == 0) {
+            for(uint32_t j = 0; j < IDS; ++j) {
+                CHECK(game_table_find(t, j) == expected[j]);
+            }
+        }
+    }
+    for(uint32_t j = 0; j < IDS; ++j) {
+        CHECK(game_table_find(t, j) == expected[j]);
+    }
+    delete_game_table(t);
+    delete_game_table(NULL);
+}
+
+int main() {
+    test_remove_inside_chain();
+    test_random_operations();
+    return 0;
+}
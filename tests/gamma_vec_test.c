@@ -0,0 +1,158 @@
+/** @file
+ * Testy wielu jednoczesnych gier
+ *
+ * Kazda gra z @ref gamma_vec_t jest porownywana z gra @ref gamma_t, na
+ * ktorej wykonywane sa te same akcje wedlug zasad opisanych w gamma_vec.h.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include "gamma_vec.h"
+#include "test_utils.h"
+
+#define STEPS 300 ///< liczba krokow wszystkich gier w jednym tescie
+
+/** @brief Podaje wynik gracza.
+ * @param[in] g - gra,
+ * @param[in] player - numer gracza.
+ * @return Liczba pol gracza pomniejszona o najwieksza liczbe pol przeciwnika.
+ */
+static int32_t score(gamma_t *g, uint32_t player) {
+    uint64_t best = 0;
+    for(uint32_t p = 1; p <= get_players(g); ++p) {
+        if(p != player && gamma_busy_fields(g, p) > best) {
+            best = gamma_busy_fields(g, p);
+        }
+    }
+    return (int32_t) gamma_busy_fields(g, player) - (int32_t) best;
+}
+
+/** @brief Podaje nastepnego gracza, ktory moze wykonac ruch.
+ * @param[in] g - gra,
+ * @param[in] player - numer gracza, ktory wykonal ruch.
+ * @return Numer nastepnego gracza lub 0, jesli gra sie skonczyla.
+ */
+static uint32_t next_player(gamma_t *g, uint32_t player) {
+    uint32_t players = get_players(g);
+    for(uint32_t k = 1; k <= players; ++k) {
+        uint32_t p = (player + k - 1) % players + 1;
+        if(gamma_free_fields(g, p) > 0 || gamma_golden_possible(g, p)) return p;
+    }
+    return 0;
+}
+
+/** @brief Porownuje gry z @ref gamma_vec_t z grami @ref gamma_t.
+ * @param[in] count - liczba gier,
+ * @param[in] params - parametry gier,
+ * @param[in,out] seed - ziarno generatora.
+ */
+static void check_games(uint32_t count, const game_params_t *params,
+                        unsigned *seed) {
+    uint32_t height = params->height;
+    uint32_t cells = params->width * height;
+    gamma_vec_t *env;
+    CHECK(gamma_vec_init(&env, count, params->width, height, params->players,
+                         params->areas));
+    CHECK(gamma_vec_count(env) == count);
+    gamma_t **games = malloc(count * sizeof(gamma_t*));
+    uint32_t *to_move = malloc(count * sizeof(uint32_t));
+    uint32_t *actions = malloc(count * sizeof(uint32_t));
+    int32_t *rewards = malloc(count * sizeof(int32_t));
+    bool *done = malloc(count * sizeof(bool));
+    uint8_t *boards = malloc((size_t) count * cells);
+    uint32_t *observed = malloc(count * sizeof(uint32_t));
+    CHECK(games != NULL && to_move != NULL && actions != NULL && rewards != NULL
+          && done != NULL && boards != NULL && observed != NULL);
+    for(uint32_t i = 0; i < count; ++i) {
+        games[i] = new_game(params);
+        to_move[i] = 1;
+    }
+
+    for(int step = 0; step < STEPS; ++step) {
+        for(uint32_t i = 0; i < count; ++i) {
+            actions[i] = rand_r(seed) % (2 * cells + 1);
+        }
+        CHECK(gamma_vec_step(env, actions, rewards, done));
+        gamma_vec_observe(env, boards, observed);
+        for(uint32_t i = 0; i < count; ++i) {
+            gamma_t *g = games[i];
+            uint32_t player = to_move[i], action = actions[i];
+            int32_t before = score(g, player);
+            bool legal = false;
+            if(action < cells) {
+                legal = gamma_move(g, player, action / height, action % height);
+            }
+            else if(action < 2 * cells) {
+                action -= cells;
+                legal = gamma_golden_move(g, player, action / height, action % height);
+            }
+            CHECK(rewards[i] == (legal ? score(g, player) - before : 0));
+
+            bool finished = false;
+            if(legal) {
+                to_move[i] = next_player(g, player);
+                finished = to_move[i] == 0;
+            }
+            CHECK(done[i] == finished);
+            if(finished) {
+                gamma_delete(g);
+                games[i] = g = new_game(params);
+                to_move[i] = 1;
+            }
+            CHECK(observed[i] == to_move[i]);
+            for(uint32_t c = 0; c < cells; ++c) {
+                CHECK(boards[(size_t) i * cells + c]
+                      == gamma_field_owner(g, c / height, c % height));
+            }
+        }
+    }
+
+    CHECK(gamma_vec_reset(env, 0));
+    CHECK(!gamma_vec_reset(env, count));
+    gamma_vec_observe(env, boards, observed);
+    CHECK(observed[0] == 1);
+    for(uint32_t c = 0; c < cells; ++c) CHECK(boards[c] == 0);
+
+    for(uint32_t i = 0; i < count; ++i) gamma_delete(games[i]);
+    free(games);
+    free(to_move);
+    free(actions);
+    free(rewards);
+    free(done);
+    free(boards);
+    free(observed);
+    delete_gamma_vec(env);
+}
+
+/** Gry z @ref gamma_vec_t przebiegaja tak jak gry @ref gamma_t. */
+static void test_random_games(void) {
+    unsigned seed = 1;
+    for(int test = 0; test < 30; ++test) {
+        game_params_t params;
+        random_params(&params, 6, 4, 4, &seed);
+        check_games(1 + rand_r(&seed) % 50, &params, &seed);
+    }
+}
+
+/** Niepoprawne parametry sa odrzucane. */
+static void test_invalid(void) {
+    gamma_vec_t *env;
+    CHECK(!gamma_vec_init(&env, 0, 2, 2, 2, 2));
+    CHECK(!gamma_vec_init(&env, 1, 0, 2, 2, 2));
+    CHECK(!gamma_vec_init(&env, 1, 2, 2, GAMMA_VEC_MAX_PLAYERS + 1, 2));
+    CHECK(!gamma_vec_init(&env, 1, GAMMA_VEC_MAX_CELLS + 1, 1, 2, 2));
+    CHECK(gamma_vec_init(&env, 2, 2, 2, 2, 2));
+    CHECK(!gamma_vec_step(env, NULL, NULL, NULL));
+    CHECK(!gamma_vec_step(NULL, (uint32_t[]) {0, 0}, NULL, NULL));
+    delete_gamma_vec(env);
+    delete_gamma_vec(NULL);
+}
+
+int main() {
+    test_random_games();
+    test_invalid();
+    return 0;
+}
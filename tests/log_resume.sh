@@ -0,0 +1,22 @@
+#!/bin/sh
+# Sprawdza, czy gry trybu wsadowego i trybu wielu gier wznawiaja sie
+# z dziennikow ruchow po ponownym uruchomieniu programu.
+# Uzycie: log_resume.sh SCIEZKA_PROGRAMU_GAMMA
+set -e
+gamma="$1"
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+
+printf 'B 4 3 2 2\nm 1 0 0\nm 2 3 2\n' | GAMMA_LOG="$dir/game.log" "$gamma" > /dev/null
+out=$(printf 'B 4 3 2 2\np\n' | GAMMA_LOG="$dir/game.log" "$gamma")
+[ "$out" = "$(printf 'OK 1\n...2\n....\n1...')" ]
+
+printf 'S\nn 5 3 2 2 1\nm 5 2 1 1\n' | GAMMA_LOG_DIR="$dir" "$gamma" > /dev/null
+out=$(printf 'S\nn 5 3 2 2 1\np 5\n' | GAMMA_LOG_DIR="$dir" "$gamma")
+[ "$out" = "$(printf 'OK 1\n1\n.2.\n...')" ]
+
+# Plansza we wspoldzielonej pamieci nie wznawia sie z dziennika.
+if printf 'B 4 3 2 2\np\n' | GAMMA_LOG="$dir/game.log" GAMMA_SHM_BOARD=/gamma_log_resume \
+    "$gamma" > /dev/null 2>&1; then
+    exit 1
+fi
@@ -0,0 +1,119 @@
+/** @file
+ * Testy wykonywania ciagu ruchow
+ *
+ * Gra, na ktorej wykonano ciag ruchow przez @ref gamma_move_batch, jest
+ * porownywana z gra, na ktorej te same ruchy wykonano po kolei przez
+ * @ref gamma_move.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include <string.h>
+#include "test_utils.h"
+
+#define MOVES 4000 ///< dlugosc losowanego ciagu ruchow
+
+/** @brief Sprawdza, czy dwie gry maja ten sam stan.
+ * @param[in] a - pierwsza gra,
+ * @param[in] b - druga gra.
+ * @return @p true, jesli stan gier, lacznie ze zlotymi ruchami, jest taki sam.
+ */
+static bool same_game_and_golden(gamma_t *a, gamma_t *b) {
+    bool same = same_game(a, b);
+    for(uint32_t p = 1; same && p <= get_players(a); ++p) {
+        same = gamma_golden_possible(a, p) == gamma_golden_possible(b, p);
+    }
+    return same;
+}
+
+/** @brief Zapisuje kolejne zmiany planszy.
+ * @param[in,out] ctx - tablica zmian z licznikiem na poczatku,
+ * @param[in] change - opis zmiany.
+ */
+static void record_change(void *ctx, const gamma_change_t *change) {
+    gamma_change_t *changes = ctx;
+    changes[++changes[0].seq] = *change;
+}
+
+/** @brief Porownuje ciag ruchow z ruchami wykonywanymi po kolei.
+ * @param[in] params - parametry gry,
+ * @param[in] subscribed - czy obie gry maja subskrybenta,
+ * @param[in,out] seed - ziarno generatora.
+ */
+static void check_batch(const game_params_t *params, bool subscribed,
+                        unsigned *seed) {
+    static gamma_batch_move_t moves[MOVES];
+    static bool expected[MOVES], results[MOVES];
+    static gamma_change_t single_changes[MOVES + 1], batch_changes[MOVES + 1];
+    gamma_t *single = new_game(params);
+    gamma_t *batch = new_game(params);
+    if(subscribed) {
+        single_changes[0].seq = batch_changes[0].seq = 0;
+        CHECK(gamma_subscribe(single, record_change, single_changes) != 0);
+        CHECK(gamma_subscribe(batch, record_change, batch_changes) != 0);
+    }
+
+    for(uint64_t done = 0; done < MOVES;) {
+        uint64_t n = 1 + rand_r(seed) % (MOVES - done);
+        for(uint64_t i = 0; i < n; ++i) {
+            moves[i].player = rand_r(seed) % (params->players + 2);
+            moves[i].x = rand_r(seed) % (params->width + 1);
+            moves[i].y = rand_r(seed) % (params->height + 1);
+        }
+        uint64_t count = 0;
+        for(uint64_t i = 0; i < n; ++i) {
+            expected[i] = gamma_move(single, moves[i].player, moves[i].x, moves[i].y);
+            count += expected[i];
+            results[i] = !expected[i];
+        }
+        CHECK(gamma_move_batch(batch, moves, n, results) == count);
+        CHECK(memcmp(expected, results, n * sizeof(bool)) == 0);
+        CHECK(same_game_and_golden(single, batch));
+        done += n;
+    }
+
+    if(subscribed) {
+        CHECK(single_changes[0].seq == batch_changes[0].seq);
+        for(uint64_t i = 1; i <= single_changes[0].seq; ++i) {
+            gamma_change_t *a = &single_changes[i], *b = &batch_changes[i];
+            CHECK(a->seq == b->seq && a->kind == b->kind);
+            CHECK(a->x == b->x && a->y == b->y);
+            CHECK(a->old_owner == b->old_owner && a->new_owner == b->new_owner);
+            CHECK(a->old_owner_areas == b->old_owner_areas);
+            CHECK(a->new_owner_areas == b->new_owner_areas);
+        }
+    }
+    gamma_delete(single);
+    gamma_delete(batch);
+}
+
+/** Ciag ruchow daje ten sam stan co ruchy wykonywane po kolei. */
+static void test_random_batches(void) {
+    unsigned seed = 1;
+    for(int game = 0; game < 40; ++game) {
+        game_params_t params;
+        random_params(&params, 40, 8, 50, &seed);
+        check_batch(&params, game % 2 == 1, &seed);
+    }
+}
+
+/** Ciag ruchow bez tablicy wynikow i pusty ciag ruchow. */
+static void test_edge_cases(void) {
+    gamma_batch_move_t moves[] = {{1, 0, 0}, {2, 0, 0}, {2, 1, 1}};
+    gamma_t *g = gamma_new(2, 2, 2, 1);
+    CHECK(g != NULL);
+    CHECK(gamma_move_batch(g, moves, 0, NULL) == 0);
+    CHECK(gamma_move_batch(g, moves, 3, NULL) == 2);
+    CHECK(gamma_field_owner(g, 0, 0) == 1 && gamma_field_owner(g, 1, 1) == 2);
+    CHECK(gamma_move_batch(NULL, moves, 3, NULL) == 0);
+    gamma_delete(g);
+}
+
+int main() {
+    test_random_batches();
+    test_edge_cases();
+    return 0;
+}
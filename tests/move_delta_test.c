@@ -0,0 +1,140 @@
+/** @file
+ * Testy oceny ruchow bez ich wykonywania
+ *
+ * Wynik @ref gamma_move_delta i @ref gamma_golden_move_delta jest
+ * porownywany ze zmiana stanu kopii gry, na ktorej ruch wykonano.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include <string.h>
+#include "test_utils.h"
+
+#define MAX_PLAYERS 4 ///< najwieksza liczba graczy w losowanych grach
+
+/** Stan gry widoczny przez interfejs gamma.h. */
+typedef struct snapshot {
+    char *board; ///< napis z plansza
+    uint64_t busy[MAX_PLAYERS + 1]; ///< pola zajete przez graczy
+    uint64_t free[MAX_PLAYERS + 1]; ///< pola, ktore gracze moga zajac
+} snapshot_t;
+
+/** @brief Zapisuje stan gry.
+ * @param[in] g - gra,
+ * @param[out] s - zapisany stan, napis z plansza trzeba zwolnic.
+ */
+static void take_snapshot(gamma_t *g, snapshot_t *s) {
+    s->board = gamma_board(g);
+    CHECK(s->board != NULL);
+    for(uint32_t p = 1; p <= get_players(g); ++p) {
+        s->busy[p] = gamma_busy_fields(g, p);
+        s->free[p] = gamma_free_fields(g, p);
+    }
+}
+
+/** @brief Sprawdza, czy stan gry jest taki jak zapisany.
+ * @param[in] g - gra,
+ * @param[in] s - zapisany stan.
+ * @return @p true, jesli stan sie nie zmienil.
+ */
+static bool same_snapshot(gamma_t *g, const snapshot_t *s) {
+    snapshot_t now;
+    take_snapshot(g, &now);
+    bool same = strcmp(now.board, s->board) == 0;
+    for(uint32_t p = 1; p <= get_players(g); ++p) {
+        same = same && now.busy[p] == s->busy[p] && now.free[p] == s->free[p];
+    }
+    free(now.board);
+    return same;
+}
+
+/** @brief Porownuje ocene ruchu z jego wykonaniem na kopii gry.
+ * @param[in,out] g - gra, ktorej stan nie moze sie zmienic,
+ * @param[in] player - numer gracza,
+ * @param[in] x - numer kolumny,
+ * @param[in] y - numer wiersza,
+ * @param[in] golden - czy ruch jest zloty.
+ */
+static void check_delta(gamma_t *g, uint32_t player, uint32_t x, uint32_t y,
+                        bool golden) {
+    snapshot_t before;
+    take_snapshot(g, &before);
+    gamma_move_delta_t d;
+    bool legal = golden ? gamma_golden_move_delta(g, player, x, y, &d)
+                        : gamma_move_delta(g, player, x, y, &d);
+    CHECK(same_snapshot(g, &before));
+
+    gamma_t *copy = gamma_clone(g);
+    CHECK(copy != NULL);
+    bool done = golden ? gamma_golden_move(copy, player, x, y)
+                       : gamma_move(copy, player, x, y);
+    CHECK(legal == done);
+    if(legal) {
+        snapshot_t after;
+        take_snapshot(copy, &after);
+        CHECK(d.old_owner == (golden ? gamma_field_owner(g, x, y) : 0));
+        for(uint32_t p = 1; p <= get_players(g); ++p) {
+            int64_t busy = (int64_t) after.busy[p] - (int64_t) before.busy[p];
+            int64_t free_fields = (int64_t) after.free[p] - (int64_t) before.free[p];
+            if(p == player) {
+                CHECK(busy == d.fields && free_fields == d.free_fields);
+            }
+            else if(p == d.old_owner) {
+                CHECK(busy == d.old_owner_fields);
+                CHECK(free_fields == d.old_owner_free_fields);
+            }
+            else {
+                CHECK(busy == 0);
+                if(golden) CHECK(free_fields == 0);
+            }
+        }
+        free(after.board);
+    }
+    free(before.board);
+    gamma_delete(copy);
+}
+
+/** Ocena zgadza sie z wykonaniem ruchu w losowych grach. */
+static void test_random_games(void) {
+    unsigned seed = 1;
+    for(int game = 0; game < 500; ++game) {
+        game_params_t params;
+        random_params(&params, 6, MAX_PLAYERS, 3, &seed);
+        gamma_t *g = new_game(&params);
+        for(int i = 0; i < 60; ++i) {
+            uint32_t player = 1 + rand_r(&seed) % params.players;
+            uint32_t x = rand_r(&seed) % params.width;
+            uint32_t y = rand_r(&seed) % params.height;
+            bool golden = rand_r(&seed) % 6 == 0;
+            check_delta(g, player, x, y, golden);
+            if(golden) gamma_golden_move(g, player, x, y);
+            else gamma_move(g, player, x, y);
+        }
+        gamma_delete(g);
+    }
+}
+
+/** Niepoprawne parametry daja nielegalny ruch. */
+static void test_invalid(void) {
+    gamma_t *g = gamma_new(3, 3, 2, 2);
+    CHECK(g != NULL);
+    CHECK(!gamma_move_delta(NULL, 1, 0, 0, NULL));
+    CHECK(!gamma_move_delta(g, 0, 0, 0, NULL));
+    CHECK(!gamma_move_delta(g, 3, 0, 0, NULL));
+    CHECK(!gamma_move_delta(g, 1, 3, 0, NULL));
+    CHECK(gamma_move_delta(g, 1, 0, 0, NULL));
+    CHECK(gamma_move(g, 1, 0, 0));
+    CHECK(!gamma_move_delta(g, 2, 0, 0, NULL));
+    CHECK(!gamma_golden_move_delta(g, 1, 0, 0, NULL));
+    CHECK(gamma_golden_move_delta(g, 2, 0, 0, NULL));
+    gamma_delete(g);
+}
+
+int main() {
+    test_random_games();
+    test_invalid();
+    return 0;
+}
@@ -0,0 +1,205 @@
+/** @file
+ * Testy dziennika ruchow i wznawiania gry z dziennika
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "move_log.h"
+#include "test_utils.h"
+
+#define HEADER_SIZE 24 ///< rozmiar naglowka dziennika w bajtach
+#define RECORD_SIZE 14 ///< rozmiar wpisu dziennika w bajtach
+
+/** Katalog na pliki dziennikow, usuwany po testach. */
+static char dir[] = "/tmp/gamma_log_test.XXXXXX";
+
+/** @brief Podaje sciezke pliku w katalogu testow.
+ * @param[in] name - nazwa pliku.
+ * @return Sciezka w buforze statycznym.
+ */
+static const char* path_of(const char *name) {
+    static char path[256];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    return path;
+}
+
+/** @brief Podaje rozmiar pliku.
+ * @param[in] path - sciezka pliku.
+ * @return Rozmiar w bajtach lub -1, jesli plik nie istnieje.
+ */
+static long file_size(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0 ? (long) st.st_size : -1;
+}
+
+/** @brief Wykonuje pseudolosowe ruchy na dwoch grach naraz.
+ * @param[in,out] logged - gra z dziennikiem,
+ * @param[in,out] plain - gra bez dziennika,
+ * @param[in] moves - liczba prob ruchu,
+ * @param[in,out] seed - ziarno generatora.
+ */
+static void play_both(gamma_t *logged, gamma_t *plain, int moves,
+                      unsigned *seed) {
+    for(int i = 0; i < moves; ++i) {
+        uint32_t player = 1 + rand_r(seed) % 3;
+        uint32_t x = rand_r(seed) % 9, y = rand_r(seed) % 7;
+        if(rand_r(seed) % 8 == 0) {
+            CHECK(gamma_golden_move(logged, player, x, y)
+                  == gamma_golden_move(plain, player, x, y));
+        }
+        else {
+            CHECK(gamma_move(logged, player, x, y) == gamma_move(plain, player, x, y));
+        }
+    }
+}
+
+/** Gra wznowiona z dziennika ma stan gry, ktora go zapisala. */
+static void test_resume(void) {
+    const char *path = path_of("resume.log");
+    unsigned seed = 1;
+    gamma_t *plain = gamma_new(9, 7, 3, 4);
+    gamma_t *logged = gamma_new_logged(path, 9, 7, 3, 4, 16, 0);
+    CHECK(plain != NULL && logged != NULL);
+    play_both(logged, plain, 200, &seed);
+    gamma_delete(logged);
+
+    logged = gamma_new_logged(path, 9, 7, 3, 4, 16, 0);
+    CHECK(logged != NULL && same_board(logged, plain));
+    play_both(logged, plain, 200, &seed);
+    gamma_delete(logged);
+
+    gamma_t *replayed = gamma_replay(path);
+    CHECK(replayed != NULL && same_board(replayed, plain));
+    for(uint32_t p = 1; p <= 3; ++p) {
+        CHECK(gamma_busy_fields(replayed, p) == gamma_busy_fields(plain, p));
+        CHECK(gamma_golden_possible(replayed, p) == gamma_golden_possible(plain, p));
+    }
+    gamma_delete(replayed);
+    gamma_delete(plain);
+
+    CHECK(gamma_new_logged(path, 9, 7, 3, 5, 16, 0) == NULL);
+}
+
+/** Do dziennika trafiaja tylko ruchy, ktore zostaly wykonane. */
+static void test_only_legal_moves_logged(void) {
+    const char *path = path_of("legal.log");
+    gamma_t *g = gamma_new_logged(path, 3, 3, 2, 1, 1, 0);
+    CHECK(g != NULL);
+    CHECK(gamma_move(g, 1, 0, 0));
+    CHECK(!gamma_move(g, 2, 0, 0));
+    CHECK(!gamma_move(g, 1, 2, 2));
+    CHECK(!gamma_move(g, 3, 1, 1));
+    CHECK(gamma_golden_move(g, 2, 0, 0));
+    CHECK(!gamma_golden_move(g, 2, 0, 0));
+    CHECK(file_size(path) == HEADER_SIZE + 2 * RECORD_SIZE);
+    gamma_delete(g);
+}
+
+/** Zbuforowane ruchy trafiaja na dysk po uplywie czasu bez kolejnych ruchow. */
+static void test_interval_flush(void) {
+    const char *path = path_of("interval.log");
+    gamma_t *g = gamma_new_logged(path, 4, 4, 2, 2, 0, 10);
+    CHECK(g != NULL);
+    CHECK(gamma_move(g, 1, 0, 0));
+    CHECK(gamma_move(g, 2, 3, 3));
+    struct timespec pause = {0, 20000000};
+    long size = 0;
+    for(int i = 0; i < 100 && size != HEADER_SIZE + 2 * RECORD_SIZE; ++i) {
+        nanosleep(&pause, NULL);
+        size = file_size(path);
+    }
+    CHECK(size == HEADER_SIZE + 2 * RECORD_SIZE);
+    gamma_delete(g);
+}
+
+/** @brief Sprawdza dziennik, ktorego zapis sie nie udal.
+ * Po nieudanym zapisie dziennik odrzuca kolejne ruchy, a plik pozostaje
+ * zgodny z wykonanymi ruchami.
+ * @param[in] name - nazwa pliku dziennika,
+ * @param[in] sync_moves - co ile ruchow dziennik jest utrwalany,
+ * @param[in] sync_ms - co ile milisekund dziennik jest utrwalany.
+ */
+static void check_failed_log_is_sticky(const char *name, uint32_t sync_moves,
+                                       uint32_t sync_ms) {
+    const char *path = path_of(name);
+    gamma_t *g = gamma_new_logged(path, 8, 8, 2, 64, sync_moves, sync_ms);
+    CHECK(g != NULL);
+
+    struct rlimit old_limit, limit;
+    CHECK(getrlimit(RLIMIT_FSIZE, &old_limit) == 0);
+    limit = old_limit;
+    limit.rlim_cur = HEADER_SIZE + 5 * RECORD_SIZE;
+    signal(SIGXFSZ, SIG_IGN);
+    CHECK(setrlimit(RLIMIT_FSIZE, &limit) == 0);
+
+    uint32_t accepted = 0;
+    for(uint32_t x = 0; x < 8; ++x) {
+        if(gamma_move(g, 1, x, 0)) accepted++;
+    }
+    if(sync_ms == 0) {
+        CHECK(accepted == 5);
+    }
+    else {
+        /* Ruchy czekaja w buforze, az watek zapisujacy sprobuje je
+         * utrwalic i mu sie to nie uda. */
+        CHECK(accepted == 8);
+        struct timespec pause = {0, 100000000};
+        nanosleep(&pause, NULL);
+    }
+    CHECK(!gamma_move(g, 2, 7, 7));
+    CHECK(gamma_busy_fields(g, 1) == accepted && gamma_busy_fields(g, 2) == 0);
+
+    CHECK(setrlimit(RLIMIT_FSIZE, &old_limit) == 0);
+    CHECK(!gamma_move(g, 2, 7, 7));
+    gamma_delete(g);
+    g = gamma_new(8, 8, 2, 64);
+    CHECK(g != NULL);
+    for(uint32_t x = 0; x < accepted; ++x) CHECK(gamma_move(g, 1, x, 0));
+    gamma_t *replayed = gamma_replay(path);
+    CHECK(replayed != NULL && same_board(replayed, g));
+    gamma_delete(replayed);
+    gamma_delete(g);
+}
+
+/** Nieudany zapis przy utrwalaniu po kazdym ruchu i po uplywie czasu. */
+static void test_failed_log_is_sticky(void) {
+    check_failed_log_is_sticky("full.log", 1, 0);
+    check_failed_log_is_sticky("full_timed.log", 1000, 10);
+}
+
+/** Dwa procesy ani dwie gry nie moga naraz pisac do jednego dziennika. */
+static void test_single_writer(void) {
+    const char *path = path_of("lock.log");
+    gamma_t *g = gamma_new_logged(path, 4, 4, 2, 2, 1, 0);
+    CHECK(g != NULL);
+    CHECK(gamma_new_logged(path, 4, 4, 2, 2, 1, 0) == NULL);
+    gamma_delete(g);
+    g = gamma_new_logged(path, 4, 4, 2, 2, 1, 0);
+    CHECK(g != NULL);
+    gamma_delete(g);
+}
+
+int main() {
+    CHECK(mkdtemp(dir) != NULL);
+    test_resume();
+    test_only_legal_moves_logged();
+    test_interval_flush();
+    test_failed_log_is_sticky();
+    test_single_writer();
+
+    const char *names[] = {"resume.log", "legal.log", "interval.log",
+                           "full.log", "full_timed.log", "lock.log"};
+    for(size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+        unlink(path_of(names[i]));
+    }
+    rmdir(dir);
+    return 0;
+}
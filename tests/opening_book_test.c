@@ -0,0 +1,237 @@
+/** @file
+ * Testy ksiazki otwarc
+ *
+ * Ksiazka jest zapisywana do katalogu tymczasowego, a potem odczytywana
+ * dla obrazow zapisanych pozycji przez symetrie planszy.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include <string.h>
+#include <unistd.h>
+#include "opening_book.h"
+#include "test_utils.h"
+
+#define POSITIONS 40 ///< liczba pozycji zapisywanych w ksiazce
+#define MAX_MOVES 30 ///< liczba prob ruchu w losowanej pozycji
+
+/** Katalog na pliki ksiazek, usuwany po testach. */
+static char dir[] = "/tmp/opening_book_test.XXXXXX";
+
+/**
+ * Pozycja zapisana w ksiazce.
+ */
+typedef struct book_position {
+    played_move_t moves[MAX_MOVES]; ///< ruchy prowadzace do pozycji
+    uint32_t count; ///< liczba ruchow
+    uint32_t to_move; ///< gracz wykonujacy ruch
+    uint32_t x; ///< numer kolumny ruchu z ksiazki
+    uint32_t y; ///< numer wiersza ruchu z ksiazki
+    bool golden; ///< czy ruch z ksiazki jest zloty
+} book_position_t;
+
+/** @brief Podaje sciezke pliku w katalogu testow.
+ * @param[out] path - bufor na sciezke,
+ * @param[in] size - rozmiar bufora,
+ * @param[in] name - nazwa pliku.
+ */
+static void file_path(char *path, size_t size, const char *name) {
+    CHECK(snprintf(path, size, "%s/%s", dir, name) < (int) size);
+}
+
+/** @brief Podaje liczbe symetrii planszy.
+ * @param[in] g - gra.
+ * @return 8 dla planszy kwadratowej, 4 w przeciwnym przypadku.
+ */
+static uint32_t symmetries(gamma_t *g) {
+    return get_width(g) == get_height(g) ? GAMMA_SYMMETRIES : GAMMA_SYMMETRIES / 2;
+}
+
+/** @brief Sprawdza, czy pozycja nie przechodzi na siebie przez zadna
+ * symetrie poza identycznoscia, czyli czy ruch z ksiazki ma w niej
+ * jednoznaczny obraz.
+ * @param[in] g - gra,
+ * @param[in] p - ruchy prowadzace do pozycji.
+ * @return @p true, jesli pozycja nie ma symetrii.
+ */
+static bool asymmetric(gamma_t *g, const book_position_t *p) {
+    bool result = true;
+    for(uint32_t t = 1; t < symmetries(g) && result; ++t) {
+        gamma_t *image = replay_transformed(g, t, p->moves, p->count);
+        result = !same_board(g, image);
+        gamma_delete(image);
+    }
+    return result;
+}
+
+/** @brief Losuje pozycje bez symetrii i ruchy dla nich.
+ * @param[in] params - parametry gry,
+ * @param[out] positions - tablica @ref POSITIONS pozycji,
+ * @param[out] entries - tablica @ref POSITIONS wpisow ksiazki,
+ * @param[in,out] seed - ziarno generatora.
+ */
+static void random_positions(const game_params_t *params, book_position_t *positions,
+                             opening_book_entry_t *entries, unsigned *seed) {
+    for(uint32_t i = 0; i < POSITIONS; ++i) {
+        book_position_t *p = &positions[i];
+        gamma_t *g;
+        uint64_t key;
+        uint32_t transform;
+        bool fresh = false;
+        while(!fresh) {
+            g = new_game(params);
+            p->count = play_recorded(g, p->moves, MAX_MOVES, 6, seed);
+            p->to_move = 1 + rand_r(seed) % params->players;
+            key = gamma_canonical_hash(g, p->to_move, &transform);
+            fresh = asymmetric(g, p);
+            for(uint32_t j = 0; j < i && fresh; ++j) fresh = entries[j].key != key;
+            if(!fresh) gamma_delete(g);
+        }
+        p->x = rand_r(seed) % params->width;
+        p->y = rand_r(seed) % params->height;
+        p->golden = rand_r(seed) % 2 == 0;
+
+        memset(&entries[i], 0, sizeof(entries[i]));
+        entries[i].key = key;
+        CHECK(gamma_transform_field(g, transform, p->x, p->y, &entries[i].x,
+                                    &entries[i].y));
+        entries[i].flags = p->golden ? OPENING_BOOK_GOLDEN : 0;
+        entries[i].value = (int64_t) i;
+        gamma_delete(g);
+    }
+}
+
+/** Ruch z ksiazki dla obrazu zapisanej pozycji przez symetrie planszy jest
+ * obrazem zapisanego ruchu. */
+static void test_round_trip(void) {
+    game_params_t all_params[] = {{5, 5, 3, 3}, {6, 4, 2, 4}};
+    unsigned seed = 1;
+    for(int test = 0; test < 2; ++test) {
+        const game_params_t *params = &all_params[test];
+        static book_position_t positions[POSITIONS + 1];
+        opening_book_entry_t entries[POSITIONS + 1];
+        random_positions(params, positions, entries, &seed);
+        /* Powtorzony klucz jest zapisywany tylko raz. */
+        entries[POSITIONS] = entries[0];
+
+        char path[sizeof(dir) + 32];
+        file_path(path, sizeof(path), "round_trip.book");
+        gamma_t *g = new_game(params);
+        CHECK(opening_book_write(path, g, entries, POSITIONS + 1));
+        opening_book_t *book;
+        CHECK(opening_book_open(&book, path));
+        const opening_book_header_t *header = opening_book_header(book);
+        CHECK(header->width == params->width && header->height == params->height
+              && header->players == params->players && header->areas == params->areas
+              && header->entry_count == POSITIONS);
+
+        for(uint32_t i = 0; i < POSITIONS; ++i) {
+            book_position_t *p = &positions[i];
+            for(uint32_t t = 0; t < symmetries(g); ++t) {
+                gamma_t *image = replay_transformed(g, t, p->moves, p->count);
+                uint32_t x, y, ex, ey;
+                bool golden;
+                CHECK(opening_book_move(book, image, p->to_move, &x, &y, &golden));
+                CHECK(gamma_transform_field(g, t, p->x, p->y, &ex, &ey));
+                CHECK(x == ex && y == ey && golden == p->golden);
+                gamma_delete(image);
+            }
+        }
+
+        /* Pozycja spoza ksiazki i gra o innych parametrach. */
+        uint32_t x, y;
+        bool golden;
+        CHECK(gamma_move(g, 1, 0, 0) && gamma_move(g, 2, 1, 1));
+        CHECK(gamma_golden_move(g, 1, 1, 1) && gamma_golden_move(g, 2, 0, 0));
+        CHECK(!opening_book_move(book, g, 1, &x, &y, &golden));
+        gamma_t *other = gamma_new(params->width, params->height, params->players,
+                                   params->areas + 1);
+        CHECK(other != NULL);
+        CHECK(!opening_book_move(book, other, positions[0].to_move, &x, &y, &golden));
+
+        gamma_delete(other);
+        gamma_delete(g);
+        delete_opening_book(book);
+        CHECK(unlink(path) == 0);
+    }
+}
+
+/** @brief Zapisuje dane do pliku.
+ * @param[in] path - sciezka pliku,
+ * @param[in] data - zapisywane dane,
+ * @param[in] size - liczba bajtow.
+ */
+static void write_file(const char *path, const char *data, size_t size) {
+    FILE *file = fopen(path, "wb");
+    CHECK(file != NULL);
+    CHECK(size == 0 || fwrite(data, size, 1, file) == 1);
+    CHECK(fclose(file) == 0);
+}
+
+/** @brief Sprawdza, czy plik o podanej zawartosci jest ksiazka.
+ * @param[in] data - zawartosc pliku,
+ * @param[in] size - liczba bajtow.
+ * @return @p true, jesli udalo sie otworzyc plik jako ksiazke.
+ */
+static bool opens(const char *data, size_t size) {
+    char path[sizeof(dir) + 32];
+    file_path(path, sizeof(path), "changed.book");
+    write_file(path, data, size);
+    opening_book_t *book = NULL;
+    bool opened = opening_book_open(&book, path);
+    delete_opening_book(book);
+    CHECK(unlink(path) == 0);
+    return opened;
+}
+
+/** Pliki uciete lub z niepoprawnym naglowkiem sa odrzucane. */
+static void test_rejected_files(void) {
+    opening_book_entry_t entries[3];
+    memset(entries, 0, sizeof(entries));
+    for(int i = 0; i < 3; ++i) entries[i].key = 10 + (uint64_t) i;
+    gamma_t *g = gamma_new(3, 3, 2, 2);
+    CHECK(g != NULL);
+    char path[sizeof(dir) + 32];
+    file_path(path, sizeof(path), "valid.book");
+    CHECK(opening_book_write(path, g, entries, 3));
+    gamma_delete(g);
+
+    size_t size = sizeof(opening_book_header_t) + 3 * sizeof(opening_book_entry_t);
+    char data[sizeof(opening_book_header_t) + 3 * sizeof(opening_book_entry_t)];
+    FILE *file = fopen(path, "rb");
+    CHECK(file != NULL && fread(data, size, 1, file) == 1 && fgetc(file) == EOF);
+    CHECK(fclose(file) == 0 && unlink(path) == 0);
+
+    CHECK(opens(data, size));
+    CHECK(!opens(data, size - 1));
+    CHECK(!opens(data, sizeof(opening_book_header_t) - 1));
+    CHECK(!opens(data, 0));
+
+    opening_book_header_t *header = (opening_book_header_t *) data;
+    header->magic[0] = 'X';
+    CHECK(!opens(data, size));
+    header->magic[0] = OPENING_BOOK_MAGIC[0];
+    header->version = OPENING_BOOK_VERSION + 1;
+    CHECK(!opens(data, size));
+    header->version = OPENING_BOOK_VERSION;
+    header->entry_count = 4;
+    CHECK(!opens(data, size));
+    header->entry_count = 3;
+    header->entries_offset = size + sizeof(uint64_t);
+    CHECK(!opens(data, size));
+
+    opening_book_t *book;
+    file_path(path, sizeof(path), "missing.book");
+    CHECK(!opening_book_open(&book, path));
+}
+
+int main() {
+    CHECK(mkdtemp(dir) != NULL);
+    test_round_trip();
+    test_rejected_files();
+    CHECK(rmdir(dir) == 0);
+    return 0;
+}
@@ -0,0 +1,147 @@
+/** @file
+ * Testy serwera gry gamma
+ *
+ * Test uruchamia program gamma_server na gniezdzie w katalogu
+ * tymczasowym, prowadzi gry przez polaczenia z tym gniazdem i sprawdza,
+ * czy po sygnale SIGTERM serwer konczy sie i usuwa plik gniazda.
+ * Uzycie: server_test SCIEZKA_PROGRAMU_GAMMA_SERVER
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "test_utils.h"
+
+#define TIMEOUT_MS 5000 ///< najdluzszy czas oczekiwania na serwer
+
+/** Katalog na gniazdo serwera, usuwany po testach. */
+static char dir[] = "/tmp/gamma_server_test.XXXXXX";
+
+/** Sciezka gniazda serwera. */
+static char socket_path[sizeof(dir) + 16];
+
+/** Numer procesu serwera lub 0, jesli serwer sie zakonczyl. */
+static pid_t server;
+
+/** Zatrzymuje serwer, jesli test zostal przerwany. */
+static void kill_server(void) {
+    if(server > 0) {
+        kill(server, SIGKILL);
+        waitpid(server, NULL, 0);
+        unlink(socket_path);
+        rmdir(dir);
+    }
+}
+
+/** @brief Laczy sie z serwerem.
+ * Ponawia probe, dopoki serwer nie zacznie nasluchiwac.
+ * @return Deskryptor polaczenia.
+ */
+static int connect_to_server(void) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+    struct timespec pause = {0, 10000000};
+    for(int i = 0; i < TIMEOUT_MS / 10; ++i) {
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        CHECK(fd >= 0);
+        if(connect(fd, (struct sockaddr*) &addr, sizeof(addr)) == 0) return fd;
+        close(fd);
+        nanosleep(&pause, NULL);
+    }
+    CHECK(!"server is not listening");
+    return -1;
+}
+
+/** @brief Wysyla komendy polaczeniem.
+ * @param[in] fd - deskryptor polaczenia,
+ * @param[in] commands - wysylany tekst.
+ */
+static void send_commands(int fd, const char *commands) {
+    size_t length = strlen(commands);
+    CHECK(write(fd, commands, length) == (ssize_t) length);
+}
+
+/** @brief Sprawdza odpowiedz serwera.
+ * Czyta z polaczenia tyle bajtow, ile ma oczekiwana odpowiedz.
+ * @param[in] fd - deskryptor polaczenia,
+ * @param[in] expected - oczekiwana odpowiedz.
+ */
+static void expect_reply(int fd, const char *expected) {
+    char reply[1024];
+    size_t length = strlen(expected), got = 0;
+    CHECK(length < sizeof(reply));
+    while(got < length) {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        CHECK(poll(&pfd, 1, TIMEOUT_MS) == 1);
+        ssize_t r = read(fd, reply + got, length - got);
+        CHECK(r > 0);
+        got += (size_t) r;
+    }
+    reply[got] = '\0';
+    if(strcmp(reply, expected) != 0) {
+        fprintf(stderr, "expected:\n%sgot:\n%s", expected, reply);
+        CHECK(!"unexpected reply");
+    }
+}
+
+/** Komendy trybu wsadowego na dwoch przeplatanych polaczeniach. */
+static void test_games(void) {
+    int first = connect_to_server();
+    int second = connect_to_server();
+
+    send_commands(first, "B 3 2 2 2\nm 1 0 0\nm 2 0 0\n");
+    expect_reply(first, "OK 1\n1\n0\n");
+    send_commands(second, "B 2 2 1 1\nm 1 1 1\np\n");
+    expect_reply(second, "OK 1\n1\n.1\n..\n");
+    send_commands(first, "g 2 0 0\nb 1\nb 2\nf 1\nq 1\np\n");
+    expect_reply(first, "1\n0\n1\n5\n1\n...\n2..\n");
+    send_commands(first, "m 9 0 0\nx\n");
+    expect_reply(first, "0\nERROR 11\n");
+    send_commands(second, "m 1 0 0\nb 1\n");
+    expect_reply(second, "0\n1\n");
+    close(first);
+    close(second);
+
+    int third = connect_to_server();
+    send_commands(third, "m 1 0 0\nB 2 1 1 1\np\n");
+    expect_reply(third, "ERROR 1\nOK 2\n..\n");
+    close(third);
+}
+
+int main(int argc, char **argv) {
+    CHECK(argc == 2);
+    CHECK(mkdtemp(dir) != NULL);
+    snprintf(socket_path, sizeof(socket_path), "%s/gamma.sock", dir);
+
+    server = fork();
+    CHECK(server >= 0);
+    if(server == 0) {
+        execl(argv[1], argv[1], socket_path, "2", (char*) NULL);
+        _exit(127);
+    }
+    atexit(kill_server);
+
+    test_games();
+
+    CHECK(kill(server, SIGTERM) == 0);
+    int status;
+    CHECK(waitpid(server, &status, 0) == server);
+    server = 0;
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    CHECK(access(socket_path, F_OK) != 0 && errno == ENOENT);
+    CHECK(rmdir(dir) == 0);
+    return 0;
+}
@@ -0,0 +1,23 @@
+#!/bin/sh
+# Sprawdza komendy trybu wielu gier na przeplatanych numerach gier:
+# tworzenie, ruchy, zmienione pola, wypisywanie planszy i usuwanie gier.
+# Wypisanie planszy przed pierwsza komenda d nie zeruje zmienionych pol.
+# Uzycie: session_mode.sh SCIEZKA_PROGRAMU_GAMMA
+set -e
+gamma="$1"
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+
+printf '%s\n' 'S' 'n 1 3 2 2 2' 'n 7 2 2 1 1' 'm 1 1 0 0' 'm 7 1 1 1' \
+    'm 1 2 2 1' 'd 1' 'g 1 2 0 0' 'd 7' 'd 1' 'b 1 1' 'b 7 1' 'q 1 2' \
+    'p 7' 'p 1 0 0 1 1' 'r 1' 'm 1 1 1 1' 'd 1' 'b 7 1' 'r 1' \
+    'n 7 2 2 1 1' 'n 1 2 2 2 2' 'p 1' 'r 7' 'b 7 1' \
+    'n 3 2 2 1 1' 'm 3 1 0 0' 'p 3' 'd 3' 'p 3' 'd 3' \
+    | "$gamma" > "$dir/out" 2> "$dir/err"
+
+printf '%s\n' 'OK 1' 1 1 1 1 1 2 '0 0 1' '2 1 2' 1 1 '1 1 1' 1 '0 0 2' \
+    0 1 0 '.1' '..' '..' '2.' 1 1 0 0 1 '..' '..' 1 \
+    1 1 '..' '1.' 1 '0 0 1' '..' '1.' 0 > "$dir/expected"
+cmp "$dir/out" "$dir/expected"
+printf '%s\n' 'ERROR 17' 'ERROR 18' 'ERROR 25' > "$dir/expected"
+cmp "$dir/err" "$dir/expected"
@@ -0,0 +1,286 @@
+/** @file
+ * Testy dokladnego rozwiazywania koncowek
+ *
+ * Wynik @ref solver_solve jest porownywany z wynikiem prostego
+ * przeszukiwania minimax calego drzewa gry, bez odciec, symetrii i tablicy
+ * transpozycji, na malych planszach.
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include <string.h>
+#include "solver.h"
+#include "test_utils.h"
+
+#define UNKNOWN INT8_MIN ///< znacznik pozycji, ktorej wynik nie jest znany
+
+/**
+ * Stan przeszukiwania calego drzewa gry.
+ */
+typedef struct brute {
+    uint32_t players; ///< liczba graczy
+    uint32_t player; ///< gracz, dla ktorego liczony jest wynik
+    uint32_t width; ///< szerokosc planszy
+    uint32_t height; ///< wysokosc planszy
+    gamma_t **stack; ///< pozycje kolejnych poziomow przeszukiwania
+    gamma_t *scratch; ///< gra pomocnicza do sprawdzania ruchow
+    int8_t *values; ///< zapamietane wyniki pozycji
+    bool *explored; ///< pozycje, z ktorych nie da sie osiagnac szukanego konca
+} brute_t;
+
+/** @brief Podaje numer pozycji w tablicach zapamietanych wynikow.
+ * @param[in] b - stan przeszukiwania,
+ * @param[in] g - pozycja,
+ * @param[in] mover - gracz wykonujacy ruch lub 0 na koniec gry.
+ * @return Numer pozycji.
+ */
+static size_t position_index(brute_t *b, gamma_t *g, uint32_t mover) {
+    size_t index = 0;
+    for(uint32_t x = 0; x < b->width; ++x) {
+        for(uint32_t y = 0; y < b->height; ++y) {
+            index = index * (b->players + 1) + gamma_field_owner(g, x, y);
+        }
+    }
+    for(uint32_t p = 1; p <= b->players; ++p) {
+        index = index * 2 + gamma_golden_move_used(g, p);
+    }
+    return index * (b->players + 1) + mover;
+}
+
+/** @brief Podaje liczbe wszystkich numerow pozycji.
+ * @param[in] b - stan przeszukiwania.
+ * @return Liczba pozycji.
+ */
+static size_t position_count(brute_t *b) {
+    size_t count = (size_t) 1 << b->players;
+    for(uint32_t i = 0; i < b->width * b->height; ++i) count *= b->players + 1;
+    return count * (b->players + 1);
+}
+
+/** @brief Probuje wykonac ruch.
+ * @param[in,out] g - pozycja,
+ * @param[in] player - numer gracza,
+ * @param[in] cell - numer pola, @p x * @p height + @p y,
+ * @param[in] golden - czy ruch jest zloty.
+ * @return @p true, jesli ruch jest legalny.
+ */
+static bool try_move(gamma_t *g, uint32_t player, uint32_t cell, bool golden) {
+    uint32_t x = cell / get_height(g), y = cell % get_height(g);
+    return golden ? gamma_golden_move(g, player, x, y) : gamma_move(g, player, x, y);
+}
+
+/** @brief Podaje gracza, ktory wykona ruch.
+ * Sprawdza wszystkie ruchy kolejnych graczy, zaczynajac od @p to_move.
+ * @param[in,out] b - stan przeszukiwania,
+ * @param[in] g - pozycja,
+ * @param[in] to_move - gracz, ktorego kolej.
+ * @return Numer pierwszego gracza, ktory ma legalny ruch, lub 0.
+ */
+static uint32_t next_mover(brute_t *b, gamma_t *g, uint32_t to_move) {
+    for(uint32_t k = 0; k < b->players; ++k) {
+        uint32_t p = (to_move + k - 1) % b->players + 1;
+        for(uint32_t cell = 0; cell < b->width * b->height; ++cell) {
+            for(int golden = 0; golden < 2; ++golden) {
+                CHECK(gamma_copy(b->scratch, g));
+                if(try_move(b->scratch, p, cell, golden)) return p;
+            }
+        }
+    }
+    return 0;
+}
+
+/** @brief Ocenia koniec gry.
+ * @param[in] b - stan przeszukiwania,
+ * @param[in] g - pozycja.
+ * @return Liczba pol gracza pomniejszona o najwieksza liczbe pol przeciwnika.
+ */
+static int8_t final_value(brute_t *b, gamma_t *g) {
+    int64_t best_other = 0;
+    for(uint32_t p = 1; p <= b->players; ++p) {
+        if(p != b->player && (int64_t) gamma_busy_fields(g, p) > best_other) {
+            best_other = (int64_t) gamma_busy_fields(g, p);
+        }
+    }
+    return (int8_t) ((int64_t) gamma_busy_fields(g, b->player) - best_other);
+}
+
+/** @brief Liczy wynik pozycji przeszukujac cale drzewo gry.
+ * Pozycja jest zapisana w @p b->stack[depth].
+ * @param[in,out] b - stan przeszukiwania,
+ * @param[in] depth - poziom przeszukiwania,
+ * @param[in] to_move - gracz, ktorego kolej.
+ * @return Wynik pozycji przy optymalnej grze.
+ */
+static int8_t brute_value(brute_t *b, uint32_t depth, uint32_t to_move) {
+    gamma_t *g = b->stack[depth];
+    uint32_t mover = next_mover(b, g, to_move);
+    size_t index = position_index(b, g, mover);
+    if(b->values[index] != UNKNOWN) return b->values[index];
+
+    int8_t best = mover == b->player ? INT8_MIN + 1 : INT8_MAX;
+    if(mover == 0) best = final_value(b, g);
+    for(uint32_t cell = 0; mover != 0 && cell < b->width * b->height; ++cell) {
+        for(int golden = 0; golden < 2; ++golden) {
+            gamma_t *child = b->stack[depth + 1];
+            CHECK(gamma_copy(child, g));
+            if(!try_move(child, mover, cell, golden)) continue;
+            int8_t value = brute_value(b, depth + 1, mover % b->players + 1);
+            if(mover == b->player ? value > best : value < best) best = value;
+        }
+    }
+    b->values[index] = best;
+    return best;
+}
+
+/** @brief Sprawdza, czy optymalna gra moze sie skonczyc podanym wynikiem.
+ * Pozycja jest zapisana w @p b->stack[depth].
+ * @param[in,out] b - stan przeszukiwania,
+ * @param[in] depth - poziom przeszukiwania,
+ * @param[in] to_move - gracz, ktorego kolej,
+ * @param[in] fields - liczby pol graczy na koniec gry.
+ * @return @p true, jesli istnieje przebieg gry, w ktorym kazdy ruch jest
+ * optymalny, konczacy sie liczbami pol @p fields.
+ */
+static bool optimal_end(brute_t *b, uint32_t depth, uint32_t to_move,
+                        const uint64_t *fields) {
+    gamma_t *g = b->stack[depth];
+    uint32_t mover = next_mover(b, g, to_move);
+    size_t index = position_index(b, g, mover);
+    if(b->explored[index]) return false;
+    b->explored[index] = true;
+    if(mover == 0) {
+        for(uint32_t p = 1; p <= b->players; ++p) {
+            if(gamma_busy_fields(g, p) != fields[p]) return false;
+        }
+        return true;
+    }
+
+    int8_t value = b->values[index];
+    for(uint32_t cell = 0; cell < b->width * b->height; ++cell) {
+        for(int golden = 0; golden < 2; ++golden) {
+            gamma_t *child = b->stack[depth + 1];
+            CHECK(gamma_copy(child, g));
+            if(!try_move(child, mover, cell, golden)) continue;
+            uint32_t next = mover % b->players + 1;
+            if(brute_value(b, depth + 1, next) != value) continue;
+            if(optimal_end(b, depth + 1, next, fields)) return true;
+        }
+    }
+    return false;
+}
+
+/** @brief Porownuje wynik solvera z przeszukiwaniem calego drzewa gry.
+ * @param[in,out] s - solver,
+ * @param[in] g - pozycja,
+ * @param[in] to_move - gracz, ktorego kolej,
+ * @param[in] player - gracz, dla ktorego liczony jest wynik.
+ */
+static void check_position(solver_t *s, gamma_t *g, uint32_t to_move,
+                           uint32_t player) {
+    brute_t b = {get_players(g), player, get_width(g), get_height(g),
+                 NULL, NULL, NULL, NULL};
+    uint32_t levels = b.width * b.height + b.players + 2;
+    size_t count = position_count(&b);
+    b.stack = malloc(levels * sizeof(gamma_t*));
+    b.values = malloc(count * sizeof(int8_t));
+    b.explored = calloc(count, sizeof(bool));
+    b.scratch = gamma_clone(g);
+    CHECK(b.stack != NULL && b.values != NULL && b.explored != NULL
+          && b.scratch != NULL);
+    for(uint32_t i = 0; i < levels; ++i) {
+        b.stack[i] = gamma_clone(g);
+        CHECK(b.stack[i] != NULL);
+    }
+    memset(b.values, UNKNOWN, count * sizeof(int8_t));
+
+    solver_result_t result;
+    uint64_t fields[4];
+    CHECK(solver_solve(s, g, to_move, player, 0, &result, fields));
+    CHECK(result.exact);
+    CHECK(result.value == brute_value(&b, 0, to_move));
+    uint32_t mover = next_mover(&b, g, to_move);
+    CHECK(result.has_move == (mover != 0) && result.to_move == mover);
+
+    if(result.has_move) {
+        gamma_t *child = b.stack[1];
+        CHECK(gamma_copy(child, g));
+        CHECK(try_move(child, mover, result.x * b.height + result.y, result.golden));
+        CHECK(brute_value(&b, 1, mover % b.players + 1) == result.value);
+    }
+
+    int64_t best_other = 0;
+    for(uint32_t p = 1; p <= b.players; ++p) {
+        if(p != player && (int64_t) fields[p] > best_other) {
+            best_other = (int64_t) fields[p];
+        }
+    }
+    CHECK((int64_t) fields[player] - best_other == result.value);
+    CHECK(optimal_end(&b, 0, to_move, fields));
+
+    for(uint32_t i = 0; i < levels; ++i) gamma_delete(b.stack[i]);
+    gamma_delete(b.scratch);
+    free(b.stack);
+    free(b.values);
+    free(b.explored);
+}
+
+/** Solver zgadza sie z przeszukiwaniem calego drzewa gry. */
+static void test_small_boards(void) {
+    solver_t *s;
+    CHECK(solver_init(&s, 10));
+    unsigned seed = 1;
+    uint32_t with_golden = 0, without_golden = 0, three_players = 0;
+    for(int position = 0; position < 300; ++position) {
+        game_params_t params;
+        random_params(&params, 3, 3, 3, &seed);
+        if(params.width * params.height < 4) continue;
+        params.players += params.players == 1;
+        gamma_t *g = new_game(&params);
+        uint32_t cells = params.width * params.height;
+        /* Na planszy 3x3 z trzema graczami przeszukiwanie od poczatku gry
+         * trwaloby zbyt dlugo. */
+        uint32_t moves = rand_r(&seed) % cells
+                         + (cells == 9 && params.players == 3 ? 12 : 0);
+        play_random(g, (int) moves, 3, &seed);
+
+        bool golden = false;
+        for(uint32_t p = 1; p <= params.players; ++p) {
+            golden = golden || gamma_golden_possible(g, p);
+        }
+        with_golden += golden;
+        without_golden += !golden;
+        three_players += params.players == 3;
+
+        check_position(s, g, 1 + rand_r(&seed) % params.players,
+                       1 + rand_r(&seed) % params.players);
+        gamma_delete(g);
+    }
+    CHECK(with_golden > 0 && without_golden > 0 && three_players > 0);
+    delete_solver(s);
+}
+
+/** Niepoprawne parametry sa odrzucane. */
+static void test_invalid(void) {
+    solver_t *s;
+    CHECK(!solver_init(&s, 0));
+    CHECK(solver_init(&s, 4));
+    gamma_t *g = gamma_new(2, 2, 2, 1);
+    CHECK(g != NULL);
+    solver_result_t result;
+    CHECK(!solver_solve(s, g, 0, 1, 0, &result, NULL));
+    CHECK(!solver_solve(s, g, 1, 3, 0, &result, NULL));
+    CHECK(!solver_solve(s, NULL, 1, 1, 0, &result, NULL));
+    CHECK(solver_solve(s, g, 1, 1, 0, &result, NULL));
+    CHECK(result.exact && result.has_move && result.to_move == 1);
+    gamma_delete(g);
+    delete_solver(s);
+}
+
+int main() {
+    test_small_boards();
+    test_invalid();
+    return 0;
+}
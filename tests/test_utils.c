@@ -0,0 +1,85 @@
+/** @file
+ * Implementacja interfejsu test_utils.h
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#define _GNU_SOURCE
+#include <string.h>
+#include "test_utils.h"
+
+void random_params(game_params_t *params, uint32_t max_side, uint32_t max_players,
+                   uint32_t max_areas, unsigned *seed) {
+    params->width = 1 + rand_r(seed) % max_side;
+    params->height = 1 + rand_r(seed) % max_side;
+    params->players = 1 + rand_r(seed) % max_players;
+    params->areas = 1 + rand_r(seed) % max_areas;
+}
+
+gamma_t* new_game(const game_params_t *params) {
+    gamma_t *g = gamma_new(params->width, params->height, params->players,
+                           params->areas);
+    CHECK(g != NULL);
+    return g;
+}
+
+void play_random(gamma_t *g, int moves, unsigned golden_one_in, unsigned *seed) {
+    for(int i = 0; i < moves; ++i) {
+        uint32_t player = 1 + rand_r(seed) % get_players(g);
+        uint32_t x = rand_r(seed) % get_width(g), y = rand_r(seed) % get_height(g);
+        if(golden_one_in != 0 && rand_r(seed) % golden_one_in == 0) {
+            gamma_golden_move(g, player, x, y);
+        }
+        else {
+            gamma_move(g, player, x, y);
+        }
+    }
+}
+
+uint32_t play_recorded(gamma_t *g, played_move_t *moves, int tries,
+                       unsigned golden_one_in, unsigned *seed) {
+    uint32_t count = 0;
+    for(int i = 0; i < tries; ++i) {
+        played_move_t m = {1 + rand_r(seed) % get_players(g),
+                           rand_r(seed) % get_width(g),
+                           rand_r(seed) % get_height(g), false};
+        m.golden = golden_one_in != 0 && rand_r(seed) % golden_one_in == 0;
+        bool done = m.golden ? gamma_golden_move(g, m.player, m.x, m.y)
+                             : gamma_move(g, m.player, m.x, m.y);
+        if(done) moves[count++] = m;
+    }
+    return count;
+}
+
+gamma_t* replay_transformed(gamma_t *g, uint32_t transform,
+                            const played_move_t *moves, uint32_t count) {
+    game_params_t params = {get_width(g), get_height(g), get_players(g),
+                            get_areas(g)};
+    gamma_t *image = new_game(&params);
+    for(uint32_t i = 0; i < count; ++i) {
+        uint32_t x, y;
+        CHECK(gamma_transform_field(g, transform, moves[i].x, moves[i].y, &x, &y));
+        CHECK(moves[i].golden ? gamma_golden_move(image, moves[i].player, x, y)
+                              : gamma_move(image, moves[i].player, x, y));
+    }
+    return image;
+}
+
+bool same_board(gamma_t *a, gamma_t *b) {
+    char *sa = gamma_board(a), *sb = gamma_board(b);
+    bool same = sa != NULL && sb != NULL && strcmp(sa, sb) == 0;
+    free(sa);
+    free(sb);
+    return same;
+}
+
+bool same_game(gamma_t *a, gamma_t *b) {
+    bool same = same_board(a, b) && get_players(a) == get_players(b);
+    for(uint32_t p = 1; same && p <= get_players(a); ++p) {
+        same = gamma_busy_fields(a, p) == gamma_busy_fields(b, p)
+               && gamma_free_fields(a, p) == gamma_free_fields(b, p);
+    }
+    return same;
+}
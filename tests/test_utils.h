@@ -0,0 +1,113 @@
+/** @file
+ * Wspolne narzedzia testow silnika gry gamma
+ *
+ * @author Dominik Wisniewski <dw418484@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.05.2020
+ */
+
+#ifndef TEST_UTILS_H
+#define TEST_UTILS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "gamma.h"
+
+/** Sprawdza warunek i przerywa test, jesli nie jest spelniony. */
+#define CHECK(cond)                                                   \
+    do {                                                              \
+        if(!(cond)) {                                                 \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            exit(1);                                                  \
+        }                                                             \
+    } while(0)
+
+/**
+ * Parametry losowanej gry.
+ */
+typedef struct game_params {
+    uint32_t width; ///< szerokosc planszy
+    uint32_t height; ///< wysokosc planszy
+    uint32_t players; ///< liczba graczy
+    uint32_t areas; ///< maksymalna liczba obszarow gracza
+} game_params_t;
+
+/** @brief Losuje parametry gry.
+ * @param[out] params - wylosowane parametry,
+ * @param[in] max_side - najwieksza szerokosc i wysokosc planszy,
+ * @param[in] max_players - najwieksza liczba graczy,
+ * @param[in] max_areas - najwieksza maksymalna liczba obszarow,
+ * @param[in,out] seed - ziarno generatora.
+ */
+void random_params(game_params_t *params, uint32_t max_side, uint32_t max_players,
+                   uint32_t max_areas, unsigned *seed);
+
+/** @brief Tworzy gre o podanych parametrach.
+ * Przerywa test, jesli nie udalo sie jej utworzyc.
+ * @param[in] params - parametry gry.
+ * @return Wskaznik na gre.
+ */
+gamma_t* new_game(const game_params_t *params);
+
+/** @brief Wykonuje pseudolosowe ruchy.
+ * @param[in,out] g - gra,
+ * @param[in] moves - liczba prob ruchu,
+ * @param[in] golden_one_in - co ktora proba jest srednio zlotym ruchem,
+ * 0 jesli zadna,
+ * @param[in,out] seed - ziarno generatora.
+ */
+void play_random(gamma_t *g, int moves, unsigned golden_one_in, unsigned *seed);
+
+/**
+ * Wykonany ruch.
+ */
+typedef struct played_move {
+    uint32_t player; ///< numer gracza
+    uint32_t x; ///< numer kolumny
+    uint32_t y; ///< numer wiersza
+    bool golden; ///< czy ruch jest zloty
+} played_move_t;
+
+/** @brief Wykonuje pseudolosowe ruchy i zapisuje te, ktore sie udaly.
+ * @param[in,out] g - gra,
+ * @param[out] moves - tablica o co najmniej @p tries elementach, w ktorej
+ * zapisywane sa wykonane ruchy,
+ * @param[in] tries - liczba prob ruchu,
+ * @param[in] golden_one_in - co ktora proba jest srednio zlotym ruchem,
+ * 0 jesli zadna,
+ * @param[in,out] seed - ziarno generatora.
+ * @return Liczba wykonanych ruchow.
+ */
+uint32_t play_recorded(gamma_t *g, played_move_t *moves, int tries,
+                       unsigned golden_one_in, unsigned *seed);
+
+/** @brief Odtwarza ruchy na obrazie planszy przez przeksztalcenie.
+ * Przerywa test, jesli ktorys ruch sie nie uda.
+ * @param[in] g - gra, na ktorej wykonano ruchy,
+ * @param[in] transform - numer przeksztalcenia z @ref gamma_transform_field,
+ * @param[in] moves - wykonane ruchy,
+ * @param[in] count - liczba ruchow.
+ * @return Wskaznik na nowa gre o parametrach @p g z przeksztalconymi ruchami.
+ */
+gamma_t* replay_transformed(gamma_t *g, uint32_t transform,
+                            const played_move_t *moves, uint32_t count);
+
+/** @brief Sprawdza, czy dwie gry maja te sama plansze.
+ * @param[in] a - pierwsza gra,
+ * @param[in] b - druga gra.
+ * @return @p true, jesli plansze sa takie same.
+ */
+bool same_board(gamma_t *a, gamma_t *b);
+
+/** @brief Sprawdza, czy dwie gry maja ten sam stan.
+ * Nie porownuje wykorzystania zlotych ruchow.
+ * @param[in] a - pierwsza gra,
+ * @param[in] b - druga gra.
+ * @return @p true, jesli plansze oraz liczby zajetych i wolnych pol graczy
+ * sa takie same.
+ */
+bool same_game(gamma_t *a, gamma_t *b);
+
+#endif //TEST_UTILS_H